@@ -0,0 +1,59 @@
+#pragma once
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/*
+Minimal harness for the microbenchmarks. Each case is run against the code it replaces,
+and the time per element of both is printed with the speedup.
+*/
+
+class Benchmark {
+public:
+	/// <summary>
+	/// Runs fn repetitions times, after one run to warm the caches, and returns the nanoseconds per element.
+	/// fn returns a value that depends on the results, so the compiler can't remove the work
+	/// </summary>
+	template<typename F>
+	static double measure(size_t repetitions, size_t elements, F fn)
+	{
+		_sink += fn();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < repetitions; ++i)
+			_sink += fn();
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / (double)(repetitions * elements);
+	}
+
+	/// <summary>
+	/// Measures both versions and prints a row of the table
+	/// </summary>
+	template<typename Baseline, typename Candidate>
+	static void compare(const std::string& name, size_t repetitions, size_t elements, Baseline baseline, Candidate candidate)
+	{
+		double before = measure(repetitions, elements, baseline);
+		double after = measure(repetitions, elements, candidate);
+		printRow(name, before, after);
+	}
+
+	/// <summary>
+	/// Prints a row of the table with two times measured by the caller
+	/// </summary>
+	static void printRow(const std::string& name, double before, double after)
+	{
+		std::printf("%-40s %12.3f %12.3f %9.2fx\n", name.c_str(), before, after, before / after);
+	}
+
+	static void printHeader(const std::string& suite, const std::string& unit = "ns")
+	{
+		std::printf("\n%-40s %12s %12s %10s\n", suite.c_str(), ("before " + unit).c_str(), ("after " + unit).c_str(), "speedup");
+	}
+
+private:
+	static volatile double _sink;
+};
+
+#endif // !BENCHMARK_H
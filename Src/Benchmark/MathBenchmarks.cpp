@@ -0,0 +1,171 @@
+#include "MathBenchmarks.h"
+#include "Benchmark.h"
+#include "MotorUnitario/Vector3.h"
+#include "MotorMath/MotorMath.h"
+#include "MotorMath/PhysxMath.h"
+
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+namespace {
+	const size_t ELEMENTS = 4096;
+	const size_t REPETITIONS = 2000;
+
+	float value(size_t i, float scale) { return (float)(i % 97) * scale - 1.5f; }
+
+	//The double quaternion that Transform used before MotorMath, kept as the baseline
+	struct Quaternion {
+		double w, x, y, z;
+
+		inline Quaternion operator*(const Quaternion& o) const {
+			return { w * o.w - x * o.x - y * o.y - z * o.z,
+				w * o.x + x * o.w + y * o.z - z * o.y,
+				w * o.y - x * o.z + y * o.w + z * o.x,
+				w * o.z + x * o.y - y * o.x + z * o.w };
+		}
+
+		inline Quaternion conjugate() const { return { w, -x, -y, -z }; }
+
+		inline Vector3 rotate(const Vector3& v) const {
+			Quaternion r = (*this) * Quaternion{ 0, v.getX(), v.getY(), v.getZ() } * conjugate();
+			return Vector3(r.x, r.y, r.z);
+		}
+	};
+
+	Quaternion ToQuaternion(double pitch, double yaw, double roll)
+	{
+		double cy = cos(pitch * 0.5);
+		double sy = sin(pitch * 0.5);
+		double cp = cos(yaw * 0.5);
+		double sp = sin(yaw * 0.5);
+		double cr = cos(roll * 0.5);
+		double sr = sin(roll * 0.5);
+
+		Quaternion q;
+		q.w = cr * cp * cy + sr * sp * sy;
+		q.z = sr * cp * cy - cr * sp * sy;
+		q.y = cr * sp * cy + sr * cp * sy;
+		q.x = cr * cp * sy - sr * sp * cy;
+		return q;
+	}
+
+	Vector3 ToEulerAngles(const physx::PxQuat& q)
+	{
+		double sinr_cosp = 2 * (q.w * q.x + q.y * q.z);
+		double cosr_cosp = 1 - 2 * (q.x * q.x + q.y * q.y);
+		double sinp = 2 * (q.w * q.y - q.z * q.x);
+		double siny_cosp = 2 * (q.w * q.z + q.x * q.y);
+		double cosy_cosp = 1 - 2 * (q.y * q.y + q.z * q.z);
+		return Vector3(std::atan2(sinr_cosp, cosr_cosp),
+			std::abs(sinp) >= 1 ? std::copysign(MOTORMATH_PI / 2, sinp) : std::asin(sinp),
+			std::atan2(siny_cosp, cosy_cosp));
+	}
+}
+
+void runMathBenchmarks()
+{
+	std::vector<Vector3> positions(ELEMENTS), velocities(ELEMENTS), eulers(ELEMENTS);
+	std::vector<Vec3> positions3(ELEMENTS), velocities3(ELEMENTS), eulers3(ELEMENTS), out3(ELEMENTS);
+	std::vector<Quaternion> quaternions(ELEMENTS);
+	std::vector<Quat> quats(ELEMENTS);
+	for (size_t i = 0; i < ELEMENTS; ++i) {
+		positions[i] = Vector3(value(i, 0.5f), value(i + 1, 0.25f), value(i + 2, 0.75f));
+		velocities[i] = Vector3(value(i + 3, 0.1f), value(i + 4, 0.2f), value(i + 5, 0.3f));
+		eulers[i] = Vector3(value(i, 0.03f), value(i + 7, 0.02f), value(i + 11, 0.01f));
+		positions3[i] = positions[i].toVec3();
+		velocities3[i] = velocities[i].toVec3();
+		eulers3[i] = eulers[i].toVec3();
+	}
+	const float dt = 1.0f / 60.0f;
+
+	Benchmark::printHeader("MotorMath");
+
+	Benchmark::compare("Euler to quaternion", REPETITIONS, ELEMENTS,
+		[&]() {
+			for (size_t i = 0; i < ELEMENTS; ++i)
+				quaternions[i] = ToQuaternion(eulers[i].getX(), eulers[i].getY(), eulers[i].getZ());
+			return quaternions[ELEMENTS / 2].w;
+		},
+		[&]() {
+			Batch::fromEuler(eulers3.data(), quats.data(), ELEMENTS);
+			return (double)quats[ELEMENTS / 2].w;
+		});
+
+	Benchmark::compare("Integrate positions", REPETITIONS, ELEMENTS,
+		[&]() {
+			for (size_t i = 0; i < ELEMENTS; ++i)
+				positions[i] = positions[i] + velocities[i] * dt;
+			return positions[ELEMENTS / 2].getX();
+		},
+		[&]() {
+			Batch::multiplyAdd(positions3.data(), velocities3.data(), dt, positions3.data(), ELEMENTS);
+			return (double)positions3[ELEMENTS / 2].x;
+		});
+
+	//What every call to the physics did before: Vector3 -> tuple -> PxVec3
+	Benchmark::compare("Vector to PhysX", REPETITIONS, ELEMENTS,
+		[&]() {
+			double sum = 0;
+			for (size_t i = 0; i < ELEMENTS; ++i) {
+				std::tuple<float, float, float> t = positions[i].toTuple();
+				physx::PxVec3 v(std::get<0>(t), std::get<1>(t), std::get<2>(t));
+				sum += v.x + v.y + v.z;
+			}
+			return sum;
+		},
+		[&]() {
+			double sum = 0;
+			for (size_t i = 0; i < ELEMENTS; ++i) {
+				const physx::PxVec3& v = toPx(positions3[i]);
+				sum += v.x + v.y + v.z;
+			}
+			return sum;
+		});
+
+	Quaternion rotation = ToQuaternion(0.3, 0.2, 0.1);
+	Vector3 translation(1, 2, 3);
+	Mat4 world = Mat4::fromTRS(translation.toVec3(), Quat::fromEuler(0.3f, 0.2f, 0.1f), Vec3(1, 1, 1));
+	Benchmark::compare("Transform points", REPETITIONS, ELEMENTS,
+		[&]() {
+			for (size_t i = 0; i < ELEMENTS; ++i)
+				velocities[i] = rotation.rotate(positions[i]) + translation;
+			return velocities[ELEMENTS / 2].getX();
+		},
+		[&]() {
+			Batch::transformPoints(world, positions3.data(), out3.data(), ELEMENTS);
+			return (double)out3[ELEMENTS / 2].x;
+		});
+
+	Benchmark::compare("Quaternion product", REPETITIONS, ELEMENTS,
+		[&]() {
+			for (size_t i = 0; i < ELEMENTS; ++i)
+				quaternions[i] = rotation * quaternions[i];
+			return quaternions[ELEMENTS / 2].w;
+		},
+		[&]() {
+			Quat q = Quat::fromEuler(0.3f, 0.2f, 0.1f);
+			for (size_t i = 0; i < ELEMENTS; ++i)
+				quats[i] = q * quats[i];
+			return (double)quats[ELEMENTS / 2].w;
+		});
+
+	//What every dynamic body did each frame before the orientation was a quaternion:
+	//PhysX quaternion -> Euler angles in the Transform -> quaternion for Ogre
+	std::vector<physx::PxQuat> poses(ELEMENTS);
+	for (size_t i = 0; i < ELEMENTS; ++i)
+		poses[i] = toPx(Quat::fromEuler(eulers3[i]));
+	Benchmark::compare("Physics to render orientation", REPETITIONS, ELEMENTS,
+		[&]() {
+			for (size_t i = 0; i < ELEMENTS; ++i) {
+				Vector3 euler = ToEulerAngles(poses[i]);
+				quaternions[i] = ToQuaternion(euler.getX(), euler.getY(), euler.getZ());
+			}
+			return quaternions[ELEMENTS / 2].w;
+		},
+		[&]() {
+			for (size_t i = 0; i < ELEMENTS; ++i)
+				quats[i] = fromPx(poses[i]);
+			return (double)quats[ELEMENTS / 2].w;
+		});
+}
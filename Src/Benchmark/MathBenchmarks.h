@@ -0,0 +1,10 @@
+#pragma once
+#ifndef MATHBENCHMARKS_H
+#define MATHBENCHMARKS_H
+
+/// <summary>
+/// Compares MotorMath with the double Vector3 and the tuple conversions it replaces
+/// </summary>
+void runMathBenchmarks();
+
+#endif // !MATHBENCHMARKS_H
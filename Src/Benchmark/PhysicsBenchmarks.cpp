@@ -0,0 +1,308 @@
+#include "PhysicsBenchmarks.h"
+#include "Benchmark.h"
+#include "MotorFisico/PhysxEngine.h"
+#include "MotorFisico/PhysicsCache.h"
+#include "MotorFisico/PhysicsConfig.h"
+#include "MotorFisico/PhysicsSnapshot.h"
+#include "MotorFisico/PhysicsCollection.h"
+#include "MotorFisico/Collider.h"
+#include "MotorFisico/RigidBody.h"
+#include "MotorUnitario/JobSystem.h"
+#include "MotorMath/PhysxMath.h"
+#include <PxPhysicsAPI.h>
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdio>
+
+namespace {
+	const size_t STEPS = 300;
+	const float STEP_TIME = 1.0f / 60.0f;
+
+	using SceneBuilder = std::function<void(std::vector<physx::PxRigidActor*>& actors)>;
+
+	float value(size_t i, float scale) { return (float)(i % 97) * scale; }
+
+	physx::PxMaterial* material()
+	{
+		return PhysxEngine::getPxInstance()->getCache()->getMaterial(0.5f, 0.5f, 0.3f);
+	}
+
+	void addGround(std::vector<physx::PxRigidActor*>& actors, float halfSize)
+	{
+		physx::PxPhysics* physics = PhysxEngine::getPxInstance()->getPhysics();
+		physx::PxRigidStatic* ground = physics->createRigidStatic(physx::PxTransform(physx::PxVec3(0, -1, 0)));
+		physx::PxRigidActorExt::createExclusiveShape(*ground, physx::PxBoxGeometry(halfSize, 1, halfSize), *material());
+		actors.push_back(ground);
+	}
+
+	physx::PxRigidDynamic* addBody(std::vector<physx::PxRigidActor*>& actors, const physx::PxGeometry& geometry, const physx::PxVec3& position)
+	{
+		const PhysicsConfig& config = PhysxEngine::getPxInstance()->getConfig();
+		physx::PxRigidDynamic* body = physx::PxCreateDynamic(*PhysxEngine::getPxInstance()->getPhysics(), physx::PxTransform(position), geometry, *material(), 1.0f);
+		body->setSolverIterationCounts(config.positionIterations, config.velocityIterations);
+		if (config.ccd) body->setRigidBodyFlag(physx::PxRigidBodyFlag::eENABLE_CCD, true);
+		actors.push_back(body);
+		return body;
+	}
+
+	//Stacks of boxes that settle and fall asleep, the solver does most of the work
+	void pile(std::vector<physx::PxRigidActor*>& actors)
+	{
+		addGround(actors, 100);
+		for (int x = 0; x < 10; ++x)
+			for (int z = 0; z < 10; ++z)
+				for (int y = 0; y < 10; ++y)
+					addBody(actors, physx::PxBoxGeometry(0.5f, 0.5f, 0.5f), physx::PxVec3(x * 3.0f - 15, 0.5f + y * 1.01f, z * 3.0f - 15));
+	}
+
+	//Many bodies over a big world, the broad phase does most of the work
+	void rain(std::vector<physx::PxRigidActor*>& actors)
+	{
+		addGround(actors, 400);
+		for (size_t i = 0; i < 4000; ++i)
+			addBody(actors, physx::PxSphereGeometry(0.5f), physx::PxVec3(value(i, 8.0f) - 390, 5 + value(i / 97, 0.5f), value(i * 31, 8.0f) - 390));
+	}
+
+	//Fast small bodies against a thin wall, they go through it without ccd
+	void bullets(std::vector<physx::PxRigidActor*>& actors)
+	{
+		addGround(actors, 100);
+		physx::PxRigidStatic* wall = PhysxEngine::getPxInstance()->getPhysics()->createRigidStatic(physx::PxTransform(physx::PxVec3(0, 10, 50)));
+		physx::PxRigidActorExt::createExclusiveShape(*wall, physx::PxBoxGeometry(50, 10, 0.05f), *material());
+		actors.push_back(wall);
+		for (size_t i = 0; i < 500; ++i) {
+			physx::PxRigidDynamic* bullet = addBody(actors, physx::PxSphereGeometry(0.05f), physx::PxVec3(value(i, 1.0f) - 48, 1 + value(i / 97, 3.0f), 0));
+			bullet->setLinearVelocity(physx::PxVec3(0, 0, 200));
+		}
+	}
+
+	/// <summary>
+	/// Milliseconds of a frame of rollback: restoring a snapshot and simulating again 8 steps, against only simulating them
+	/// </summary>
+	void runRollback()
+	{
+		const size_t RESIMULATED = 8;
+		const size_t BODIES = 300;
+		static const std::string name = "Box";
+		PhysxEngine* engine = PhysxEngine::getPxInstance();
+		PhysicsConfig config;
+		config.enhancedDeterminism = true;
+		engine->setConfig(config);
+
+		//300 boxes falling on each other, the scene of a small rollback game. The snapshots only keep the actors of
+		//CollisionBodies, so the boxes are RigidBodies and the ground a raw static actor
+		std::vector<physx::PxRigidActor*> actors;
+		addGround(actors, 50);
+		engine->getScene()->addActors(reinterpret_cast<physx::PxActor* const*>(actors.data()), (physx::PxU32)actors.size());
+		std::vector<RigidBody*> bodies;
+		bodies.reserve(BODIES);
+		for (size_t i = 0; i < BODIES; ++i) {
+			Vec3 position(value(i, 0.3f) - 15, 1 + (float)(i / 20) * 1.2f, value(i * 7, 0.3f) - 15);
+			bodies.push_back(new RigidBody(1, 1, 1, nullptr, name, nullptr, false, position, false, 0, 0, 0.5f, 0.5f, 0.3f, 1.0f));
+		}
+		for (size_t i = 0; i < 30; ++i)
+			engine->update(STEP_TIME);
+
+		PhysicsSnapshot snapshot(BODIES);
+		engine->captureSnapshot(snapshot);
+		if (snapshot.size() != BODIES)
+			std::printf("The rollback snapshot has %zu of the %zu bodies\n", snapshot.size(), BODIES);
+
+		auto steps = [engine, RESIMULATED]() {
+			for (size_t i = 0; i < RESIMULATED; ++i) {
+				engine->update(STEP_TIME);
+				engine->dispatchContactEvents();
+			}
+		};
+		double before = Benchmark::measure(STEPS / RESIMULATED, 1, [&steps]() {
+			steps();
+			return 0.0;
+		}) / 1e6;
+		engine->restoreSnapshot(snapshot);
+		double after = Benchmark::measure(STEPS / RESIMULATED, 1, [engine, &snapshot, &steps]() {
+			engine->restoreSnapshot(snapshot);
+			steps();
+			return 0.0;
+		}) / 1e6;
+
+		Benchmark::printHeader("PhysX rollback, 300 bodies (vs steps only)", "ms");
+		Benchmark::printRow("Restore + 8 steps", before, after);
+
+		for (RigidBody* body : bodies)
+			delete body;
+		for (physx::PxRigidActor* actor : actors)
+			actor->release();
+	}
+
+	/// <summary>
+	/// Nanoseconds per collider of a level of 5000 static boxes: creating them one by one against loading them from a collection
+	/// </summary>
+	void runCollectionLoad()
+	{
+		const size_t COLLIDERS = 5000;
+		const std::string file = "benchmarkLevel.physx";
+		//The actors keep a pointer to their name
+		static const std::string name = "Crate";
+		PhysxEngine* engine = PhysxEngine::getPxInstance();
+		engine->setConfig(PhysicsConfig());
+
+		std::vector<BoxCollider*> colliders;
+		colliders.reserve(COLLIDERS);
+		auto destroy = [engine, &colliders]() {
+			for (BoxCollider* collider : colliders)
+				delete collider;
+			colliders.clear();
+			engine->clearShapeCache();
+		};
+
+		auto create = [engine, &colliders]() {
+			for (size_t i = 0; i < COLLIDERS; ++i)
+				colliders.push_back(new BoxCollider(1 + value(i, 0.1f), 1, 1 + value(i / 97, 0.1f), false, nullptr, name, nullptr, nullptr,
+					Vec3(value(i, 4.0f), 0, value(i / 97, 4.0f)), 0.5f, 0.5f, 0.5f, true));
+			engine->flushActors();
+		};
+
+		create();
+		std::vector<std::pair<std::string, CollisionBody*>> bodies;
+		for (BoxCollider* collider : colliders)
+			bodies.push_back(std::make_pair(name, collider));
+		engine->getCollection()->save(file, bodies);
+		destroy();
+
+		double before = Benchmark::measure(5, COLLIDERS, [&create, &destroy]() {
+			create();
+			destroy();
+			return 0.0;
+		});
+		double after = Benchmark::measure(5, COLLIDERS, [engine, &file, &colliders, &destroy]() {
+			PhysicsCollection* collection = engine->getCollection();
+			collection->load(file);
+			while (physx::PxRigidActor* actor = collection->take(name))
+				colliders.push_back(new BoxCollider(actor, nullptr, nullptr, nullptr));
+			collection->releaseUnbound();
+			destroy();
+			collection->releaseUnused();
+			return 0.0;
+		});
+
+		Benchmark::printHeader("PhysX level load, 5000 static boxes (vs creating them)");
+		Benchmark::printRow("Binary collection", before, after);
+		std::remove(file.c_str());
+	}
+
+	/// <summary>
+	/// Milliseconds per step of an open level of 20000 drifting bodies: simulating all of them against
+	/// suspending the ones out of an activation region around the center, about 500 stay awake
+	/// </summary>
+	void runActivation()
+	{
+		const size_t BODIES = 20000;
+		const size_t ROW = 141;
+		const float SPACING = 14.0f;
+		const float RADIUS = 180.0f;
+		static const std::string name = "Drifter";
+		PhysxEngine* engine = PhysxEngine::getPxInstance();
+		PhysicsConfig config;
+		config.gravity = Vec3(0, 0, 0);
+		engine->setConfig(config);
+
+		std::vector<RigidBody*> bodies;
+		bodies.reserve(BODIES);
+		for (size_t i = 0; i < BODIES; ++i) {
+			Vec3 position((float)(i % ROW) * SPACING - ROW * SPACING / 2, 0, (float)(i / ROW) * SPACING - ROW * SPACING / 2);
+			RigidBody* body = new RigidBody(0.5f, nullptr, name, nullptr, false, position);
+			body->setLinearVelocity(Vec3(value(i, 0.02f) - 1, 0, value(i / 97, 0.02f) - 1));
+			bodies.push_back(body);
+		}
+
+		auto steps = [engine]() {
+			engine->update(STEP_TIME);
+			engine->dispatchContactEvents();
+			return 0.0;
+		};
+		double before = Benchmark::measure(STEPS, 1, steps) / 1e6;
+		for (RigidBody* body : bodies)
+			if (body->getPosition().length() > RADIUS) body->suspend();
+		double after = Benchmark::measure(STEPS, 1, steps) / 1e6;
+
+		Benchmark::printHeader("PhysX activation regions, 20000 bodies (vs all simulated)", "ms");
+		Benchmark::printRow("About 500 awake", before, after);
+
+		for (RigidBody* body : bodies)
+			delete body;
+	}
+
+	/// <summary>
+	/// Builds the scene with the config, steps it and returns the milliseconds per step
+	/// </summary>
+	double run(const PhysicsConfig& config, const SceneBuilder& build)
+	{
+		PhysxEngine* engine = PhysxEngine::getPxInstance();
+		engine->setConfig(config);
+
+		std::vector<physx::PxRigidActor*> actors;
+		build(actors);
+		engine->getScene()->addActors(reinterpret_cast<physx::PxActor* const*>(actors.data()), (physx::PxU32)actors.size());
+
+		double ms = Benchmark::measure(STEPS, 1, [engine]() {
+			engine->update(STEP_TIME);
+			engine->dispatchContactEvents();
+			return 0.0;
+		}) / 1e6;
+
+		for (physx::PxRigidActor* actor : actors)
+			actor->release();
+		return ms;
+	}
+}
+
+void runPhysicsBenchmarks()
+{
+	JobSystem::CreateInstance();
+	JobSystem* jobs = JobSystem::getInstance();
+	PhysxEngine::CreateInstance();
+	PhysxEngine::getPxInstance()->init([jobs](std::function<void()> task) { jobs->schedule(std::move(task)); }, jobs->getWorkerCount());
+
+	PhysicsConfig defaults;
+	std::vector<std::pair<std::string, PhysicsConfig>> presets;
+	PhysicsConfig config = defaults;
+	config.broadPhase = PhysicsConfig::BroadPhase::MBP;
+	presets.push_back({ "MBP", config });
+	config = defaults;
+	config.broadPhase = PhysicsConfig::BroadPhase::ABP;
+	presets.push_back({ "ABP", config });
+	config = defaults;
+	config.pcm = false;
+	presets.push_back({ "No PCM", config });
+	config = defaults;
+	config.solver = PhysicsConfig::Solver::TGS;
+	config.positionIterations = 2;
+	presets.push_back({ "TGS, 2 iterations", config });
+	config = defaults;
+	config.stabilization = true;
+	presets.push_back({ "Stabilization", config });
+	config = defaults;
+	config.enhancedDeterminism = true;
+	presets.push_back({ "Enhanced determinism", config });
+	config = defaults;
+	config.ccd = true;
+	presets.push_back({ "CCD", config });
+	config = defaults;
+	config.threads = 1;
+	presets.push_back({ "1 thread", config });
+
+	std::vector<std::pair<std::string, SceneBuilder>> scenes = { { "Pile", pile }, { "Rain", rain }, { "Bullets", bullets } };
+	for (auto& scene : scenes) {
+		Benchmark::printHeader("PhysX " + scene.first + " (vs SAP, PGS)", "ms");
+		double before = run(defaults, scene.second);
+		for (auto& preset : presets)
+			Benchmark::printRow(preset.first, before, run(preset.second, scene.second));
+	}
+	runRollback();
+	runCollectionLoad();
+	runActivation();
+
+	delete PhysxEngine::getPxInstance();
+}
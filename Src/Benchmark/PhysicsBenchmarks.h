@@ -0,0 +1,11 @@
+#pragma once
+#ifndef PHYSICSBENCHMARKS_H
+#define PHYSICSBENCHMARKS_H
+
+/// <summary>
+/// Steps some canned scenes with each PhysicsConfig preset and compares them with the default config.
+/// It only needs the physics, so it runs headless
+/// </summary>
+void runPhysicsBenchmarks();
+
+#endif // !PHYSICSBENCHMARKS_H
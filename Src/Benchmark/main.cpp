@@ -0,0 +1,21 @@
+#include "Benchmark.h"
+#include "MathBenchmarks.h"
+#include "PhysicsBenchmarks.h"
+
+#include <string>
+
+volatile double Benchmark::_sink = 0;
+
+//Without arguments every suite runs, otherwise only the named ones: Benchmark math physics
+int main(int argc, char** argv) {
+	auto selected = [argc, argv](const std::string& suite) {
+		if (argc < 2) return true;
+		for (int i = 1; i < argc; ++i)
+			if (suite == argv[i]) return true;
+		return false;
+	};
+
+	if (selected("math")) runMathBenchmarks();
+	if (selected("physics")) runPhysicsBenchmarks();
+	return 0;
+}
@@ -1,5 +1,5 @@
-#include "..\..\Src\MotorAudio\Listener.h"
-#include "..\..\Src\MotorAudio\AudioEngine.h"
+#include "Listener.h"
+#include "AudioEngine.h"
 
 #include <fmod.hpp>
 #include <iostream>
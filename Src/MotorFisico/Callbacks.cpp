@@ -1,48 +1,174 @@
 #include "Callbacks.h"
 #include "CollisionBody.h"
+#include "ContactEvents.h"
 #include "PxActor.h"
 #include "Collider.h"
+#include "CollisionLayers.h"
+#include "MotorMath/PhysxMath.h"
 
 physx::PxFilterFlags contactReportFilterShader(physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0,
 	physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1,
 	physx::PxPairFlags& pairFlags, const void* constantBlock, physx::PxU32 constantBlockSize)
 {
-	PX_UNUSED(attributes0);
-	PX_UNUSED(attributes1);
-	PX_UNUSED(filterData0);
-	PX_UNUSED(filterData1);
-	PX_UNUSED(constantBlockSize);
-	PX_UNUSED(constantBlock);
-
-	// all initial and persisting reports for everything, with per-point data
-	pairFlags = physx::PxPairFlag::eSOLVE_CONTACT | physx::PxPairFlag::eDETECT_DISCRETE_CONTACT
-		| physx::PxPairFlag::eNOTIFY_TOUCH_FOUND
-		| physx::PxPairFlag::eNOTIFY_TOUCH_PERSISTS
-		| physx::PxPairFlag::eNOTIFY_CONTACT_POINTS;
+	//A shape without filter data collides and reports with everything, like the ones of the default layer
+	const physx::PxFilterData noLayer(1u << CollisionLayers::DEFAULT_LAYER, UINT32_MAX, UINT32_MAX, 0);
+	if (filterData0.word0 == 0) filterData0 = noLayer;
+	if (filterData1.word0 == 0) filterData1 = noLayer;
+
+	//The layers are in word0 and the masks of the layer matrix in the others (CollisionLayers.h)
+	if (!(filterData0.word0 & filterData1.word1) || !(filterData1.word0 & filterData0.word1))
+		return physx::PxFilterFlag::eKILL;
+	bool notify = (filterData0.word0 & filterData1.word2) && (filterData1.word0 & filterData0.word2);
+
+	//Triggers only report when the pair starts and stops touching
+	if (physx::PxFilterObjectIsTrigger(attributes0) || physx::PxFilterObjectIsTrigger(attributes1)) {
+		if (!notify) return physx::PxFilterFlag::eKILL;
+		pairFlags = physx::PxPairFlag::eTRIGGER_DEFAULT;
+		return physx::PxFilterFlag::eDEFAULT;
+	}
+
+	//The ccd contacts are only detected when the scene and one of the bodies have ccd enabled (PhysicsConfig)
+	pairFlags = physx::PxPairFlag::eSOLVE_CONTACT | physx::PxPairFlag::eDETECT_DISCRETE_CONTACT | physx::PxPairFlag::eDETECT_CCD_CONTACT;
+	if (notify) {
+		pairFlags |= physx::PxPairFlag::eNOTIFY_TOUCH_FOUND | physx::PxPairFlag::eNOTIFY_TOUCH_LOST;
+		//The constant block has the layers each layer reports every step with (CollisionLayers::getPersistentMasks)
+		const physx::PxU32* persist = static_cast<const physx::PxU32*>(constantBlock);
+		int layer0 = CollisionLayers::getLayerFromMask(filterData0.word0);
+		if (constantBlockSize == sizeof(physx::PxU32) * CollisionLayers::MAX_LAYERS && layer0 >= 0 && (persist[layer0] & filterData1.word0))
+			pairFlags |= physx::PxPairFlag::eNOTIFY_TOUCH_PERSISTS;
+		if ((filterData0.word0 & filterData1.word3) && (filterData1.word0 & filterData0.word3))
+			pairFlags |= physx::PxPairFlag::eNOTIFY_CONTACT_POINTS;
+	}
 	return physx::PxFilterFlag::eDEFAULT;
 }
 
+ContactReportCallback::ContactReportCallback(ContactEventBuffer* events) : _events(events), _triggers(), _pairPoints()
+{
+}
+
 void ContactReportCallback::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count)
 {
-	PX_UNUSED(count);
-	physx::PxActor* actor1 = pairs->triggerActor;
-	physx::PxActor* actor2 = pairs->otherActor;
+	for (physx::PxU32 i = 0; i < count; ++i) {
+		const physx::PxTriggerPair& pair = pairs[i];
+
+		//The actor of a removed shape may have been released, so it isn't read. The other body still gets its Exit
+		bool removedTrigger = pair.flags & physx::PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER;
+		bool removedOther = pair.flags & physx::PxTriggerPairFlag::eREMOVED_SHAPE_OTHER;
+		if (removedTrigger || removedOther) {
+			removeTrigger(pair.triggerShape, pair.otherShape, pair.triggerActor, pair.otherActor);
+			CollisionBody* b1 = removedTrigger ? nullptr : static_cast<CollisionBody*>(pair.triggerActor->userData);
+			CollisionBody* b2 = removedOther ? nullptr : static_cast<CollisionBody*>(pair.otherActor->userData);
+			addRemovedExit(b1, b2, b1 != nullptr ? static_cast<Collider*>(b1)->getTriggerCallback() : nullptr, true);
+			continue;
+		}
 
-	Collider* b1 = static_cast<Collider*>(actor1->userData);
-	CollisionBody* b2 = static_cast<CollisionBody*>(actor2->userData);
+		bool enter = pair.status == physx::PxPairFlag::eNOTIFY_TOUCH_FOUND;
+		//Only the pairs whose layers are reported every step get Stay events
+		if (enter && notifiesPersistent(pair.triggerShape, pair.otherShape))
+			_triggers.push_back({ pair.triggerShape, pair.otherShape, pair.triggerActor, pair.otherActor, true });
+		else
+			removeTrigger(pair.triggerShape, pair.otherShape, pair.triggerActor, pair.otherActor);
 
-	b1->getTriggerCallback()(b1->getGameObject(), b2->getGameObject());
+		Collider* b1 = static_cast<Collider*>(pair.triggerActor->userData);
+		CollisionBody* b2 = static_cast<CollisionBody*>(pair.otherActor->userData);
+		//Bodies destroyed during the simulation have no userData
+		if (b1 == nullptr || b2 == nullptr || b1->getTriggerCallback() == nullptr) continue;
+
+		_events->add(b1->getGameObject(), b2->getGameObject(), b1->getTriggerCallback(), enter ? ContactState::Enter : ContactState::Exit, true);
+	}
 }
 
 void ContactReportCallback::onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs, physx::PxU32 nbPairs)
 {
-	PX_UNUSED(pairs);
-	PX_UNUSED(nbPairs);
-	physx::PxActor* actor1 = pairHeader.actors[0];
-	physx::PxActor* actor2 = pairHeader.actors[1];
+	//The removed actors may have been released, so they aren't read. The other body still gets the Exit of the pairs that were touching
+	bool removed0 = pairHeader.flags & physx::PxContactPairHeaderFlag::eREMOVED_ACTOR_0;
+	bool removed1 = pairHeader.flags & physx::PxContactPairHeaderFlag::eREMOVED_ACTOR_1;
+	if (removed0 || removed1) {
+		CollisionBody* b1 = removed0 ? nullptr : static_cast<CollisionBody*>(pairHeader.actors[0]->userData);
+		CollisionBody* b2 = removed1 ? nullptr : static_cast<CollisionBody*>(pairHeader.actors[1]->userData);
+		for (physx::PxU32 i = 0; i < nbPairs; ++i) {
+			if (pairs[i].events & physx::PxPairFlag::eNOTIFY_TOUCH_LOST)
+				addRemovedExit(b1, b2, b1 != nullptr ? b1->getColliderCallback() : nullptr, false);
+		}
+		return;
+	}
+
+	CollisionBody* b1 = static_cast<CollisionBody*>(pairHeader.actors[0]->userData);
+	CollisionBody* b2 = static_cast<CollisionBody*>(pairHeader.actors[1]->userData);
+	//Bodies destroyed during the simulation have no userData
+	if (b1 == nullptr || b2 == nullptr || b1->getColliderCallback() == nullptr) return;
+
+	GameObject* go1 = b1->getGameObject();
+	GameObject* go2 = b2->getGameObject();
+	ContactCallback* callback = b1->getColliderCallback();
+
+	for (physx::PxU32 i = 0; i < nbPairs; ++i) {
+		const physx::PxContactPair& pair = pairs[i];
+
+		if (pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_FOUND || pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_PERSISTS) {
+			ContactState::ContactState state = pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_FOUND ? ContactState::Enter : ContactState::Stay;
+			//There are only points when the layers of the pair ask for them
+			physx::PxU32 pointCount = pair.contactCount;
+			if (pointCount > 0) {
+				_pairPoints.resize(pointCount);
+				pointCount = pair.extractContacts(_pairPoints.data(), pointCount);
+			}
+
+			ContactPoint* points = _events->addContact(go1, go2, callback, state, pointCount);
+			for (physx::PxU32 p = 0; p < pointCount; ++p)
+				points[p] = { fromPx(_pairPoints[p].position), fromPx(_pairPoints[p].normal), _pairPoints[p].separation };
+		}
+		if (pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_LOST)
+			_events->add(go1, go2, callback, ContactState::Exit, false);
+	}
+}
+
+void ContactReportCallback::addTriggerStays()
+{
+	for (TriggerPair& pair : _triggers) {
+		if (pair.entered) {
+			pair.entered = false;
+			continue;
+		}
+
+		Collider* b1 = static_cast<Collider*>(pair.triggerActor->userData);
+		CollisionBody* b2 = static_cast<CollisionBody*>(pair.otherActor->userData);
+		if (b1 == nullptr || b2 == nullptr || b1->getTriggerCallback() == nullptr) continue;
 
-	CollisionBody* b1 = static_cast<CollisionBody*>(actor1->userData);
-	CollisionBody* b2 = static_cast<CollisionBody*>(actor2->userData);
+		_events->add(b1->getGameObject(), b2->getGameObject(), b1->getTriggerCallback(), ContactState::Stay, true);
+	}
+}
+
+void ContactReportCallback::addRemovedExit(CollisionBody* b1, CollisionBody* b2, ContactCallback* callback, bool trigger)
+{
+	//Without the first body the callback of the second one is used, every callback sends the event to both GameObjects
+	if (callback == nullptr && b2 != nullptr)
+		callback = b2->getColliderCallback();
+	if ((b1 == nullptr && b2 == nullptr) || callback == nullptr) return;
 
-	b1->getColliderCallback()(b1->getGameObject(), b2->getGameObject());
+	//The removed body isn't read, so its handle is invalid
+	_events->add(b1 != nullptr ? b1->getGameObject() : nullptr, b2 != nullptr ? b2->getGameObject() : nullptr, callback, ContactState::Exit, trigger);
+}
+
+bool ContactReportCallback::notifiesPersistent(physx::PxShape* triggerShape, physx::PxShape* otherShape) const
+{
+	int layer0 = CollisionLayers::getLayerFromMask(triggerShape->getSimulationFilterData().word0);
+	int layer1 = CollisionLayers::getLayerFromMask(otherShape->getSimulationFilterData().word0);
+	//A shape without filter data is in the default layer
+	if (layer0 < 0) layer0 = CollisionLayers::DEFAULT_LAYER;
+	if (layer1 < 0) layer1 = CollisionLayers::DEFAULT_LAYER;
+	return CollisionLayers::getInstance()->notifiesPersistent(layer0, layer1);
+}
+
+void ContactReportCallback::removeTrigger(physx::PxShape* triggerShape, physx::PxShape* otherShape, physx::PxActor* triggerActor, physx::PxActor* otherActor)
+{
+	//Equal bodies share their shapes (PhysicsCache), so the actors tell the pairs apart. They may have been released, only the pointers are compared
+	for (size_t i = 0; i < _triggers.size(); ++i) {
+		const TriggerPair& pair = _triggers[i];
+		if (pair.triggerShape == triggerShape && pair.otherShape == otherShape && pair.triggerActor == triggerActor && pair.otherActor == otherActor) {
+			_triggers[i] = _triggers.back();
+			_triggers.pop_back();
+			return;
+		}
+	}
 }
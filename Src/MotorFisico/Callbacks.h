@@ -2,13 +2,32 @@
 #define __CALLBACKS_H__
 
 #include <PxPhysicsAPI.h>
+#include <vector>
+
+#include "CollisionBody.h"
+
+class ContactEventBuffer;
 
 physx::PxFilterFlags contactReportFilterShader(physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0,
 	physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1,
 	physx::PxPairFlags& pairFlags, const void* constantBlock, physx::PxU32 constantBlockSize);
 
+/// <summary>
+/// Records the contact and trigger pairs reported by PhysX in a ContactEventBuffer, they are dispatched after the step
+/// </summary>
 class ContactReportCallback : public physx::PxSimulationEventCallback
 {
+public:
+	/// <param name="events">Buffer where the events are recorded</param>
+	ContactReportCallback(ContactEventBuffer* events);
+
+	/// <summary>
+	/// PhysX doesn't report the triggers that keep touching, so a Stay event is recorded for every pair
+	/// that touched before and hasn't entered or exited in this step, if their layers are reported every step.
+	/// Called after fetchResults
+	/// </summary>
+	void addTriggerStays();
+
 	void onConstraintBreak(physx::PxConstraintInfo* constraints, physx::PxU32 count) { PX_UNUSED(constraints); PX_UNUSED(count); }
 	void onWake(physx::PxActor** actors, physx::PxU32 count) { PX_UNUSED(actors); PX_UNUSED(count); }
 	void onSleep(physx::PxActor** actors, physx::PxU32 count) { PX_UNUSED(actors); PX_UNUSED(count); }
@@ -16,6 +35,38 @@ class ContactReportCallback : public physx::PxSimulationEventCallback
 	void onAdvance(const physx::PxRigidBody*const* bodyBuffer, const physx::PxTransform* poseBuffer, const physx::PxU32 count) { 
 		PX_UNUSED(bodyBuffer); PX_UNUSED(poseBuffer); PX_UNUSED(count);}
 	void onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs, physx::PxU32 nbPairs);
+
+private:
+	struct TriggerPair {
+		physx::PxShape* triggerShape;
+		physx::PxShape* otherShape;
+		physx::PxActor* triggerActor;
+		physx::PxActor* otherActor;
+		//Entered in the current step, so it doesn't get a Stay
+		bool entered;
+	};
+
+	/// <summary>
+	/// Removes the pair of the shapes and actors from the touching triggers
+	/// </summary>
+	void removeTrigger(physx::PxShape* triggerShape, physx::PxShape* otherShape, physx::PxActor* triggerActor, physx::PxActor* otherActor);
+
+	/// <summary>
+	/// Records the Exit of a pair in which a body was removed, the removed one is null and only the other one receives it
+	/// </summary>
+	/// <param name="callback">Callback of the first body, if it's null the one of the second body is used</param>
+	void addRemovedExit(CollisionBody* b1, CollisionBody* b2, ContactCallback* callback, bool trigger);
+
+	/// <summary>
+	/// Returns true if the layers of the shapes are reported every step while they touch (CollisionLayers)
+	/// </summary>
+	bool notifiesPersistent(physx::PxShape* triggerShape, physx::PxShape* otherShape) const;
+
+	ContactEventBuffer* _events;
+	//Pairs of triggers touching, removed when PhysX reports them lost
+	std::vector<TriggerPair> _triggers;
+	//Memory for the points read from PhysX
+	std::vector<physx::PxContactPairPoint> _pairPoints;
 };
 
-#endif __CALLBACKS_H__
\ No newline at end of file
+#endif __CALLBACKS_H__
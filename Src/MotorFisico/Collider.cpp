@@ -1,158 +1,190 @@
 #include "Collider.h"
 #include "PhysxEngine.h"
+#include "CollisionLayers.h"
+#include "PhysicsCache.h"
 
 #include <PxShape.h>
 #include <PxPhysics.h>
 #include <PxPhysicsAPI.h>
 #include "foundation/PxTransform.h"
+#include "MotorMath/PhysxMath.h"
 #include <iostream>
 
-#define GetPhysx() PhysxEngine::getPxInstance()->getScene()->getPhysics()
-
 
 void Collider::enable()
 {
-	_body->setActorFlag(physx::PxActorFlag::Enum::eDISABLE_SIMULATION, false);
+	write([this]() { _body->setActorFlag(physx::PxActorFlag::Enum::eDISABLE_SIMULATION, false); });
 }
 
 
 void Collider::disable()
 {
-	_body->setActorFlag(physx::PxActorFlag::Enum::eDISABLE_SIMULATION, true);
+	write([this]() { _body->setActorFlag(physx::PxActorFlag::Enum::eDISABLE_SIMULATION, true); });
 }
 
-void Collider::setPosition(const std::tuple<float, float, float>& position)
+void Collider::setPosition(const Vec3& position)
 {
-	_body->setGlobalPose(physx::PxTransform(TUPLE_TO_PHYSXVEC3(position)));
+	write([this, position]() { _body->setGlobalPose(physx::PxTransform(toPx(position), _body->getGlobalPose().q)); });
 }
 
-void Collider::setRotation(const std::tuple<float, float, float>& rotation)
+void Collider::setRotation(const Vec3& rotation)
 {
-	physx::PxQuat q = toQuaternion(rotation);
-	physx::PxTransform tr(_body->getGlobalPose().p, q);
-	_body->setGlobalPose(tr);
+	setOrientation(Quat::fromEuler(rotation));
 }
 
-void Collider::setMaterial(float staticFriction, float dynamicFriction, float restitution)
+void Collider::setOrientation(const Quat& orientation)
 {
-	int buffsize = 1;
-	physx::PxMaterial** buffer = new physx::PxMaterial * [buffsize];
-
-	_mShape->getMaterials(buffer, buffsize);
-
-	buffer[0]->setStaticFriction(staticFriction);
-	buffer[0]->setDynamicFriction(dynamicFriction);
-	buffer[0]->setRestitution(restitution);
-
-	_mShape->setMaterials(buffer, 1);
-
-	delete[] buffer;
+	physx::PxQuat q = toPx(orientation);
+	write([this, q]() { _body->setGlobalPose(physx::PxTransform(_body->getGlobalPose().p, q)); });
 }
 
-physx::PxQuat Collider::toQuaternion(const std::tuple<float, float, float>& rotation)
+void Collider::setMaterial(float staticFriction, float dynamicFriction, float restitution)
 {
-	physx::PxVec3 rot = TUPLE_TO_PHYSXVEC3(rotation);
-
-	double cy = cos(rot.x * 0.5);
-	double sy = sin(rot.x * 0.5);
-	double cp = cos(rot.y * 0.5);
-	double sp = sin(rot.y * 0.5);
-	double cr = cos(rot.z * 0.5);
-	double sr = sin(rot.z * 0.5);
+	write([this, staticFriction, dynamicFriction, restitution]() {
+		//The materials are shared, so the collider changes to the one with the new values
+		PhysicsCache* cache = PhysxEngine::getPxInstance()->getCache();
+		ShapeDesc desc = cache->describe(_mShape);
+		desc.material = cache->getMaterial(staticFriction, dynamicFriction, restitution);
+		replaceShape(desc);
+	});
+}
 
-	physx::PxQuat q;
-	q.w = cr * cp * cy + sr * sp * sy;
-	q.z = sr * cp * cy - cr * sp * sy;
-	q.y = cr * sp * cy + sr * cp * sy;
-	q.x = cr * cp * sy - sr * sp * cy;
+void Collider::setLayer(int layer)
+{
+	write([this, layer]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_mShape);
+		desc.layer = layer;
+		replaceShape(desc);
+	});
+}
 
-	return q;
+Collider::Collider(bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* coliderCallback, ContactCallback* triggerCallback,
+	const Vec3& position, bool isStatic)
+	:_isTrigger(isTrigger), _isStatic(isStatic), _gameObject(gameObject), _contCallback(coliderCallback), _triggerCallback(triggerCallback), _mShape(nullptr)
+{
+	physx::PxPhysics* physics = PhysxEngine::getPxInstance()->getPhysics();
+	//A static actor is left out of the dynamic bookkeeping of physx (solver, islands, kinematic targets)
+	if (_isStatic)
+		_body = physics->createRigidStatic(physx::PxTransform(toPx(position)));
+	else {
+		physx::PxRigidDynamic* body = physics->createRigidDynamic(physx::PxTransform(toPx(position)));
+		body->setRigidBodyFlag(physx::PxRigidBodyFlag::eKINEMATIC, true);
+		body->setLinearDamping(0.99);
+		body->setAngularDamping(0.99);
+		physx::PxRigidBodyExt::updateMassAndInertia(*body, 1);
+		_body = body;
+	}
+	_body->setName(gameObjectName.c_str());
+	_body->userData = this;
 }
 
-physx::PxVec3 Collider::ToEulerAngles(physx::PxQuat q)
+Collider::Collider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback)
+	:_isTrigger(false), _isStatic(actor->is<physx::PxRigidStatic>() != nullptr), _gameObject(gameObject), _contCallback(colliderCallback),
+	_triggerCallback(triggerCallback), _mShape(nullptr), _body(actor)
 {
-	physx::PxVec3 angles;
+	_body->getShapes(&_mShape, 1);
+	_isTrigger = _mShape != nullptr && _mShape->getFlags().isSet(physx::PxShapeFlag::eTRIGGER_SHAPE);
+	_body->userData = this;
+}
 
-	// roll (x-axis rotation)
-	double sinr_cosp = 2 * (q.w * q.x + q.y * q.z);
-	double cosr_cosp = 1 - 2 * (q.x * q.x + q.y * q.y);
-	angles.x = std::atan2(sinr_cosp, cosr_cosp);
+void Collider::initParams(ShapeDesc::Type type, float x, float y, float z, bool isTrigger, float staticFriction, float dynamicFriction, float restitution,
+	physx::PxBase* mesh)
+{
+	PhysicsCache* cache = PhysxEngine::getPxInstance()->getCache();
+	ShapeDesc desc = { type, { x, y, z }, cache->getMaterial(staticFriction, dynamicFriction, restitution), isTrigger, CollisionLayers::DEFAULT_LAYER, mesh };
+	_mShape = cache->getShape(desc);
 
-	// pitch (y-axis rotation)
-	double sinp = 2 * (q.w * q.y - q.z * q.x);
-	if (std::abs(sinp) >= 1)
-		angles.y = std::copysign(physx::PxPi / 2, sinp); // use 90 degrees if out of range
+	_body->attachShape(*_mShape);
+	//The static actors are added in batches, see PhysxEngine::addActor
+	if (_isStatic)
+		PhysxEngine::getPxInstance()->addActor(_body);
 	else
-		angles.y = std::asin(sinp);
-
-	// yaw (z-axis rotation)
-	double siny_cosp = 2 * (q.w * q.z + q.x * q.y);
-	double cosy_cosp = 1 - 2 * (q.y * q.y + q.z * q.z);
-	angles.z = std::atan2(siny_cosp, cosy_cosp);
-
-	return angles;
+		write([this]() { PhysxEngine::getPxInstance()->getScene()->addActor(*_body); });
 }
 
-Collider::Collider(bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* coliderCallback, ContactCallback* triggerCallback,
-	float staticFriction, float dynamicFriction, float restitution, const std::tuple<float, float, float>& position)
-	:_isTrigger(isTrigger), _gameObject(gameObject), _contCallback(coliderCallback), _triggerCallback(triggerCallback), _mShape(nullptr)
+void Collider::setMeshScale(const Vec3& scale)
 {
-	_body = PhysxEngine::getPxInstance()->getPhysics()->createRigidDynamic(physx::PxTransform(TUPLE_TO_PHYSXVEC3(position)));
-	_body->setRigidBodyFlag(physx::PxRigidBodyFlag::eKINEMATIC, true);
-	_body->setLinearDamping(0.99);
-	_body->setAngularDamping(0.99);
-	_body->setName(gameObjectName.c_str());
-	_body->userData = this;
-	physx::PxRigidBodyExt::updateMassAndInertia(*_body, 1);
+	write([this, scale]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_mShape);
+		desc.size[0] = scale.x;
+		desc.size[1] = scale.y;
+		desc.size[2] = scale.z;
+		replaceShape(desc);
+	});
 }
 
-void Collider::initParams(bool isTrigger)
+Vec3 Collider::getMeshScale() const
 {
+	physx::PxGeometryHolder geometry = _mShape->getGeometry();
+	if (geometry.getType() == physx::PxGeometryType::eTRIANGLEMESH)
+		return fromPx(geometry.triangleMesh().scale.scale);
+	return fromPx(geometry.convexMesh().scale.scale);
+}
 
-	if (isTrigger) setTrigger();
-	else setCollider();
+void Collider::replaceShape(const ShapeDesc& desc)
+{
+	PhysxEngine::getPxInstance()->getCache()->replaceShape(_body, _mShape, desc);
+}
 
-	_body->attachShape(*_mShape);
-	PhysxEngine::getPxInstance()->getScene()->addActor(*_body);
+void Collider::write(const std::function<void()>& write)
+{
+	PhysxEngine::getPxInstance()->write(this, write);
 }
 
 Collider::~Collider()
 {
-	_mShape->release();
-	_body->release();
+	PhysxEngine::getPxInstance()->cancelWrites(this);
+
+	//The actor may be in use by the simulation, so it is released through a write that doesn't depend on this.
+	//The shape belongs to the PhysicsCache, releasing the actor only detaches it
+	physx::PxRigidActor* body = _body;
+	body->userData = nullptr;
+	PhysxEngine::getPxInstance()->cancelActor(body);
+	PhysxEngine::getPxInstance()->write(nullptr, [body]() { body->release(); });
 }
 
 void Collider::setCollider()
 {
-	_mShape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, true);
-	_mShape->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, true);
-	_mShape->setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, false);
-	_mShape->setFlag(physx::PxShapeFlag::eVISUALIZATION, false);
+	_isTrigger = false;
+	write([this]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_mShape);
+		desc.trigger = false;
+		replaceShape(desc);
+	});
 }
 
 void Collider::setTrigger()
 {
-	_mShape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
-	_mShape->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, true);
-	_mShape->setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, true);
-	_mShape->setFlag(physx::PxShapeFlag::eVISUALIZATION, false);
+	_isTrigger = true;
+	write([this]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_mShape);
+		desc.trigger = true;
+		replaceShape(desc);
+	});
 }
 
 //////////////////////////////////////////////////
 
 BoxCollider::BoxCollider(float width, float heigh, float depth, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback, ContactCallback* triggerCallback,
-	const std::tuple<float, float, float>& position, float staticFriction, float dynamicFriction, float restitution)
-	: Collider(isTrigger, gameObject, gameObjectName, colliderCallback, triggerCallback, staticFriction, dynamicFriction, restitution, position)
+	const Vec3& position, float staticFriction, float dynamicFriction, float restitution, bool isStatic)
+	: Collider(isTrigger, gameObject, gameObjectName, colliderCallback, triggerCallback, position, isStatic)
+{
+	initParams(ShapeDesc::Box, width / 2.0f, heigh / 2.0f, depth / 2.0f, isTrigger, staticFriction, dynamicFriction, restitution);
+}
+
+BoxCollider::BoxCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback)
+	: Collider(actor, gameObject, colliderCallback, triggerCallback)
 {
-	physx::PxBoxGeometry aux(width / 2.0f, heigh / 2.0f, depth / 2.0f);
-	physx::PxMaterial* mat = GetPhysx().createMaterial(staticFriction, dynamicFriction, restitution);
-	_mShape = GetPhysx().createShape(aux, *mat);
-	mat->release();
-	initParams(isTrigger);
 }
 
 void BoxCollider::setScale(float width, float heigh, float depth) {
-	_mShape->setGeometry(physx::PxBoxGeometry(width / 2, heigh / 2, depth / 2));
+	write([this, width, heigh, depth]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_mShape);
+		desc.size[0] = width / 2;
+		desc.size[1] = heigh / 2;
+		desc.size[2] = depth / 2;
+		replaceShape(desc);
+	});
 }
 
 float BoxCollider::getWidth()
@@ -175,17 +207,23 @@ float BoxCollider::getDepth()
 ///////////////////////////////////////////////
 
 SphereCollider::SphereCollider(float radius, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* callback, ContactCallback* triggerCallback,
-	const std::tuple<float, float, float>& position, float staticFriction, float dynamicFriction, float restitution)
-	:Collider(isTrigger, gameObject, gameObjectName, callback, triggerCallback, staticFriction, dynamicFriction, restitution, position)
+	const Vec3& position, float staticFriction, float dynamicFriction, float restitution, bool isStatic)
+	:Collider(isTrigger, gameObject, gameObjectName, callback, triggerCallback, position, isStatic)
+{
+	initParams(ShapeDesc::Sphere, radius, 0, 0, isTrigger, staticFriction, dynamicFriction, restitution);
+}
+
+SphereCollider::SphereCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback)
+	: Collider(actor, gameObject, colliderCallback, triggerCallback)
 {
-	physx::PxSphereGeometry aux(radius);
-	physx::PxMaterial* mat = GetPhysx().createMaterial(staticFriction, dynamicFriction, restitution);
-	_mShape = GetPhysx().createShape(aux, *mat);
-	initParams(isTrigger);
 }
 
 void SphereCollider::setScale(float r) {
-	_mShape->setGeometry(physx::PxSphereGeometry(r));
+	write([this, r]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_mShape);
+		desc.size[0] = r;
+		replaceShape(desc);
+	});
 }
 
 float SphereCollider::getRadius()
@@ -196,17 +234,24 @@ float SphereCollider::getRadius()
 /////////////////////////////////////////////////
 
 CapsuleCollider::CapsuleCollider(float radius, float length, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback, ContactCallback* triggerCallback,
-	const std::tuple<float, float, float>& position, float staticFriction, float dynamicFriction, float restitution)
-	:Collider(isTrigger, gameObject, gameObjectName, colliderCallback, triggerCallback, staticFriction, dynamicFriction, restitution, position)
+	const Vec3& position, float staticFriction, float dynamicFriction, float restitution, bool isStatic)
+	:Collider(isTrigger, gameObject, gameObjectName, colliderCallback, triggerCallback, position, isStatic)
+{
+	initParams(ShapeDesc::Capsule, radius, length / 2, 0, isTrigger, staticFriction, dynamicFriction, restitution);
+}
+
+CapsuleCollider::CapsuleCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback)
+	: Collider(actor, gameObject, colliderCallback, triggerCallback)
 {
-	physx::PxCapsuleGeometry aux(radius, length / 2);
-	physx::PxMaterial* mat = GetPhysx().createMaterial(staticFriction, dynamicFriction, restitution);
-	_mShape = GetPhysx().createShape(aux, *mat);
-	initParams(isTrigger);
 }
 
 void CapsuleCollider::setScale(float radius, float length) {
-	_mShape->setGeometry(physx::PxCapsuleGeometry(radius, length / 2));
+	write([this, radius, length]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_mShape);
+		desc.size[0] = radius;
+		desc.size[1] = length / 2;
+		replaceShape(desc);
+	});
 }
 
 float CapsuleCollider::getRadius()
@@ -218,3 +263,31 @@ float CapsuleCollider::getHeight()
 {
 	return _mShape->getGeometry().capsule().halfHeight * 2;
 }
+
+//////////////////////////////////////////////////
+
+MeshCollider::MeshCollider(physx::PxTriangleMesh* mesh, const Vec3& scale, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback,
+	const Vec3& position, float staticFriction, float dynamicFriction, float restitution, bool isStatic)
+	: Collider(false, gameObject, gameObjectName, colliderCallback, nullptr, position, isStatic)
+{
+	initParams(ShapeDesc::TriangleMesh, scale.x, scale.y, scale.z, false, staticFriction, dynamicFriction, restitution, mesh);
+}
+
+MeshCollider::MeshCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback)
+	: Collider(actor, gameObject, colliderCallback, nullptr)
+{
+}
+
+//////////////////////////////////////////////////
+
+ConvexCollider::ConvexCollider(physx::PxConvexMesh* mesh, const Vec3& scale, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName,
+	ContactCallback* colliderCallback, ContactCallback* triggerCallback, const Vec3& position, float staticFriction, float dynamicFriction, float restitution, bool isStatic)
+	: Collider(isTrigger, gameObject, gameObjectName, colliderCallback, triggerCallback, position, isStatic)
+{
+	initParams(ShapeDesc::ConvexMesh, scale.x, scale.y, scale.z, isTrigger, staticFriction, dynamicFriction, restitution, mesh);
+}
+
+ConvexCollider::ConvexCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback)
+	: Collider(actor, gameObject, colliderCallback, triggerCallback)
+{
+}
@@ -3,9 +3,12 @@
 #ifndef COLLIDER_H
 #define COLLIDER_H
 
-#include <tuple>
+#include "MotorMath/Vec3.h"
+#include "MotorMath/Quat.h"
 #include <string>
+#include <functional>
 #include "CollisionBody.h"
+#include "PhysicsCache.h"
 
 namespace physx {
 	class PxPhysics;
@@ -15,13 +18,14 @@ namespace physx {
 	class PxVec3;
 	class PxQuat;
 	class PxTransform;
+	class PxBase;
+	class PxTriangleMesh;
+	class PxConvexMesh;
 }
 
 class Transform;
 class GameObject;
 
-#define TUPLE_TO_PHYSXVEC3(tuple) physx::PxVec3(std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple))
-#define PHYSXVEC3_TO_TUPLE(vec) std::tuple<float,float,float>(vec.x,vec.y,vec.z)
 
 class Collider : public CollisionBody
 {
@@ -52,6 +56,8 @@ public:
 	/// <returns>A pointer to the GameObject owner of the component owning thre collider</returns>
 	inline GameObject* getGameObject() const override { return _gameObject; }
 
+	inline physx::PxRigidActor* getActor() const override { return _body; }
+
 	/// <summary>
 	/// Set the pointer to the GameObject used on callbacks
 	/// </summary>
@@ -70,17 +76,28 @@ public:
 	/// <returns>A pointer to the function called on trigger</returns>
 	inline ContactCallback* getTriggerCallback() const { return _triggerCallback; }
 
+	/// <summary>
+	/// Returns whether the actor of the collider is static or kinematic
+	/// </summary>
+	inline bool isStatic() const { return _isStatic; }
+
 	/// <summary>
 	/// Sets the transform position to a specified one
 	/// </summary>
 	/// <param name="position">Set of values that determine the position</param>
-	void setPosition(const std::tuple<float, float, float>& position);
+	void setPosition(const Vec3& position);
 
 	/// <summary>
 	/// Sets the transform rotation to a specified one
 	/// </summary>
 	/// <param name="position">Set of values that determine the position</param>
-	void setRotation(const std::tuple<float, float, float>& rotation);
+	void setRotation(const Vec3& rotation);
+
+	/// <summary>
+	/// Sets the collider orientation, keeping its position
+	/// </summary>
+	/// <param name="orientation">The new orientation, normalized</param>
+	void setOrientation(const Quat& orientation);
 
 	/// <summary>
 	/// Sets collider's material to given parameters
@@ -90,32 +107,64 @@ public:
 	/// <param name="restitution">restitution coefficient</param>
 	void setMaterial(float staticFriction, float dynamicFriction, float restitution);
 
-protected:
-	physx::PxQuat toQuaternion(const std::tuple<float, float, float>& rotation);
-	physx::PxVec3 ToEulerAngles(physx::PxQuat q);
+	/// <summary>
+	/// Moves the collider to a collision layer, it's in the default one until then
+	/// </summary>
+	/// <param name="layer">Index of the layer in CollisionLayers</param>
+	void setLayer(int layer);
 
+protected:
 	/// <summary>
 	/// Contructor of the class
 	/// </summary>
 	/// <param name="isTrigger">True if shape is initially a trigger</param>
-	/// <param name="staticFriction">Static friction of the shape</param>
-	/// <param name="dynamicFriction">Dynamic friction of the shape</param>
-	/// <param name="restitution">Shape's restitution coefficient</param>
+	/// <param name="isStatic">True for a static actor, for the colliders that don't move. Otherwise it's a kinematic one</param>
 	Collider(bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback, ContactCallback* triggerCallback,
-		float staticFriction, float dynamicFriction, float restitution, const std::tuple<float, float, float>& position);
+		const Vec3& position, bool isStatic);
+
+	/// <summary>
+	/// Takes an actor loaded from a PhysicsCollection, with its shape, already in the scene
+	/// </summary>
+	Collider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback);
 
 	/// <summary>
-	/// Init collider params
+	/// Attaches the shared shape with that geometry and material, in the default layer, and adds the actor to the scene
 	/// </summary>
-	void initParams(bool isTrigger);
+	/// <param name="type">Type of the geometry</param>
+	/// <param name="x, y, z">Size of the geometry, see ShapeDesc</param>
+	/// <param name="mesh">Mesh of the mesh types</param>
+	void initParams(ShapeDesc::Type type, float x, float y, float z, bool isTrigger, float staticFriction, float dynamicFriction, float restitution,
+		physx::PxBase* mesh = nullptr);
+
+	/// <summary>
+	/// Changes the scale of the mesh of the shape
+	/// </summary>
+	void setMeshScale(const Vec3& scale);
+
+	/// <summary>
+	/// Returns the scale of the mesh of the shape
+	/// </summary>
+	Vec3 getMeshScale() const;
+
+	/// <summary>
+	/// Changes the shape of the actor for the shared one with that description
+	/// </summary>
+	void replaceShape(const ShapeDesc& desc);
+
+	/// <summary>
+	/// Applies a change to the actor, delayed until the end of the simulation if the scene is simulating
+	/// </summary>
+	/// <param name="write">Function that changes the actor</param>
+	void write(const std::function<void()>& write);
 
 	physx::PxShape* _mShape;
 	GameObject* _gameObject;
 	ContactCallback* _contCallback;
 	ContactCallback* _triggerCallback;
-	physx::PxRigidDynamic* _body;
+	physx::PxRigidActor* _body;
 
 	bool _isTrigger;
+	bool _isStatic;
 };
 
 class BoxCollider : public Collider {
@@ -134,8 +183,14 @@ public:
 	/// <param name="staticFriction">Static friction of the shape</param>
 	/// <param name="dynamicFriction">Dynamic friction of the shape</param>
 	/// <param name="restitution">Shape's restitution coefficient</param>
+	/// <param name="isStatic">True for a static actor, for the colliders that don't move</param>
 	BoxCollider(float width, float heigh, float depth, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback, ContactCallback* triggerCallback,
-		const std::tuple<float, float, float>& position, float staticFriction = 0.5f, float dynamicFriction = 0.5f, float restitution = 0.5f);
+		const Vec3& position, float staticFriction = 0.5f, float dynamicFriction = 0.5f, float restitution = 0.5f, bool isStatic = false);
+
+	/// <summary>
+	/// Takes a box actor loaded from a PhysicsCollection
+	/// </summary>
+	BoxCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback);
 
 	/// <summary>
 	/// Destructor of the class
@@ -184,8 +239,14 @@ public:
 	/// <param name="staticFriction">Static friction of the shape</param>
 	/// <param name="dynamicFriction">Dynamic friction of the shape</param>
 	/// <param name="restitution">Shape's restitution coefficient</param>
+	/// <param name="isStatic">True for a static actor, for the colliders that don't move</param>
 	SphereCollider(float r, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback, ContactCallback* triggerCallback,
-		const std::tuple<float, float, float>& position, float staticFriction = 0.5, float dynamicFriction = 0.5, float restitution = 0.5);
+		const Vec3& position, float staticFriction = 0.5, float dynamicFriction = 0.5, float restitution = 0.5, bool isStatic = false);
+
+	/// <summary>
+	/// Takes a sphere actor loaded from a PhysicsCollection
+	/// </summary>
+	SphereCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback);
 
 	/// <summary>
 	/// Destructor of the class
@@ -220,8 +281,14 @@ public:
 	/// <param name="staticFriction">Static friction of the shape</param>
 	/// <param name="dynamicFriction">Dynamic friction of the shape</param>
 	/// <param name="restitution">Shape's restitution coefficient</param>
+	/// <param name="isStatic">True for a static actor, for the colliders that don't move</param>
 	CapsuleCollider(float radius, float length, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback, ContactCallback* triggerCallback,
-		const std::tuple<float, float, float>& position, float staticFriction = 0.5, float dynamicFriction = 0.5, float restitution = 0.5);
+		const Vec3& position, float staticFriction = 0.5, float dynamicFriction = 0.5, float restitution = 0.5, bool isStatic = false);
+
+	/// <summary>
+	/// Takes a capsule actor loaded from a PhysicsCollection
+	/// </summary>
+	CapsuleCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback);
 
 	/// <summary>
 	/// Destructor of the class
@@ -248,4 +315,76 @@ public:
 	float getHeight();
 };
 
+class MeshCollider : public Collider {
+public:
+	/// <summary>
+	/// Constructor of the class. Physx doesn't simulate triangle meshes as triggers, so the collider is never one
+	/// </summary>
+	/// <param name="mesh">Cooked triangles of the collider, see MeshCooker</param>
+	/// <param name="scale">Scale of the mesh</param>
+	/// <param name="gameObject">Pointer to the GameObject owning the component, used for collision callbacks</param>
+	/// <param name="colliderCallback">Pointer to the function called on collision</param>
+	/// <param name="position">Position of the GameObject owning the component</param>
+	/// <param name="isStatic">True for a static actor, for the colliders that don't move</param>
+	MeshCollider(physx::PxTriangleMesh* mesh, const Vec3& scale, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback,
+		const Vec3& position, float staticFriction = 0.5f, float dynamicFriction = 0.5f, float restitution = 0.5f, bool isStatic = true);
+
+	/// <summary>
+	/// Takes a triangle mesh actor loaded from a PhysicsCollection
+	/// </summary>
+	MeshCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback);
+
+	/// <summary>
+	/// Destructor of the class
+	/// </summary>
+	virtual ~MeshCollider() {}
+
+	/// <summary>
+	/// Changes the scale of the mesh
+	/// </summary>
+	inline void setScale(const Vec3& scale) { setMeshScale(scale); }
+
+	/// <summary>
+	/// Gets the scale of the mesh
+	/// </summary>
+	inline Vec3 getScale() const { return getMeshScale(); }
+};
+
+class ConvexCollider : public Collider {
+public:
+	/// <summary>
+	/// Constructor of the class
+	/// </summary>
+	/// <param name="mesh">Cooked convex hull of the collider, see MeshCooker</param>
+	/// <param name="scale">Scale of the mesh</param>
+	/// <param name="isTrigger">True if shape is initially a trigger</param>
+	/// <param name="gameObject">Pointer to the GameObject owning the component, used for collision callbacks</param>
+	/// <param name="colliderCallback">Pointer to the function called on collision if collider is not a trigger</param>
+	/// <param name="triggerCallback">Pointer to the function called on collision if collider is a trigger</param>
+	/// <param name="position">Position of the GameObject owning the component</param>
+	/// <param name="isStatic">True for a static actor, for the colliders that don't move</param>
+	ConvexCollider(physx::PxConvexMesh* mesh, const Vec3& scale, bool isTrigger, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* colliderCallback,
+		ContactCallback* triggerCallback, const Vec3& position, float staticFriction = 0.5f, float dynamicFriction = 0.5f, float restitution = 0.5f, bool isStatic = false);
+
+	/// <summary>
+	/// Takes a convex mesh actor loaded from a PhysicsCollection
+	/// </summary>
+	ConvexCollider(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback, ContactCallback* triggerCallback);
+
+	/// <summary>
+	/// Destructor of the class
+	/// </summary>
+	virtual ~ConvexCollider() {}
+
+	/// <summary>
+	/// Changes the scale of the mesh
+	/// </summary>
+	inline void setScale(const Vec3& scale) { setMeshScale(scale); }
+
+	/// <summary>
+	/// Gets the scale of the mesh
+	/// </summary>
+	inline Vec3 getScale() const { return getMeshScale(); }
+};
+
 #endif //!COLLIDER_H
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "CollisionBody.h"
+
+unsigned long long CollisionBody::_nextSerial = 0;
+
+CollisionBody::CollisionBody() : _serial(++_nextSerial)
+{
+}
@@ -3,9 +3,31 @@
 #ifndef COLLISIONBODY_H
 #define COLLISIONBODY_H
 
+//Header only, the physics doesn't depend on the rest of MotorUnitario
+#include "MotorUnitario/GameObjectHandle.h"
+
 class GameObject;
+namespace physx {
+	class PxRigidActor;
+}
+struct Vec3;
+struct Quat;
+struct ContactEvent;
+
+/// <summary>
+/// Function called after the simulation step for every contact or trigger event of a body
+/// </summary>
+using ContactCallback = void(GameObjectHandle thisGO, GameObjectHandle otherGO, const ContactEvent& event);
 
-using ContactCallback = void(GameObject* thisGO, GameObject* otherGO);
+/// <summary>
+/// Function that returns the handle of the GameObject of a body, given by the Engine since the physics doesn't know the GameObjects
+/// </summary>
+using HandleFunction = GameObjectHandle(const GameObject* gameObject);
+
+/// <summary>
+/// Function that receives the pose of a body moved by the simulation
+/// </summary>
+using PoseCallback = void(void* target, const Vec3& position, const Quat& orientation);
 
 class CollisionBody
 {
@@ -14,8 +36,28 @@ public:
 	inline virtual ContactCallback* getColliderCallback() const { return nullptr; }
 	inline virtual GameObject* getGameObject() const { return nullptr; }
 
+	/// <summary>
+	/// Returns the physx actor of the body
+	/// </summary>
+	inline virtual physx::PxRigidActor* getActor() const { return nullptr; }
+
+	/// <summary>
+	/// Called by the PhysxEngine after a simulation step in which the actor of the body moved
+	/// </summary>
+	inline virtual void syncPose() {}
+
+	/// <summary>
+	/// Number that identifies the body for the whole run, unlike the address of its actor it's never reused
+	/// </summary>
+	inline unsigned long long getSerial() const { return _serial; }
+
 protected:
-	CollisionBody() {}
+	CollisionBody();
+
+private:
+	static unsigned long long _nextSerial;
+
+	unsigned long long _serial;
 };
 
 #endif //!COLLISIONBODY_H
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "CollisionLayers.h"
+#include "Exceptions.h"
+#include "PhysicsConfig.h"
+#include <PxFiltering.h>
+#include <PxShape.h>
+#include <algorithm>
+
+std::unique_ptr<CollisionLayers> CollisionLayers::instance = nullptr;
+
+CollisionLayers::CollisionLayers() : _names()
+{
+	reset();
+}
+
+CollisionLayers::~CollisionLayers()
+{
+}
+
+CollisionLayers* CollisionLayers::getInstance()
+{
+	if (instance.get() == nullptr) {
+		instance.reset(new CollisionLayers());
+	}
+	return instance.get();
+}
+
+void CollisionLayers::reset()
+{
+	for (int i = 0; i < MAX_LAYERS; ++i) {
+		_collide[i] = UINT32_MAX;
+		_notify[i] = UINT32_MAX;
+		_persist[i] = 0;
+		_points[i] = 0;
+	}
+	_names.clear();
+	_names.push_back("Default");
+}
+
+void CollisionLayers::load(const PhysicsConfig& config)
+{
+	//Everything is checked before changing the matrix, so a wrong config leaves it as it was
+	std::vector<std::string> names(1, "Default");
+	for (const std::string& name : config.layers)
+		if (std::find(names.begin(), names.end(), name) == names.end()) names.push_back(name);
+	if (names.size() > MAX_LAYERS)
+		throw EPhysxEngine("There can't be more than " + std::to_string(MAX_LAYERS) + " collision layers in the physics config");
+	checkPairs(names, config.ignoredCollisions);
+	checkPairs(names, config.ignoredNotifications);
+	checkPairs(names, config.persistentNotifications);
+	checkPairs(names, config.contactPoints);
+
+	reset();
+	_names = names;
+	for (const PhysicsConfig::LayerPair& pair : config.ignoredCollisions)
+		setCollision(getLayer(pair.layerA), getLayer(pair.layerB), false);
+	for (const PhysicsConfig::LayerPair& pair : config.ignoredNotifications)
+		setNotification(getLayer(pair.layerA), getLayer(pair.layerB), false);
+	for (const PhysicsConfig::LayerPair& pair : config.persistentNotifications)
+		setPersistentNotification(getLayer(pair.layerA), getLayer(pair.layerB), true);
+	for (const PhysicsConfig::LayerPair& pair : config.contactPoints)
+		setContactPoints(getLayer(pair.layerA), getLayer(pair.layerB), true);
+}
+
+int CollisionLayers::addLayer(const std::string& name)
+{
+	int layer = getLayer(name);
+	if (layer >= 0) return layer;
+
+	if (_names.size() >= MAX_LAYERS)
+		throw EPhysxEngine("There can't be more than " + std::to_string(MAX_LAYERS) + " collision layers, " + name + " can't be added");
+	_names.push_back(name);
+	return (int)_names.size() - 1;
+}
+
+int CollisionLayers::getLayer(const std::string& name) const
+{
+	for (size_t i = 0; i < _names.size(); ++i)
+		if (_names[i] == name) return (int)i;
+	return -1;
+}
+
+void CollisionLayers::setCollision(int layerA, int layerB, bool collide)
+{
+	setPair(_collide, layerA, layerB, collide);
+}
+
+void CollisionLayers::setNotification(int layerA, int layerB, bool notify)
+{
+	setPair(_notify, layerA, layerB, notify);
+}
+
+void CollisionLayers::setPersistentNotification(int layerA, int layerB, bool persistent)
+{
+	setPair(_persist, layerA, layerB, persistent);
+}
+
+void CollisionLayers::setContactPoints(int layerA, int layerB, bool points)
+{
+	setPair(_points, layerA, layerB, points);
+}
+
+int CollisionLayers::getLayerFromMask(uint32_t mask)
+{
+	for (int layer = 0; layer < MAX_LAYERS; ++layer)
+		if (mask & bit(layer)) return layer;
+	return -1;
+}
+
+physx::PxFilterData CollisionLayers::getFilterData(int layer) const
+{
+	return physx::PxFilterData(bit(layer), _collide[layer], _notify[layer], _points[layer]);
+}
+
+void CollisionLayers::apply(physx::PxShape* shape, int layer) const
+{
+	physx::PxFilterData data = getFilterData(layer);
+	shape->setSimulationFilterData(data);
+	shape->setQueryFilterData(data);
+}
+
+void CollisionLayers::setPair(uint32_t* masks, int layerA, int layerB, bool value)
+{
+	if (value) {
+		masks[layerA] |= bit(layerB);
+		masks[layerB] |= bit(layerA);
+	}
+	else {
+		masks[layerA] &= ~bit(layerB);
+		masks[layerB] &= ~bit(layerA);
+	}
+}
+
+void CollisionLayers::checkPairs(const std::vector<std::string>& names, const std::vector<PhysicsConfig::LayerPair>& pairs)
+{
+	for (const PhysicsConfig::LayerPair& pair : pairs) {
+		for (const std::string& name : { pair.layerA, pair.layerB })
+			if (std::find(names.begin(), names.end(), name) == names.end())
+				throw EPhysxEngine("The collision layer " + name + " of the physics config doesn't exist, it has to be in its layers");
+	}
+}
@@ -0,0 +1,162 @@
+#pragma once
+#ifndef COLLISIONLAYERS_H
+#define COLLISIONLAYERS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "PhysicsConfig.h"
+
+namespace physx {
+	struct PxFilterData;
+	class PxShape;
+}
+
+/*
+Matrix of named collision layers. For every pair of layers it says if they collide, if their contacts
+are reported to the callbacks of the bodies, if they are also reported every step while the bodies keep
+touching and if those reports have contact points. By default every layer collides with every layer and
+only reports when the contacts start and end, most resting contacts aren't interesting and would fill
+the events of every step.
+
+Each shape stores its layer and the row of its layer in its PxFilterData, so the filter shader
+doesn't need any shared state:
+	word0: bit of the layer
+	word1: layers it collides with
+	word2: layers whose contacts are reported
+	word3: layers whose contacts have contact points
+The layers that report every step don't fit in it, they go to the filter shader as its constant block.
+
+The shapes take the row of their layer when the layer is set and the scene copies the constant block
+when it's created, so the matrix has to be configured before the scene is loaded. PhysxEngine loads it
+from the PhysicsConfig every time it creates the scene.
+*/
+
+class CollisionLayers
+{
+public:
+	static const int MAX_LAYERS = 32;
+
+	/// <summary>
+	/// The layer of the bodies that don't set one
+	/// </summary>
+	static const int DEFAULT_LAYER = 0;
+
+	~CollisionLayers();
+
+	/// <summary>
+	/// Returns the instance of CollisionLayers, in case there is no such instance, it creates one and returns that one
+	/// </summary>
+	static CollisionLayers* getInstance();
+	CollisionLayers& operator=(const CollisionLayers&) = delete;
+	CollisionLayers(CollisionLayers& other) = delete;
+
+	/// <summary>
+	/// Removes every layer but the default one and puts the matrix back to its defaults
+	/// </summary>
+	void reset();
+
+	/// <summary>
+	/// Resets the matrix and sets the layers and pairs of the config
+	/// </summary>
+	/// <exception cref="EPhysxEngine">Thrown when a pair names a layer the config doesn't have, or there are too many layers.
+	/// The matrix is left as it was</exception>
+	void load(const PhysicsConfig& config);
+
+	/// <summary>
+	/// Adds a layer that collides with every layer and reports when its contacts start and end, without contact points
+	/// </summary>
+	/// <returns>The index of the layer, or the one it already had if the name is in use</returns>
+	/// <exception cref="EPhysxEngine">Thrown when there are already MAX_LAYERS layers</exception>
+	int addLayer(const std::string& name);
+
+	/// <summary>
+	/// Returns the index of the layer with that name, -1 if there is no such layer
+	/// </summary>
+	int getLayer(const std::string& name) const;
+
+	inline const std::string& getLayerName(int layer) const { return _names[layer]; }
+
+	inline int getLayerCount() const { return (int)_names.size(); }
+
+	/// <summary>
+	/// Sets if the bodies of both layers collide. The ones that don't collide aren't reported either
+	/// </summary>
+	void setCollision(int layerA, int layerB, bool collide);
+
+	/// <summary>
+	/// Sets if the contacts between the bodies of both layers are sent to their callbacks
+	/// </summary>
+	void setNotification(int layerA, int layerB, bool notify);
+
+	/// <summary>
+	/// Sets if the contacts between the bodies of both layers are also sent every step while they keep touching.
+	/// Only for the pairs that are notified
+	/// </summary>
+	void setPersistentNotification(int layerA, int layerB, bool persistent);
+
+	/// <summary>
+	/// Sets if the contacts reported between the bodies of both layers have contact points
+	/// </summary>
+	void setContactPoints(int layerA, int layerB, bool points);
+
+	/// <summary>
+	/// Returns the mask with only the bit of the layer, the masks of several layers are combined with |
+	/// </summary>
+	static inline uint32_t getMask(int layer) { return bit(layer); }
+
+	/// <summary>
+	/// Returns the layer of the lowest bit of the mask, -1 if it's empty
+	/// </summary>
+	static int getLayerFromMask(uint32_t mask);
+
+	inline bool collides(int layerA, int layerB) const { return (_collide[layerA] & bit(layerB)) != 0; }
+	inline bool notifies(int layerA, int layerB) const { return (_notify[layerA] & bit(layerB)) != 0; }
+	inline bool notifiesPersistent(int layerA, int layerB) const { return (_persist[layerA] & bit(layerB)) != 0; }
+	inline bool hasContactPoints(int layerA, int layerB) const { return (_points[layerA] & bit(layerB)) != 0; }
+
+	/// <summary>
+	/// Returns the filter data of the shapes of the layer
+	/// </summary>
+	physx::PxFilterData getFilterData(int layer) const;
+
+	/// <summary>
+	/// Sets the filter data of the layer as the simulation and query filter data of the shape
+	/// </summary>
+	void apply(physx::PxShape* shape, int layer) const;
+
+	/// <summary>
+	/// Returns the constant block of the filter shader, the layers each layer reports every step with
+	/// </summary>
+	inline const uint32_t* getPersistentMasks() const { return _persist; }
+
+private:
+	/// <summary>
+	/// Contructor of the class, with only the default layer
+	/// </summary>
+	CollisionLayers();
+
+	static inline uint32_t bit(int layer) { return 1u << layer; }
+
+	/// <summary>
+	/// Sets or clears the bit of each layer in the mask of the other one
+	/// </summary>
+	static void setPair(uint32_t* masks, int layerA, int layerB, bool value);
+
+	/// <summary>
+	/// Checks that both layers of every pair are in the names
+	/// </summary>
+	/// <exception cref="EPhysxEngine">Thrown when a layer isn't</exception>
+	static void checkPairs(const std::vector<std::string>& names, const std::vector<PhysicsConfig::LayerPair>& pairs);
+
+	static std::unique_ptr<CollisionLayers> instance;
+
+	std::vector<std::string> _names;
+	uint32_t _collide[MAX_LAYERS];
+	uint32_t _notify[MAX_LAYERS];
+	uint32_t _persist[MAX_LAYERS];
+	uint32_t _points[MAX_LAYERS];
+};
+
+#endif // !COLLISIONLAYERS_H
@@ -0,0 +1,45 @@
+#include "ContactEvents.h"
+
+ContactEventBuffer::ContactEventBuffer(size_t eventCapacity, size_t pointCapacity) : _handleFunction(nullptr), _events(), _points()
+{
+	_events.reserve(eventCapacity);
+	_points.reserve(pointCapacity);
+}
+
+void ContactEventBuffer::add(GameObject* gameObject0, GameObject* gameObject1, ContactCallback* callback, ContactState::ContactState state, bool trigger)
+{
+	_events.push_back({ toHandle(gameObject0), toHandle(gameObject1), callback, state, trigger, nullptr, 0, 0 });
+}
+
+ContactPoint* ContactEventBuffer::addContact(GameObject* gameObject0, GameObject* gameObject1, ContactCallback* callback, ContactState::ContactState state, unsigned int pointCount)
+{
+	unsigned int firstPoint = (unsigned int)_points.size();
+	_events.push_back({ toHandle(gameObject0), toHandle(gameObject1), callback, state, false, nullptr, pointCount, firstPoint });
+	_points.resize(_points.size() + pointCount);
+	return _points.data() + firstPoint;
+}
+
+void ContactEventBuffer::dispatch()
+{
+	//The points don't move anymore, so the pointers can be set
+	for (size_t i = 0; i < _events.size(); ++i) {
+		ContactEvent& event = _events[i];
+		if (event.pointCount > 0)
+			event.points = _points.data() + event.firstPoint;
+		event.callback(event.gameObject0, event.gameObject1, event);
+	}
+	clear();
+}
+
+GameObjectHandle ContactEventBuffer::toHandle(const GameObject* gameObject) const
+{
+	if (gameObject == nullptr || _handleFunction == nullptr)
+		return GameObjectHandle();
+	return _handleFunction(gameObject);
+}
+
+void ContactEventBuffer::clear()
+{
+	_events.clear();
+	_points.clear();
+}
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef CONTACTEVENTS_H
+#define CONTACTEVENTS_H
+
+#include <vector>
+#include "MotorMath/Vec3.h"
+#include "CollisionBody.h"
+
+namespace ContactState {
+	enum ContactState : unsigned char {
+		//First step in which the bodies touch
+		Enter = 0,
+		//Every following step while they keep touching, only if their layers ask for it (CollisionLayers)
+		Stay,
+		//First step in which they don't touch anymore
+		Exit
+	};
+}
+
+/// <summary>
+/// Point of a contact between two bodies. The normal points from the second body to the first one
+/// </summary>
+struct ContactPoint {
+	Vec3 position;
+	Vec3 normal;
+	//Negative when the shapes are penetrating
+	float separation;
+};
+
+/// <summary>
+/// Contact or trigger pair reported by a simulation step
+/// </summary>
+struct ContactEvent {
+	//For a trigger, gameObject0 is the one of the trigger. The GameObjects may be destroyed before the event is dispatched
+	GameObjectHandle gameObject0;
+	GameObjectHandle gameObject1;
+	ContactCallback* callback;
+	ContactState::ContactState state;
+	bool trigger;
+	//Only for contacts whose layers ask for them (CollisionLayers), and never for Exit
+	const ContactPoint* points;
+	unsigned int pointCount;
+	//Position of the points in the buffer, the pointer is set when the event is dispatched
+	unsigned int firstPoint;
+};
+
+/*
+Events of the simulation steps, recorded by the callbacks of PhysX and dispatched after the step,
+outside of the callback context of PhysX.
+
+The memory is kept between steps, so once it has grown to the usual number of events nothing is allocated.
+*/
+class ContactEventBuffer
+{
+public:
+	/// <summary>
+	/// Reserves the memory for the given number of events and contact points
+	/// </summary>
+	ContactEventBuffer(size_t eventCapacity, size_t pointCapacity);
+
+	/// <summary>
+	/// Sets the function that gives the handles of the GameObjects of the events. Without it the handles are invalid
+	/// </summary>
+	inline void setHandleFunction(HandleFunction* function) { _handleFunction = function; }
+
+	/// <summary>
+	/// Records an event without contact points
+	/// </summary>
+	void add(GameObject* gameObject0, GameObject* gameObject1, ContactCallback* callback, ContactState::ContactState state, bool trigger);
+
+	/// <summary>
+	/// Records a contact event and returns the memory for its points, valid until the next call
+	/// </summary>
+	/// <param name="pointCount">Number of points of the contact</param>
+	ContactPoint* addContact(GameObject* gameObject0, GameObject* gameObject1, ContactCallback* callback, ContactState::ContactState state, unsigned int pointCount);
+
+	/// <summary>
+	/// Calls the callback of every event in the order they were recorded, and clears the buffer
+	/// </summary>
+	void dispatch();
+
+	void clear();
+
+	inline size_t size() const { return _events.size(); }
+
+	inline bool empty() const { return _events.empty(); }
+
+private:
+	/// <summary>
+	/// Returns the handle of the GameObject, or an invalid one for bodies without GameObject
+	/// </summary>
+	GameObjectHandle toHandle(const GameObject* gameObject) const;
+
+	HandleFunction* _handleFunction;
+	std::vector<ContactEvent> _events;
+	std::vector<ContactPoint> _points;
+};
+
+#endif // !CONTACTEVENTS_H
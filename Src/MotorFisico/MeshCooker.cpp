@@ -0,0 +1,177 @@
+#include "MeshCooker.h"
+#include "Exceptions.h"
+#include <PxPhysicsAPI.h>
+#include <fstream>
+#include <cstdio>
+
+MeshCooker::MeshCooker(physx::PxPhysics* physics, physx::PxCooking* cooking, const std::string& cacheDirectory) :
+	_physics(physics), _cooking(cooking), _cacheDirectory(cacheDirectory), _triangleMeshes(), _convexMeshes(), _sourceKeys()
+{
+}
+
+MeshCooker::~MeshCooker()
+{
+	clear();
+}
+
+physx::PxTriangleMesh* MeshCooker::getTriangleMesh(const std::string& source, const SourceReader& readSource, const TriangleReader& readTriangles)
+{
+	uint64_t key = getKey('T', source, readSource);
+	auto it = _triangleMeshes.find(key);
+	if (it != _triangleMeshes.end()) return it->second;
+
+	physx::PxTriangleMesh* mesh = nullptr;
+	std::string path = getCachePath(key, ".tri");
+	std::vector<unsigned char> data;
+	if (readFile(path, data)) {
+		physx::PxDefaultMemoryInputData input(data.data(), (physx::PxU32)data.size());
+		mesh = _physics->createTriangleMesh(input);
+	}
+
+	//Cooked when there is no file, or when it was written by another version of physx and can't be read
+	if (mesh == nullptr) {
+		std::vector<Vec3> vertices;
+		std::vector<uint32_t> indices;
+		readTriangles(vertices, indices);
+		if (vertices.empty() || indices.size() < 3)
+			throw EPhysxEngine("The triangle mesh " + source + " needs at least one triangle");
+
+		physx::PxTriangleMeshDesc desc;
+		desc.points.count = (physx::PxU32)vertices.size();
+		desc.points.stride = sizeof(Vec3);
+		desc.points.data = vertices.data();
+		desc.triangles.count = (physx::PxU32)(indices.size() / 3);
+		desc.triangles.stride = 3 * sizeof(uint32_t);
+		desc.triangles.data = indices.data();
+
+		physx::PxDefaultMemoryOutputStream output;
+		if (!_cooking->cookTriangleMesh(desc, output))
+			throw EPhysxEngine("The triangle mesh " + source + " can't be cooked");
+		writeFile(path, output.getData(), output.getSize());
+
+		physx::PxDefaultMemoryInputData input(output.getData(), output.getSize());
+		mesh = _physics->createTriangleMesh(input);
+	}
+
+	_triangleMeshes[key] = mesh;
+	return mesh;
+}
+
+physx::PxConvexMesh* MeshCooker::getConvexMesh(const std::string& source, const SourceReader& readSource, const TriangleReader& readTriangles)
+{
+	uint64_t key = getKey('C', source, readSource);
+	auto it = _convexMeshes.find(key);
+	if (it != _convexMeshes.end()) return it->second;
+
+	physx::PxConvexMesh* mesh = nullptr;
+	std::string path = getCachePath(key, ".cvx");
+	std::vector<unsigned char> data;
+	if (readFile(path, data)) {
+		physx::PxDefaultMemoryInputData input(data.data(), (physx::PxU32)data.size());
+		mesh = _physics->createConvexMesh(input);
+	}
+
+	if (mesh == nullptr) {
+		//The hull only needs the vertices
+		std::vector<Vec3> vertices;
+		std::vector<uint32_t> indices;
+		readTriangles(vertices, indices);
+		if (vertices.size() < 4)
+			throw EPhysxEngine("The convex mesh " + source + " needs at least four vertices");
+
+		physx::PxConvexMeshDesc desc;
+		desc.points.count = (physx::PxU32)vertices.size();
+		desc.points.stride = sizeof(Vec3);
+		desc.points.data = vertices.data();
+		desc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX | physx::PxConvexFlag::eSHIFT_VERTICES;
+
+		physx::PxDefaultMemoryOutputStream output;
+		if (!_cooking->cookConvexMesh(desc, output))
+			throw EPhysxEngine("The convex mesh " + source + " can't be cooked");
+		writeFile(path, output.getData(), output.getSize());
+
+		physx::PxDefaultMemoryInputData input(output.getData(), output.getSize());
+		mesh = _physics->createConvexMesh(input);
+	}
+
+	_convexMeshes[key] = mesh;
+	return mesh;
+}
+
+void MeshCooker::clear()
+{
+	for (auto& mesh : _triangleMeshes)
+		mesh.second->release();
+	_triangleMeshes.clear();
+	for (auto& mesh : _convexMeshes)
+		mesh.second->release();
+	_convexMeshes.clear();
+	_sourceKeys.clear();
+}
+
+Vec3 MeshCooker::getSize(const physx::PxTriangleMesh* mesh)
+{
+	physx::PxBounds3 bounds = mesh->getLocalBounds();
+	return Vec3(bounds.maximum.x - bounds.minimum.x, bounds.maximum.y - bounds.minimum.y, bounds.maximum.z - bounds.minimum.z);
+}
+
+Vec3 MeshCooker::getSize(const physx::PxConvexMesh* mesh)
+{
+	physx::PxBounds3 bounds = mesh->getLocalBounds();
+	return Vec3(bounds.maximum.x - bounds.minimum.x, bounds.maximum.y - bounds.minimum.y, bounds.maximum.z - bounds.minimum.z);
+}
+
+uint64_t MeshCooker::getKey(char kind, const std::string& source, const SourceReader& readSource)
+{
+	std::string name = kind + source;
+	auto it = _sourceKeys.find(name);
+	if (it != _sourceKeys.end()) return it->second;
+
+	std::vector<unsigned char> data;
+	readSource(data);
+	uint64_t key = hash(kind, data);
+	_sourceKeys[name] = key;
+	return key;
+}
+
+uint64_t MeshCooker::hash(char kind, const std::vector<unsigned char>& data)
+{
+	uint64_t h = 14695981039346656037ull;
+	auto add = [&h](const void* data, size_t size) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			h ^= bytes[i];
+			h *= 1099511628211ull;
+		}
+	};
+
+	const uint32_t version = PX_PHYSICS_VERSION;
+	add(&kind, sizeof(kind));
+	add(&version, sizeof(version));
+	add(data.data(), data.size());
+	return h;
+}
+
+std::string MeshCooker::getCachePath(uint64_t key, const char* extension) const
+{
+	char name[17];
+	std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+	return _cacheDirectory + name + extension;
+}
+
+bool MeshCooker::readFile(const std::string& path, std::vector<unsigned char>& data)
+{
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) return false;
+
+	data.resize((size_t)in.tellg());
+	in.seekg(0);
+	return (bool)in.read(reinterpret_cast<char*>(data.data()), data.size());
+}
+
+void MeshCooker::writeFile(const std::string& path, const unsigned char* data, size_t size)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (out)
+		out.write(reinterpret_cast<const char*>(data), size);
+}
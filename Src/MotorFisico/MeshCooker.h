@@ -0,0 +1,119 @@
+#pragma once
+#ifndef MESHCOOKER_H
+#define MESHCOOKER_H
+
+#include "MotorMath/Vec3.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+namespace physx {
+	class PxPhysics;
+	class PxCooking;
+	class PxTriangleMesh;
+	class PxConvexMesh;
+}
+
+/*
+Cooks the triangle meshes and convex meshes of the colliders.
+
+Cooking is slow, so the cooked data is written to the cache directory with the hash of the source file
+(the .mesh) as its name, and the next time the same file is asked for the cooked one is read instead, without
+reading the triangles of the source. The meshes are also kept in memory by their hash, and the hash of each
+source by its name, so the objects with the same mesh share it and read its file once. A changed file has a
+new hash, the old cooked files are never read again and can be deleted.
+*/
+class MeshCooker
+{
+public:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	/// <param name="cacheDirectory">Directory of the cooked files, it must exist and end with '/'</param>
+	MeshCooker(physx::PxPhysics* physics, physx::PxCooking* cooking, const std::string& cacheDirectory);
+
+	/// <summary>
+	/// Releases the references of the cooker, the meshes still in use by the shapes live until they are released
+	/// </summary>
+	~MeshCooker();
+
+	MeshCooker& operator=(const MeshCooker&) = delete;
+	MeshCooker(MeshCooker& other) = delete;
+
+	/// <summary>
+	/// Reads the bytes of the source file
+	/// </summary>
+	using SourceReader = std::function<void(std::vector<unsigned char>& data)>;
+
+	/// <summary>
+	/// Reads the triangles of the source file, only called when there is nothing cooked for it
+	/// </summary>
+	using TriangleReader = std::function<void(std::vector<Vec3>& vertices, std::vector<uint32_t>& indices)>;
+
+	/// <summary>
+	/// Returns the triangle mesh of the source, from memory, from the cache directory or cooked
+	/// </summary>
+	/// <param name="source">Name of the source file, its hash is kept so it's read once</param>
+	/// <exception cref="EPhysxEngine">thrown when the triangles can't be cooked</exception>
+	physx::PxTriangleMesh* getTriangleMesh(const std::string& source, const SourceReader& readSource, const TriangleReader& readTriangles);
+
+	/// <summary>
+	/// Returns the convex hull of the vertices of the source, from memory, from the cache directory or cooked.
+	/// The hull has 255 vertices at most, the rest are simplified
+	/// </summary>
+	/// <param name="source">Name of the source file, its hash is kept so it's read once</param>
+	/// <exception cref="EPhysxEngine">thrown when the hull can't be cooked</exception>
+	physx::PxConvexMesh* getConvexMesh(const std::string& source, const SourceReader& readSource, const TriangleReader& readTriangles);
+
+	/// <summary>
+	/// Size of the bounds of the mesh, without its scale
+	/// </summary>
+	static Vec3 getSize(const physx::PxTriangleMesh* mesh);
+	static Vec3 getSize(const physx::PxConvexMesh* mesh);
+
+	inline void setCacheDirectory(const std::string& cacheDirectory) { _cacheDirectory = cacheDirectory; }
+	inline const std::string& getCacheDirectory() const { return _cacheDirectory; }
+
+	/// <summary>
+	/// Releases the references to the meshes, those that no shape uses are destroyed
+	/// </summary>
+	void clear();
+
+private:
+	/// <summary>
+	/// FNV-1a hash of the source, of what it's cooked into and of the version of physx
+	/// </summary>
+	static uint64_t hash(char kind, const std::vector<unsigned char>& data);
+
+	/// <summary>
+	/// Returns the hash of the source, it's read the first time
+	/// </summary>
+	uint64_t getKey(char kind, const std::string& source, const SourceReader& readSource);
+
+	/// <summary>
+	/// Path of the cooked file of the hash
+	/// </summary>
+	std::string getCachePath(uint64_t key, const char* extension) const;
+
+	/// <summary>
+	/// Reads the whole file, false if it doesn't exist
+	/// </summary>
+	static bool readFile(const std::string& path, std::vector<unsigned char>& data);
+
+	/// <summary>
+	/// Writes the cooked data, a cache that can't be written is only slower the next time
+	/// </summary>
+	static void writeFile(const std::string& path, const unsigned char* data, size_t size);
+
+	physx::PxPhysics* _physics;
+	physx::PxCooking* _cooking;
+	std::string _cacheDirectory;
+	std::unordered_map<uint64_t, physx::PxTriangleMesh*> _triangleMeshes;
+	std::unordered_map<uint64_t, physx::PxConvexMesh*> _convexMeshes;
+	//Hash of each source by its kind and name
+	std::unordered_map<std::string, uint64_t> _sourceKeys;
+};
+
+#endif // !MESHCOOKER_H
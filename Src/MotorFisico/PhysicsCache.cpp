@@ -0,0 +1,163 @@
+#include "PhysicsCache.h"
+#include "CollisionLayers.h"
+#include "MotorMath/PhysxMath.h"
+#include <PxPhysicsAPI.h>
+
+bool ShapeDesc::operator<(const ShapeDesc& other) const
+{
+	if (type != other.type) return type < other.type;
+	for (int i = 0; i < 3; ++i)
+		if (size[i] != other.size[i]) return size[i] < other.size[i];
+	if (material != other.material) return material < other.material;
+	if (trigger != other.trigger) return trigger < other.trigger;
+	if (layer != other.layer) return layer < other.layer;
+	return mesh < other.mesh;
+}
+
+PhysicsCache::PhysicsCache(physx::PxPhysics* physics) : _physics(physics), _materials(), _namedMaterials(), _shapes()
+{
+}
+
+PhysicsCache::~PhysicsCache()
+{
+	clearShapes();
+	for (auto& material : _materials)
+		material.second->release();
+	_materials.clear();
+}
+
+physx::PxMaterial* PhysicsCache::getMaterial(float staticFriction, float dynamicFriction, float restitution)
+{
+	MaterialDesc desc = { staticFriction, dynamicFriction, restitution };
+	auto it = _materials.find(desc);
+	if (it != _materials.end()) return it->second;
+
+	physx::PxMaterial* material = _physics->createMaterial(staticFriction, dynamicFriction, restitution);
+	_materials[desc] = material;
+	return material;
+}
+
+void PhysicsCache::addMaterial(const std::string& name, float staticFriction, float dynamicFriction, float restitution)
+{
+	_namedMaterials[name] = { staticFriction, dynamicFriction, restitution };
+}
+
+const MaterialDesc* PhysicsCache::findMaterial(const std::string& name) const
+{
+	auto it = _namedMaterials.find(name);
+	return it != _namedMaterials.end() ? &it->second : nullptr;
+}
+
+physx::PxShape* PhysicsCache::getShape(const ShapeDesc& desc)
+{
+	auto it = _shapes.find(desc);
+	if (it != _shapes.end()) return it->second;
+
+	physx::PxShape* shape = createShape(desc, false);
+	_shapes[desc] = shape;
+	return shape;
+}
+
+ShapeDesc PhysicsCache::describe(const physx::PxShape* shape)
+{
+	ShapeDesc desc = { ShapeDesc::Sphere, { 0, 0, 0 }, nullptr, false, CollisionLayers::DEFAULT_LAYER };
+
+	physx::PxGeometryHolder geometry = shape->getGeometry();
+	switch (geometry.getType())
+	{
+	case physx::PxGeometryType::eBOX:
+		desc.type = ShapeDesc::Box;
+		desc.size[0] = geometry.box().halfExtents.x;
+		desc.size[1] = geometry.box().halfExtents.y;
+		desc.size[2] = geometry.box().halfExtents.z;
+		break;
+	case physx::PxGeometryType::eCAPSULE:
+		desc.type = ShapeDesc::Capsule;
+		desc.size[0] = geometry.capsule().radius;
+		desc.size[1] = geometry.capsule().halfHeight;
+		break;
+	case physx::PxGeometryType::eTRIANGLEMESH:
+		desc.type = ShapeDesc::TriangleMesh;
+		desc.size[0] = geometry.triangleMesh().scale.scale.x;
+		desc.size[1] = geometry.triangleMesh().scale.scale.y;
+		desc.size[2] = geometry.triangleMesh().scale.scale.z;
+		desc.mesh = geometry.triangleMesh().triangleMesh;
+		break;
+	case physx::PxGeometryType::eCONVEXMESH:
+		desc.type = ShapeDesc::ConvexMesh;
+		desc.size[0] = geometry.convexMesh().scale.scale.x;
+		desc.size[1] = geometry.convexMesh().scale.scale.y;
+		desc.size[2] = geometry.convexMesh().scale.scale.z;
+		desc.mesh = geometry.convexMesh().convexMesh;
+		break;
+	default:
+		desc.size[0] = geometry.sphere().radius;
+		break;
+	}
+
+	physx::PxMaterial* material = nullptr;
+	shape->getMaterials(&material, 1);
+	desc.material = getMaterial(material->getStaticFriction(), material->getDynamicFriction(), material->getRestitution());
+	desc.trigger = shape->getFlags().isSet(physx::PxShapeFlag::eTRIGGER_SHAPE);
+
+	//word0 of the filter data has only the bit of the layer
+	int layer = CollisionLayers::getLayerFromMask(shape->getSimulationFilterData().word0);
+	if (layer >= 0) desc.layer = layer;
+	return desc;
+}
+
+void PhysicsCache::replaceShape(physx::PxRigidActor* actor, physx::PxShape*& shape, const ShapeDesc& desc)
+{
+	physx::PxShape* newShape = getShape(desc);
+	if (newShape == shape) return;
+
+	actor->attachShape(*newShape);
+	actor->detachShape(*shape);
+	shape = newShape;
+}
+
+physx::PxShape* PhysicsCache::attachExclusiveShape(physx::PxRigidActor* actor, const ShapeDesc& desc, const Vec3& position, const Quat& orientation)
+{
+	physx::PxShape* shape = createShape(desc, true);
+	shape->setLocalPose(physx::PxTransform(toPx(position), toPx(orientation)));
+	actor->attachShape(*shape);
+	//The actor keeps the only reference
+	shape->release();
+	return shape;
+}
+
+void PhysicsCache::clearShapes()
+{
+	for (auto& shape : _shapes)
+		shape.second->release();
+	_shapes.clear();
+}
+
+physx::PxShape* PhysicsCache::createShape(const ShapeDesc& desc, bool exclusive) const
+{
+	physx::PxShapeFlags flags = desc.trigger ? physx::PxShapeFlag::eTRIGGER_SHAPE | physx::PxShapeFlag::eSCENE_QUERY_SHAPE
+		: physx::PxShapeFlag::eSIMULATION_SHAPE | physx::PxShapeFlag::eSCENE_QUERY_SHAPE;
+	physx::PxShape* shape;
+	switch (desc.type)
+	{
+	case ShapeDesc::Box:
+		shape = _physics->createShape(physx::PxBoxGeometry(desc.size[0], desc.size[1], desc.size[2]), *desc.material, exclusive, flags);
+		break;
+	case ShapeDesc::Capsule:
+		shape = _physics->createShape(physx::PxCapsuleGeometry(desc.size[0], desc.size[1]), *desc.material, exclusive, flags);
+		break;
+	case ShapeDesc::TriangleMesh:
+		shape = _physics->createShape(physx::PxTriangleMeshGeometry(static_cast<physx::PxTriangleMesh*>(desc.mesh),
+			physx::PxMeshScale(physx::PxVec3(desc.size[0], desc.size[1], desc.size[2]))), *desc.material, exclusive, flags);
+		break;
+	case ShapeDesc::ConvexMesh:
+		shape = _physics->createShape(physx::PxConvexMeshGeometry(static_cast<physx::PxConvexMesh*>(desc.mesh),
+			physx::PxMeshScale(physx::PxVec3(desc.size[0], desc.size[1], desc.size[2]))), *desc.material, exclusive, flags);
+		break;
+	default:
+		shape = _physics->createShape(physx::PxSphereGeometry(desc.size[0]), *desc.material, exclusive, flags);
+		break;
+	}
+	CollisionLayers::getInstance()->apply(shape, desc.layer);
+	return shape;
+}
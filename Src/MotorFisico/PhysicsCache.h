@@ -0,0 +1,139 @@
+#pragma once
+#ifndef PHYSICSCACHE_H
+#define PHYSICSCACHE_H
+
+#include <map>
+#include <string>
+
+namespace physx {
+	class PxPhysics;
+	class PxMaterial;
+	class PxShape;
+	class PxRigidActor;
+	class PxBase;
+}
+struct Vec3;
+struct Quat;
+
+/// <summary>
+/// Friction and restitution of a material
+/// </summary>
+struct MaterialDesc {
+	float staticFriction;
+	float dynamicFriction;
+	float restitution;
+
+	inline bool operator<(const MaterialDesc& other) const {
+		if (staticFriction != other.staticFriction) return staticFriction < other.staticFriction;
+		if (dynamicFriction != other.dynamicFriction) return dynamicFriction < other.dynamicFriction;
+		return restitution < other.restitution;
+	}
+};
+
+/// <summary>
+/// Everything that makes two shapes equal, the bodies with equal shapes share the same PxShape
+/// </summary>
+struct ShapeDesc {
+	enum Type : unsigned char {
+		Sphere, Box, Capsule, TriangleMesh, ConvexMesh
+	};
+
+	Type type;
+	//Radius of a sphere, half extents of a box, radius and half height of a capsule, or scale of a mesh
+	float size[3];
+	physx::PxMaterial* material;
+	bool trigger;
+	//Index of the layer in CollisionLayers
+	int layer;
+	//PxTriangleMesh or PxConvexMesh of the mesh types, see MeshCooker
+	physx::PxBase* mesh;
+
+	bool operator<(const ShapeDesc& other) const;
+};
+
+/*
+Materials and shapes shared by the bodies of the scene.
+
+There is one PxMaterial for each combination of friction and restitution, and one PxShape for each
+combination of geometry, material, trigger flag and layer, so a level with thousands of equal crates
+creates only one of each. The shared objects are never modified: a body that changes its shape
+attaches the shape that has the change instead.
+
+The materials can also be registered with a name, to be used from the Lua files of the scenes.
+*/
+class PhysicsCache
+{
+public:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	/// <param name="physics">Physics that creates the materials and shapes</param>
+	PhysicsCache(physx::PxPhysics* physics);
+
+	/// <summary>
+	/// Releases the references of the cache, the objects still in use by the actors live until they are released
+	/// </summary>
+	~PhysicsCache();
+
+	PhysicsCache& operator=(const PhysicsCache&) = delete;
+	PhysicsCache(PhysicsCache& other) = delete;
+
+	/// <summary>
+	/// Returns the material with those values, it's created the first time it's asked for
+	/// </summary>
+	physx::PxMaterial* getMaterial(float staticFriction, float dynamicFriction, float restitution);
+
+	/// <summary>
+	/// Registers a named material, replacing the values of the material with that name if there is one
+	/// </summary>
+	void addMaterial(const std::string& name, float staticFriction, float dynamicFriction, float restitution);
+
+	/// <summary>
+	/// Returns the values of the named material, nullptr if there is no such material
+	/// </summary>
+	const MaterialDesc* findMaterial(const std::string& name) const;
+
+	/// <summary>
+	/// Returns the shape with that description, it's created the first time it's asked for.
+	/// The shapes are shared, so they must not be modified
+	/// </summary>
+	physx::PxShape* getShape(const ShapeDesc& desc);
+
+	/// <summary>
+	/// Returns the description of a shape. The material is the one of the cache with the same values,
+	/// so a shape made elsewhere (a loaded PhysicsCollection) is replaced by shapes of the cache
+	/// </summary>
+	ShapeDesc describe(const physx::PxShape* shape);
+
+	/// <summary>
+	/// Detaches shape from the actor and attaches the one with the description instead
+	/// </summary>
+	/// <param name="shape">Shape of the actor, it is changed to the new one</param>
+	void replaceShape(physx::PxRigidActor* actor, physx::PxShape*& shape, const ShapeDesc& desc);
+
+	/// <summary>
+	/// Creates a shape with the description that only that actor uses and attaches it at a local pose.
+	/// These shapes aren't shared, the actor owns them
+	/// </summary>
+	/// <param name="position">Position of the shape relative to the actor</param>
+	/// <param name="orientation">Orientation of the shape relative to the actor</param>
+	physx::PxShape* attachExclusiveShape(physx::PxRigidActor* actor, const ShapeDesc& desc, const Vec3& position, const Quat& orientation);
+
+	/// <summary>
+	/// Releases the references of the cache to the shapes, those that no actor uses are destroyed
+	/// </summary>
+	void clearShapes();
+
+private:
+	/// <summary>
+	/// Creates the shape of the description with its flags and layer
+	/// </summary>
+	physx::PxShape* createShape(const ShapeDesc& desc, bool exclusive) const;
+
+	physx::PxPhysics* _physics;
+	std::map<MaterialDesc, physx::PxMaterial*> _materials;
+	std::map<std::string, MaterialDesc> _namedMaterials;
+	std::map<ShapeDesc, physx::PxShape*> _shapes;
+};
+
+#endif // !PHYSICSCACHE_H
@@ -0,0 +1,255 @@
+#include "PhysicsCollection.h"
+#include "PhysxEngine.h"
+#include "CollisionBody.h"
+#include "Exceptions.h"
+#include <PxPhysicsAPI.h>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace {
+	const char MAGIC[4] = { 'M', 'U', 'P', 'C' };
+	const uint32_t VERSION = 1;
+	//physx builds the objects in place, the binary data must be aligned to 128 bytes
+	const size_t ALIGNMENT = PX_SERIAL_FILE_ALIGN;
+
+	/*
+	Layout of the file, the header is followed by the binary collection of physx:
+		magic, version, number of keys, offset of the collection
+		for each key: length, characters, id of the actor
+	*/
+	template<typename T>
+	void append(std::vector<char>& out, const T& value)
+	{
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	bool read(const char*& in, const char* end, T& value)
+	{
+		if ((size_t)(end - in) < sizeof(T)) return false;
+		std::memcpy(&value, in, sizeof(T));
+		in += sizeof(T);
+		return true;
+	}
+}
+
+PhysicsCollection::PhysicsCollection() : _registry(nullptr), _blocks(), _unbound()
+{
+	_registry = physx::PxSerialization::createSerializationRegistry(*PhysxEngine::getPxInstance()->getPhysics());
+}
+
+PhysicsCollection::~PhysicsCollection()
+{
+	for (Block& block : _blocks)
+		close(block);
+	_blocks.clear();
+	_registry->release();
+}
+
+void PhysicsCollection::save(const std::string& file, const std::vector<std::pair<std::string, CollisionBody*>>& bodies)
+{
+	PhysxEngine::getPxInstance()->fetchResults(true);
+
+	physx::PxCollection* collection = PxCreateCollection();
+	std::vector<std::pair<const std::string*, physx::PxSerialObjectId>> keys;
+	//Id 0 means no id for physx
+	physx::PxSerialObjectId id = 1;
+	for (const auto& body : bodies) {
+		physx::PxRigidActor* actor = body.second->getActor();
+		if (actor == nullptr || collection->contains(*actor)) continue;
+		collection->add(*actor, id);
+		keys.push_back(std::make_pair(&body.first, id++));
+	}
+
+	//The shapes and materials of the actors go with them, with ids after the ones of the actors
+	physx::PxSerialization::complete(*collection, *_registry);
+	physx::PxSerialization::createSerialObjectIds(*collection, id);
+	physx::PxDefaultMemoryOutputStream data;
+	bool serialized = physx::PxSerialization::serializeCollectionToBinary(data, *collection, *_registry);
+	collection->release();
+	if (!serialized)
+		throw EPhysxEngine("The physics of " + file + " can't be serialized");
+
+	std::vector<char> header;
+	header.insert(header.end(), MAGIC, MAGIC + sizeof(MAGIC));
+	append(header, VERSION);
+	append(header, (uint32_t)keys.size());
+	size_t offsetPosition = header.size();
+	append(header, (uint32_t)0);
+	for (const auto& key : keys) {
+		append(header, (uint32_t)key.first->size());
+		header.insert(header.end(), key.first->begin(), key.first->end());
+		append(header, (uint64_t)key.second);
+	}
+	header.resize((header.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, 0);
+	uint32_t offset = (uint32_t)header.size();
+	std::memcpy(header.data() + offsetPosition, &offset, sizeof(offset));
+
+	std::ofstream out(file, std::ios::binary | std::ios::trunc);
+	out.write(header.data(), header.size());
+	out.write(reinterpret_cast<const char*>(data.getData()), data.getSize());
+	if (!out)
+		throw EPhysxEngine("The physics collection " + file + " can't be written");
+}
+
+bool PhysicsCollection::load(const std::string& file)
+{
+	releaseUnbound();
+
+	Block block;
+	if (!open(file, block)) return false;
+
+	const char* in = block.memory;
+	const char* end = block.memory + block.size;
+	uint32_t version = 0, count = 0, offset = 0;
+	bool valid = block.size >= sizeof(MAGIC) && std::memcmp(in, MAGIC, sizeof(MAGIC)) == 0;
+	in += sizeof(MAGIC);
+	valid = valid && read(in, end, version) && version == VERSION && read(in, end, count) && read(in, end, offset);
+
+	std::vector<std::pair<std::string, physx::PxSerialObjectId>> keys;
+	keys.reserve(valid ? count : 0);
+	for (uint32_t i = 0; valid && i < count; ++i) {
+		uint32_t length = 0;
+		uint64_t id = 0;
+		valid = read(in, end, length) && (size_t)(end - in) >= length;
+		if (!valid) break;
+		std::string key(in, length);
+		in += length;
+		valid = read(in, end, id);
+		keys.push_back(std::make_pair(std::move(key), (physx::PxSerialObjectId)id));
+	}
+	valid = valid && offset % ALIGNMENT == 0 && offset <= block.size;
+
+	physx::PxCollection* collection = valid ? physx::PxSerialization::createCollectionFromBinary(block.memory + offset, *_registry) : nullptr;
+	if (collection == nullptr) {
+		close(block);
+		throw EPhysxEngine(file + " isn't a physics collection that can be loaded");
+	}
+	_blocks.push_back(block);
+
+	//The bodies that take the actors set their user data, until then they don't belong to anything
+	for (physx::PxU32 i = 0; i < collection->getNbObjects(); ++i) {
+		physx::PxRigidActor* actor = collection->getObject(i).is<physx::PxRigidActor>();
+		if (actor != nullptr) actor->userData = nullptr;
+	}
+	for (const auto& key : keys) {
+		physx::PxBase* object = collection->find(key.second);
+		physx::PxRigidActor* actor = object != nullptr ? object->is<physx::PxRigidActor>() : nullptr;
+		if (actor != nullptr) _unbound.insert(std::make_pair(key.first, actor));
+	}
+
+	PhysxEngine* engine = PhysxEngine::getPxInstance();
+	engine->write(nullptr, [engine, collection]() {
+		//One call lets physx insert every actor of the level into the broadphase at once
+		engine->getScene()->addCollection(*collection);
+
+		//The shapes and materials are kept by the actors that use them, so they are destroyed with the last one
+		for (physx::PxU32 i = 0; i < collection->getNbObjects(); ++i) {
+			physx::PxBase& object = collection->getObject(i);
+			if (object.is<physx::PxShape>() != nullptr) object.is<physx::PxShape>()->release();
+			else if (object.is<physx::PxMaterial>() != nullptr) object.is<physx::PxMaterial>()->release();
+		}
+		collection->release();
+	});
+	return true;
+}
+
+physx::PxRigidActor* PhysicsCollection::take(const std::string& key)
+{
+	//lower_bound gives the first of the equal keys, the one inserted first
+	auto it = _unbound.lower_bound(key);
+	if (it == _unbound.end() || it->first != key) return nullptr;
+
+	physx::PxRigidActor* actor = it->second;
+	_unbound.erase(it);
+	return actor;
+}
+
+void PhysicsCollection::releaseUnbound()
+{
+	for (auto& unbound : _unbound) {
+		physx::PxRigidActor* actor = unbound.second;
+		PhysxEngine::getPxInstance()->write(nullptr, [actor]() { actor->release(); });
+	}
+	_unbound.clear();
+}
+
+void PhysicsCollection::releaseUnused()
+{
+	if (_blocks.empty()) return;
+
+	physx::PxScene* scene = PhysxEngine::getPxInstance()->getScene();
+	physx::PxActorTypeFlags types = physx::PxActorTypeFlag::eRIGID_STATIC | physx::PxActorTypeFlag::eRIGID_DYNAMIC;
+	std::vector<physx::PxActor*> actors(scene->getNbActors(types));
+	scene->getActors(types, actors.data(), (physx::PxU32)actors.size());
+
+	//The objects of a collection live inside its memory, so the block is in use while an actor of the scene is in it
+	for (size_t i = _blocks.size(); i-- > 0;) {
+		const char* begin = _blocks[i].memory;
+		const char* end = begin + _blocks[i].size;
+		bool used = false;
+		for (size_t a = 0; a < actors.size() && !used; ++a) {
+			const char* actor = reinterpret_cast<const char*>(actors[a]);
+			used = actor >= begin && actor < end;
+		}
+		if (!used) {
+			close(_blocks[i]);
+			_blocks[i] = _blocks.back();
+			_blocks.pop_back();
+		}
+	}
+}
+
+bool PhysicsCollection::open(const std::string& file, Block& block) const
+{
+#ifdef _WIN32
+	//Copy on write: physx fixes the pointers of the objects in place, the pages it touches are copied and the file is never written
+	HANDLE handle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = GetFileSizeEx(handle, &size) && size.QuadPart > 0 ? CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+	//The mapping keeps the file open
+	CloseHandle(handle);
+	void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+	if (view == nullptr) {
+		if (mapping != nullptr) CloseHandle(mapping);
+		throw EPhysxEngine("The physics collection " + file + " can't be mapped");
+	}
+	//The views start at the allocation granularity, which is aligned enough for physx
+	block = { static_cast<char*>(view), (size_t)size.QuadPart, view, mapping };
+#else
+	std::ifstream in(file, std::ios::binary | std::ios::ate);
+	if (!in) return false;
+
+	size_t size = (size_t)in.tellg();
+	void* base = ::operator new(size + ALIGNMENT);
+	char* memory = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(base) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+	in.seekg(0);
+	if (!in.read(memory, size)) {
+		::operator delete(base);
+		throw EPhysxEngine("The physics collection " + file + " can't be read");
+	}
+	block = { memory, size, base, nullptr };
+#endif
+	return true;
+}
+
+void PhysicsCollection::close(Block& block) const
+{
+#ifdef _WIN32
+	UnmapViewOfFile(block.base);
+	CloseHandle(block.mapping);
+#else
+	::operator delete(block.base);
+#endif
+	block = { nullptr, 0, nullptr, nullptr };
+}
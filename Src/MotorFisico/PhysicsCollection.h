@@ -0,0 +1,108 @@
+#pragma once
+#ifndef PHYSICSCOLLECTION_H
+#define PHYSICSCOLLECTION_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+
+namespace physx {
+	class PxRigidActor;
+	class PxSerializationRegistry;
+}
+class CollisionBody;
+
+/*
+The actors of a level, with their shapes and materials, saved as a binary collection of physx.
+
+The file is made offline from a loaded level with save, and the next loads of the level take the actors from it
+instead of creating them one by one: load maps the file, physx builds every object in place in that memory and
+the actors go into the scene at once. Each actor is saved with a key, and the bodies of the level take their actor
+with that key when they are created. Those that nobody takes are released by releaseUnbound.
+
+The memory of a collection lives until none of its actors is in the scene. A collection made from an older version
+of the level still loads, so it has to be saved again every time the physics of the level change.
+*/
+class PhysicsCollection
+{
+public:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	PhysicsCollection();
+
+	/// <summary>
+	/// Frees the memory of the collections, their actors must have been released
+	/// </summary>
+	~PhysicsCollection();
+
+	PhysicsCollection& operator=(const PhysicsCollection&) = delete;
+	PhysicsCollection(PhysicsCollection& other) = delete;
+
+	/// <summary>
+	/// Writes the actors of the bodies, with their shapes and materials, to a binary collection
+	/// </summary>
+	/// <param name="bodies">Key of each body and the body, several bodies can have the same key</param>
+	/// <exception cref="EPhysxEngine">thrown when the collection can't be serialized or written</exception>
+	void save(const std::string& file, const std::vector<std::pair<std::string, CollisionBody*>>& bodies);
+
+	/// <summary>
+	/// Builds the objects of the collection of the file and adds its actors to the scene. The actors of a previous
+	/// load that nobody took are released
+	/// </summary>
+	/// <returns>False if there is no such file</returns>
+	/// <exception cref="EPhysxEngine">thrown when the file isn't a collection or physx can't read it</exception>
+	bool load(const std::string& file);
+
+	/// <summary>
+	/// Returns the next actor with the key, nullptr if there isn't any left.
+	/// The actors with the same key are given in the order they were saved
+	/// </summary>
+	physx::PxRigidActor* take(const std::string& key);
+
+	/// <summary>
+	/// Releases the actors of the last load that nobody took, called once the level has been created
+	/// </summary>
+	void releaseUnbound();
+
+	/// <summary>
+	/// Frees the memory of the collections that have no actor left in the scene
+	/// </summary>
+	void releaseUnused();
+
+	/// <summary>
+	/// Returns true if there are actors loaded waiting to be taken
+	/// </summary>
+	inline bool hasUnbound() const { return !_unbound.empty(); }
+
+private:
+	/// <summary>
+	/// Memory of a loaded collection, physx builds its objects inside it
+	/// </summary>
+	struct Block {
+		char* memory;
+		size_t size;
+		//Start of the mapping or the allocation, released with the block
+		void* base;
+		void* mapping;
+	};
+
+	/// <summary>
+	/// Maps the file copy on write, or reads it into an aligned buffer where it can't be mapped
+	/// </summary>
+	/// <returns>False if there is no such file</returns>
+	bool open(const std::string& file, Block& block) const;
+
+	/// <summary>
+	/// Unmaps or frees the memory of the block
+	/// </summary>
+	void close(Block& block) const;
+
+	physx::PxSerializationRegistry* _registry;
+	std::vector<Block> _blocks;
+	//Actors of the last load not taken yet, by key. Equal keys keep the order in which they were inserted
+	std::multimap<std::string, physx::PxRigidActor*> _unbound;
+};
+
+#endif // !PHYSICSCOLLECTION_H
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef PHYSICSCONFIG_H
+#define PHYSICSCONFIG_H
+
+#include <string>
+#include <vector>
+#include "MotorMath/Vec3.h"
+
+/*
+Settings of the physx scene. The defaults are the ones the engine always had.
+
+The best values depend on the scene: SAP is good for few bodies that move little, MBP splits a big world
+in regions so the bodies only meet the ones of their regions, and ABP is usually the fastest with many bodies
+that move a lot. TGS converges with fewer iterations than PGS, which helps tall stacks and joints.
+*/
+struct PhysicsConfig {
+	enum class BroadPhase : unsigned char {
+		SAP, MBP, ABP
+	};
+
+	enum class Solver : unsigned char {
+		PGS, TGS
+	};
+
+	/// <summary>
+	/// Pair of collision layers, by name
+	/// </summary>
+	struct LayerPair {
+		std::string layerA;
+		std::string layerB;
+	};
+
+	Vec3 gravity = Vec3(0.0f, -9.81f, 0.0f);
+
+	BroadPhase broadPhase = BroadPhase::SAP;
+	//Bounds of the world divided in subdivisions x subdivisions regions, only used by MBP
+	Vec3 worldMin = Vec3(-500.0f, -500.0f, -500.0f);
+	Vec3 worldMax = Vec3(500.0f, 500.0f, 500.0f);
+	unsigned int subdivisions = 4;
+
+	//Persistent contact manifolds, more stable contacts that are also cheaper to update
+	bool pcm = true;
+
+	Solver solver = Solver::PGS;
+	//Solver iterations of every dynamic body
+	unsigned int positionIterations = 4;
+	unsigned int velocityIterations = 1;
+
+	//Same results for the same inputs even when bodies are added or removed, at some cost.
+	//Needed by the rollback of PhysicsSnapshot, the resimulated steps match the original ones only with it
+	bool enhancedDeterminism = false;
+	//Continuous collision of the dynamic bodies, so the fast ones don't go through thin walls
+	bool ccd = false;
+	//Removes the jitter of piles of bodies at rest
+	bool stabilization = false;
+
+	//0 to run the simulation in the workers of the JobSystem, or the number of threads of its own the simulation uses
+	unsigned int threads = 0;
+
+	//Collision layers added after Default, in this order (CollisionLayers)
+	std::vector<std::string> layers;
+	//Pairs of the layer matrix that change its defaults: they don't collide, their contacts aren't reported,
+	//they are reported every step while touching, or the reports have contact points
+	std::vector<LayerPair> ignoredCollisions;
+	std::vector<LayerPair> ignoredNotifications;
+	std::vector<LayerPair> persistentNotifications;
+	std::vector<LayerPair> contactPoints;
+};
+
+#endif // !PHYSICSCONFIG_H
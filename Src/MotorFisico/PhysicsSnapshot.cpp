@@ -0,0 +1,14 @@
+#include "PhysicsSnapshot.h"
+#include <algorithm>
+
+PhysicsSnapshot::PhysicsSnapshot(size_t capacity) : _bodies()
+{
+	_bodies.reserve(capacity);
+}
+
+const PhysicsSnapshot::BodyState* PhysicsSnapshot::find(unsigned long long serial) const
+{
+	auto it = std::lower_bound(_bodies.begin(), _bodies.end(), serial,
+		[](const BodyState& state, unsigned long long serial) { return state.serial < serial; });
+	return it != _bodies.end() && it->serial == serial ? &(*it) : nullptr;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef PHYSICSSNAPSHOT_H
+#define PHYSICSSNAPSHOT_H
+
+#include "MotorMath/Vec3.h"
+#include "MotorMath/Quat.h"
+#include <vector>
+
+/*
+State of every dynamic actor of the scene at one moment, taken by PhysxEngine::captureSnapshot and put back by
+PhysxEngine::restoreSnapshot. Meant for rollback: keep a ring of snapshots, one per step, and reuse them, the memory
+is reserved once and capture doesn't allocate while the number of actors fits.
+
+The states are matched to the bodies by CollisionBody::getSerial, physx reuses the memory of released actors so a body
+created after the capture is never given the state of a destroyed one: it's not touched by the restore, and the state
+of the destroyed one is ignored.
+The contact caches of physx are not part of the snapshot, so a resimulation only gives the same results as the
+original steps with PhysicsConfig::enhancedDeterminism
+*/
+class PhysicsSnapshot
+{
+public:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	/// <param name="capacity">Number of actors the memory is reserved for</param>
+	PhysicsSnapshot(size_t capacity = 256);
+
+	/// <summary>
+	/// Number of actors in the snapshot
+	/// </summary>
+	inline size_t size() const { return _bodies.size(); }
+
+	/// <summary>
+	/// Removes the states, keeping the memory
+	/// </summary>
+	inline void clear() { _bodies.clear(); }
+
+private:
+	friend class PhysxEngine;
+
+	struct BodyState {
+		unsigned long long serial;
+		Vec3 position;
+		Quat orientation;
+		Vec3 linearVelocity;
+		Vec3 angularVelocity;
+		float wakeCounter;
+		bool sleeping;
+	};
+
+	/// <summary>
+	/// Returns the state of the body with that serial, nullptr if it wasn't captured. The states are sorted by serial
+	/// </summary>
+	const BodyState* find(unsigned long long serial) const;
+
+	std::vector<BodyState> _bodies;
+};
+
+#endif // !PHYSICSSNAPSHOT_H
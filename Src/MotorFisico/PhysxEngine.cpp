@@ -3,21 +3,37 @@
 #include "extensions/PxDefaultSimulationFilterShader.h"
 #include "Exceptions.h"
 #include "Callbacks.h"
+#include "CollisionLayers.h"
+#include "CollisionBody.h"
+#include "TaskDispatcher.h"
+#include "PhysicsCache.h"
+#include "PhysicsSnapshot.h"
+#include "PhysicsCollection.h"
+#include "MeshCooker.h"
 #include "pvd/PxPvdTransport.h"
+#include "MotorMath/PhysxMath.h"
+
+#include <algorithm>
 
 #define PVD_HOST "127.0.0.1"
 
 PhysxEngine* PhysxEngine::_instance = nullptr;
 
-PhysxEngine::PhysxEngine() : _mFoundation(nullptr), _mPhysics(nullptr), _mPvd(nullptr), /*_mCooking(nullptr),*/ _mMaterial(nullptr),
-	_scene(nullptr), alreadyInitialized(false), _callback(new ContactReportCallback()), _gDefaultAllocatorCallback(new physx::PxDefaultAllocator()),
-	_gDefaultErrorCallback(new physx::PxDefaultErrorCallback()), _gDispatcher(nullptr)
+PhysxEngine::PhysxEngine() : _mFoundation(nullptr), _mPhysics(nullptr), _mPvd(nullptr), _mCooking(nullptr), _mMaterial(nullptr),
+	_scene(nullptr), alreadyInitialized(false), _callback(new ContactReportCallback(&_contactEvents)), _contactEvents(256, 1024), _gDefaultAllocatorCallback(new physx::PxDefaultAllocator()),
+	_gDefaultErrorCallback(new physx::PxDefaultErrorCallback()), _gDispatcher(nullptr), _cache(nullptr), _collection(nullptr), _meshCooker(nullptr), _config(), _submit(), _workerCount(0), _simulating(false), _writesMutex(), _deferredWrites(), _pendingActors(), _activeBodies(), _snapshotActors()
 {
 }
 
 PhysxEngine::~PhysxEngine()
 {
-	_scene->release();
+	fetchResults();
+	releaseScene();
+	//The objects of the collections live in their memory, it's freed once the scene has released them
+	delete _collection; _collection = nullptr;
+	delete _cache; _cache = nullptr;
+	delete _meshCooker; _meshCooker = nullptr;
+	_mCooking->release();
 	_mPhysics->release();
 	
 	physx::PxPvdTransport* transport = _mPvd->getTransport();
@@ -43,9 +59,12 @@ PhysxEngine* PhysxEngine::getPxInstance()
 	return _instance;
 }
 
-bool PhysxEngine::init()
+bool PhysxEngine::init(const TaskSubmitFunction& submit, unsigned int workerCount, const PhysicsConfig& config)
 {
 	if (alreadyInitialized) return false;
+	_config = config;
+	_submit = submit;
+	_workerCount = workerCount;
 
 	_mFoundation = PxCreateFoundation(PX_PHYSICS_VERSION, *_gDefaultAllocatorCallback, *_gDefaultErrorCallback);
 	if (!_mFoundation)
@@ -59,31 +78,285 @@ bool PhysxEngine::init()
 	if (!_mPhysics)
 		throw EPhysxEngine("PxCreatePhysics failed!");
 
-	//_mCooking = PxCreateCooking(PX_PHYSICS_VERSION, *_mFoundation, physx::PxCookingParams(_mPhysics->getTolerancesScale()));
-	//if (!_mCooking)
-	//	throw EPhysxEngine("PxCreateCooking failed!");
+	_mCooking = PxCreateCooking(PX_PHYSICS_VERSION, *_mFoundation, physx::PxCookingParams(_mPhysics->getTolerancesScale()));
+	if (!_mCooking)
+		throw EPhysxEngine("PxCreateCooking failed!");
 
 	_mMaterial = _mPhysics->createMaterial(0.5f, 0.5f, 0.6f);
+	_cache = new PhysicsCache(_mPhysics);
+	_collection = new PhysicsCollection();
+	_meshCooker = new MeshCooker(_mPhysics, _mCooking, "Assets/PhysicsCache/");
+
+	//The shapes take the rows of their layers when they are created, before the scene is loaded
+	CollisionLayers::getInstance()->load(_config);
+	createScene();
+
+	alreadyInitialized = true;
+	return true;
+}
+
+void PhysxEngine::setConfig(const PhysicsConfig& config)
+{
+	fetchResults();
+	if (!_pendingActors.empty() || _scene->getNbActors(physx::PxActorTypeFlag::eRIGID_STATIC | physx::PxActorTypeFlag::eRIGID_DYNAMIC) > 0)
+		throw EPhysxEngine("The physics config can't change while the scene has actors");
+
+	CollisionLayers::getInstance()->load(config);
+	releaseScene();
+	_config = config;
+	createScene();
+}
+
+void PhysxEngine::createScene()
+{
+	//The JobSystem is used unless the config asks for a number of threads, then the simulation gets its own ones
+	unsigned int threads = _config.threads;
+	if (threads > 0)
+		_gDispatcher = physx::PxDefaultCpuDispatcherCreate(threads);
+	else if (_submit)
+		_gDispatcher = new TaskDispatcher(_submit, _workerCount);
+	else
+		_gDispatcher = physx::PxDefaultCpuDispatcherCreate(2);
 
 	physx::PxSceneDesc sceneDesc(_mPhysics->getTolerancesScale());
-	sceneDesc.gravity = physx::PxVec3(0.0f, -9.81f, 0.0f);
-	_gDispatcher = physx::PxDefaultCpuDispatcherCreate(2);
+	sceneDesc.gravity = toPx(_config.gravity);
 	sceneDesc.cpuDispatcher = _gDispatcher;
 	sceneDesc.filterShader = contactReportFilterShader;
+	//The scene keeps a copy of the layers that report every step, the shapes already have the rest of the matrix
+	sceneDesc.filterShaderData = CollisionLayers::getInstance()->getPersistentMasks();
+	sceneDesc.filterShaderDataSize = sizeof(physx::PxU32) * CollisionLayers::MAX_LAYERS;
 	sceneDesc.simulationEventCallback = _callback;
+	//Only the actors that moved are read back after every step, the sleeping ones are skipped
+	sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS;
+
+	switch (_config.broadPhase)
+	{
+	case PhysicsConfig::BroadPhase::MBP:
+		sceneDesc.broadPhaseType = physx::PxBroadPhaseType::eMBP;
+		break;
+	case PhysicsConfig::BroadPhase::ABP:
+		sceneDesc.broadPhaseType = physx::PxBroadPhaseType::eABP;
+		break;
+	default:
+		sceneDesc.broadPhaseType = physx::PxBroadPhaseType::eSAP;
+		break;
+	}
+	sceneDesc.solverType = _config.solver == PhysicsConfig::Solver::TGS ? physx::PxSolverType::eTGS : physx::PxSolverType::ePGS;
+
+	if (_config.pcm) sceneDesc.flags |= physx::PxSceneFlag::eENABLE_PCM;
+	else sceneDesc.flags.clear(physx::PxSceneFlag::eENABLE_PCM);
+	if (_config.enhancedDeterminism) sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+	if (_config.ccd) sceneDesc.flags |= physx::PxSceneFlag::eENABLE_CCD;
+	if (_config.stabilization) sceneDesc.flags |= physx::PxSceneFlag::eENABLE_STABILIZATION;
 
 	_scene = _mPhysics->createScene(sceneDesc);
 	if (!_scene)
 		throw EPhysxEngine("PxSceneDesc failed!");
 
-	alreadyInitialized = true;
-	return true;
+	//MBP only finds pairs inside its regions, they are a grid over the ground of the world
+	if (_config.broadPhase == PhysicsConfig::BroadPhase::MBP) {
+		physx::PxU32 subdivisions = std::max(1u, std::min(_config.subdivisions, 16u));
+		std::vector<physx::PxBounds3> regions(subdivisions * subdivisions);
+		physx::PxU32 count = physx::PxBroadPhaseExt::createRegionsFromWorldBounds(regions.data(),
+			physx::PxBounds3(toPx(_config.worldMin), toPx(_config.worldMax)), subdivisions);
+		for (physx::PxU32 i = 0; i < count; ++i) {
+			physx::PxBroadPhaseRegion region;
+			region.bounds = regions[i];
+			region.userData = nullptr;
+			_scene->addBroadPhaseRegion(region);
+		}
+	}
+}
+
+void PhysxEngine::releaseScene()
+{
+	if (_scene != nullptr) _scene->release();
+	_scene = nullptr;
+
+	if (dynamic_cast<TaskDispatcher*>(_gDispatcher) != nullptr)
+		delete _gDispatcher;
+	else if (_gDispatcher != nullptr)
+		static_cast<physx::PxDefaultCpuDispatcher*>(_gDispatcher)->release();
+	_gDispatcher = nullptr;
+}
+
+void PhysxEngine::clearShapeCache()
+{
+	write(nullptr, [this]() {
+		_cache->clearShapes();
+		//The meshes go after the shapes that use them, they are read again from the cooked files if needed
+		_meshCooker->clear();
+	});
 }
 
 void PhysxEngine::update(float time)
 {
-	if (time <= 0.0001f)
+	simulate(time);
+	fetchResults(true);
+}
+
+void PhysxEngine::simulate(float time)
+{
+	if (time <= 0.0001f || _simulating)
 		return;
+	flushActors();
 	_scene->simulate(physx::PxReal(time));
-	_scene->fetchResults(true);
+	_simulating = true;
+}
+
+bool PhysxEngine::fetchResults(bool block)
+{
+	if (!_simulating) return true;
+
+	if (!_scene->fetchResults(block))
+		return false;
+
+	_callback->addTriggerStays();
+	collectActiveBodies();
+	flushWrites();
+	flushActors();
+	syncActiveBodies();
+	return true;
+}
+
+void PhysxEngine::dispatchContactEvents()
+{
+	_contactEvents.dispatch();
+}
+
+void PhysxEngine::write(const void* owner, const std::function<void()>& write)
+{
+	if (_simulating) {
+		std::lock_guard<std::mutex> lock(_writesMutex);
+		//Checked again in case fetchResults has already flushed the queue
+		if (_simulating) {
+			_deferredWrites.push_back(std::make_pair(owner, write));
+			return;
+		}
+	}
+	write();
+}
+
+void PhysxEngine::cancelWrites(const void* owner)
+{
+	std::lock_guard<std::mutex> lock(_writesMutex);
+	auto it = _deferredWrites.begin();
+	while (it != _deferredWrites.end()) {
+		if (it->first == owner) it = _deferredWrites.erase(it);
+		else ++it;
+	}
+}
+
+void PhysxEngine::addActor(physx::PxActor* actor)
+{
+	std::lock_guard<std::mutex> lock(_writesMutex);
+	_pendingActors.push_back(actor);
+}
+
+void PhysxEngine::cancelActor(physx::PxActor* actor)
+{
+	std::lock_guard<std::mutex> lock(_writesMutex);
+	auto it = std::find(_pendingActors.begin(), _pendingActors.end(), actor);
+	if (it != _pendingActors.end()) {
+		*it = _pendingActors.back();
+		_pendingActors.pop_back();
+	}
+}
+
+void PhysxEngine::flushActors()
+{
+	std::lock_guard<std::mutex> lock(_writesMutex);
+	if (_simulating || _pendingActors.empty()) return;
+
+	//One call lets physx insert the whole batch into the broadphase at once
+	_scene->addActors(_pendingActors.data(), (physx::PxU32)_pendingActors.size());
+	_pendingActors.clear();
+}
+
+void PhysxEngine::flushWrites()
+{
+	std::vector<std::pair<const void*, std::function<void()>>> writes;
+	{
+		std::lock_guard<std::mutex> lock(_writesMutex);
+		_simulating = false;
+		writes.swap(_deferredWrites);
+	}
+
+	for (auto& write : writes)
+		write.second();
+}
+
+void PhysxEngine::captureSnapshot(PhysicsSnapshot& snapshot)
+{
+	fetchResults();
+	snapshot.clear();
+
+	_snapshotActors.resize(_scene->getNbActors(physx::PxActorTypeFlag::eRIGID_DYNAMIC));
+	physx::PxU32 count = _scene->getActors(physx::PxActorTypeFlag::eRIGID_DYNAMIC, _snapshotActors.data(), (physx::PxU32)_snapshotActors.size());
+	for (physx::PxU32 i = 0; i < count; ++i) {
+		physx::PxRigidDynamic* actor = static_cast<physx::PxRigidDynamic*>(_snapshotActors[i]);
+		//Bodies destroyed during the simulation have no userData, their actors are about to be released
+		CollisionBody* body = static_cast<CollisionBody*>(actor->userData);
+		if (body == nullptr) continue;
+
+		physx::PxTransform pose = actor->getGlobalPose();
+		//The velocities of a kinematic actor come from its target, only its pose is kept
+		bool kinematic = actor->getRigidBodyFlags().isSet(physx::PxRigidBodyFlag::eKINEMATIC);
+		snapshot._bodies.push_back({ body->getSerial(), fromPx(pose.p), fromPx(pose.q),
+			kinematic ? Vec3() : fromPx(actor->getLinearVelocity()), kinematic ? Vec3() : fromPx(actor->getAngularVelocity()),
+			kinematic ? 0.0f : actor->getWakeCounter(), kinematic || actor->isSleeping() });
+	}
+
+	std::sort(snapshot._bodies.begin(), snapshot._bodies.end(),
+		[](const PhysicsSnapshot::BodyState& a, const PhysicsSnapshot::BodyState& b) { return a.serial < b.serial; });
+}
+
+void PhysxEngine::restoreSnapshot(const PhysicsSnapshot& snapshot)
+{
+	fetchResults();
+
+	_snapshotActors.resize(_scene->getNbActors(physx::PxActorTypeFlag::eRIGID_DYNAMIC));
+	physx::PxU32 count = _scene->getActors(physx::PxActorTypeFlag::eRIGID_DYNAMIC, _snapshotActors.data(), (physx::PxU32)_snapshotActors.size());
+	for (physx::PxU32 i = 0; i < count; ++i) {
+		physx::PxRigidDynamic* actor = static_cast<physx::PxRigidDynamic*>(_snapshotActors[i]);
+		CollisionBody* body = static_cast<CollisionBody*>(actor->userData);
+		if (body == nullptr) continue;
+		const PhysicsSnapshot::BodyState* state = snapshot.find(body->getSerial());
+		if (state == nullptr) continue;
+
+		actor->setGlobalPose(physx::PxTransform(toPx(state->position), toPx(state->orientation)), false);
+		if (actor->getRigidBodyFlags().isSet(physx::PxRigidBodyFlag::eKINEMATIC))
+			continue;
+
+		if (state->sleeping)
+			actor->putToSleep();
+		else {
+			actor->setLinearVelocity(toPx(state->linearVelocity), false);
+			actor->setAngularVelocity(toPx(state->angularVelocity), false);
+			actor->setWakeCounter(state->wakeCounter);
+		}
+	}
+}
+
+void PhysxEngine::collectActiveBodies()
+{
+	_activeBodies.clear();
+
+	physx::PxU32 count = 0;
+	physx::PxActor** actors = _scene->getActiveActors(count);
+	_activeBodies.reserve(count);
+	for (physx::PxU32 i = 0; i < count; ++i) {
+		//Bodies destroyed during the simulation have no userData, and their actors are released by the writes
+		CollisionBody* body = static_cast<CollisionBody*>(actors[i]->userData);
+		if (body != nullptr)
+			_activeBodies.push_back(body);
+	}
+}
+
+void PhysxEngine::syncActiveBodies()
+{
+	//Read after the writes, so a pose set during the simulation isn't overwritten
+	for (CollisionBody* body : _activeBodies)
+		body->syncPose();
+	_activeBodies.clear();
 }
\ No newline at end of file
@@ -3,6 +3,12 @@
 #define PHYSXENGINE_H
 
 #include <memory>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include "ContactEvents.h"
+#include "PhysicsConfig.h"
 
 namespace physx {
 	class PxFoundation;
@@ -13,10 +19,21 @@ namespace physx {
 	class PxMaterial;
 	class PxDefaultAllocator;
 	class PxDefaultErrorCallback;
-	class PxDefaultCpuDispatcher;
+	class PxCpuDispatcher;
+	class PxActor;
 };
 
 class ContactReportCallback;
+class PhysicsCache;
+class PhysicsSnapshot;
+class PhysicsCollection;
+class MeshCooker;
+class CollisionBody;
+
+/// <summary>
+/// Function that runs the given task in a thread pool
+/// </summary>
+using TaskSubmitFunction = std::function<void(std::function<void()>)>;
 
 /// <summary>
 /// Class that implememnts control of physx engine
@@ -42,14 +59,100 @@ public:
 	/// <summary>
 	/// Initializes physx engine
 	/// </summary>
-	bool init();
+	/// <param name="submit">Function to run the physx tasks in the thread pool of the engine, if it's empty physx creates its own threads</param>
+	/// <param name="workerCount">Number of threads of the thread pool</param>
+	/// <param name="config">Settings of the scene</param>
+	bool init(const TaskSubmitFunction& submit = nullptr, unsigned int workerCount = 0, const PhysicsConfig& config = PhysicsConfig());
+
+	/// <summary>
+	/// Creates the scene again with other settings. The scene must have no actors, so it's done between two scenes of the game
+	/// </summary>
+	/// <exception cref="EPhysxEngine">thrown when the scene has actors or the collision layers of the config are wrong</exception>
+	void setConfig(const PhysicsConfig& config);
 
 	/// <summary>
-	/// Calls physx simulation step
+	/// Returns the settings of the scene, the new dynamic bodies take their solver iterations and ccd from them
+	/// </summary>
+	inline const PhysicsConfig& getConfig() const { return _config; }
+
+	/// <summary>
+	/// Calls physx simulation step and waits for its results
 	/// </summary>
 	/// <param name="time">Time in seconds</param>
 	void update(float time);
 
+	/// <summary>
+	/// Starts a simulation step without waiting for it, the actors keep the previous results until fetchResults is called
+	/// </summary>
+	/// <param name="time">Time in seconds</param>
+	void simulate(float time);
+
+	/// <summary>
+	/// Finishes the simulation step started by simulate and applies the writes queued meanwhile.
+	/// Then the bodies that moved in the step send their pose to their pose callback.
+	/// The contact and trigger events of the step are kept until dispatchContactEvents
+	/// </summary>
+	/// <param name="block">True to wait until the simulation finishes</param>
+	/// <returns>False if block is false and the simulation hasn't finished yet</returns>
+	bool fetchResults(bool block = true);
+
+	/// <summary>
+	/// Calls the contact callbacks of the bodies with the events of the steps fetched since the last call, in the order they happened
+	/// </summary>
+	void dispatchContactEvents();
+
+	/// <summary>
+	/// Sets the function that gives the handles of the GameObjects in the contact events
+	/// </summary>
+	inline void setHandleFunction(HandleFunction* function) { _contactEvents.setHandleFunction(function); }
+
+	/// <summary>
+	/// Returns true between simulate and fetchResults
+	/// </summary>
+	inline bool isSimulating() const { return _simulating; }
+
+	/// <summary>
+	/// Applies a change to the physx actors. If the scene is simulating, it is queued until fetchResults
+	/// <para> It can be called from any thread </para>
+	/// </summary>
+	/// <param name="owner">Object that queues the write, used to cancel it</param>
+	/// <param name="write">Function that does the change</param>
+	void write(const void* owner, const std::function<void()>& write);
+
+	/// <summary>
+	/// Removes the queued writes of the owner, called when it is destroyed
+	/// </summary>
+	/// <param name="owner">Object that queued the writes</param>
+	void cancelWrites(const void* owner);
+
+	/// <summary>
+	/// Queues an actor to be added to the scene with the other queued ones, in a single call.
+	/// Used for the static actors, which are created in large numbers when a scene is loaded
+	/// </summary>
+	void addActor(physx::PxActor* actor);
+
+	/// <summary>
+	/// Removes the actor from the queue of addActor, called when it is destroyed
+	/// </summary>
+	void cancelActor(physx::PxActor* actor);
+
+	/// <summary>
+	/// Adds the actors queued by addActor to the scene. It's done before every simulation step too,
+	/// and it does nothing while the scene is simulating
+	/// </summary>
+	void flushActors();
+
+	/// <summary>
+	/// Copies the pose, velocities and sleep state of every dynamic actor to the snapshot, waiting for the simulation if it's running
+	/// </summary>
+	void captureSnapshot(PhysicsSnapshot& snapshot);
+
+	/// <summary>
+	/// Puts the dynamic actors back in the state of the snapshot, waiting for the simulation if it's running.
+	/// The bodies don't send their pose to their owners, they have their own snapshot
+	/// </summary>
+	void restoreSnapshot(const PhysicsSnapshot& snapshot);
+
 	/// <summary>
 	/// Returns a pointer to the physx scene
 	/// </summary>
@@ -57,6 +160,26 @@ public:
 	inline physx::PxScene* getScene() const { return _scene; }
 	inline physx::PxPhysics* getPhysics() const { return _mPhysics; }
 
+	/// <summary>
+	/// Returns the materials and shapes shared by the bodies
+	/// </summary>
+	inline PhysicsCache* getCache() const { return _cache; }
+
+	/// <summary>
+	/// Returns the actors loaded from the binary collection of the level, see PhysicsCollection
+	/// </summary>
+	inline PhysicsCollection* getCollection() const { return _collection; }
+
+	/// <summary>
+	/// Returns the cooker of the triangle and convex meshes of the colliders
+	/// </summary>
+	inline MeshCooker* getMeshCooker() const { return _meshCooker; }
+
+	/// <summary>
+	/// Releases the shared shapes and the meshes that no body uses anymore, called after a scene is unloaded
+	/// </summary>
+	void clearShapeCache();
+
 private:
 
 	/// <summary>
@@ -85,9 +208,9 @@ private:
 	physx::PxPhysics* _mPhysics;
 
 	/// <summary>
-	/// Cooking object for extra physx utilities
+	/// Cooking object for the triangle and convex meshes
 	/// </summary>
-	//physx::PxCooking* _mCooking;
+	physx::PxCooking* _mCooking;
 
 	/// <summary>
 	/// PxMaterial for friction
@@ -102,9 +225,51 @@ private:
 	physx::PxDefaultAllocator* _gDefaultAllocatorCallback;
 	physx::PxDefaultErrorCallback* _gDefaultErrorCallback;
 	ContactReportCallback* _callback;
-	physx::PxDefaultCpuDispatcher* _gDispatcher;
+	ContactEventBuffer _contactEvents;
+	physx::PxCpuDispatcher* _gDispatcher;
+	PhysicsCache* _cache;
+	PhysicsCollection* _collection;
+	MeshCooker* _meshCooker;
 
 	bool alreadyInitialized;
+
+	PhysicsConfig _config;
+	TaskSubmitFunction _submit;
+	unsigned int _workerCount;
+
+	/// <summary>
+	/// Creates the cpu dispatcher and the scene with the settings of _config
+	/// </summary>
+	void createScene();
+
+	/// <summary>
+	/// Releases the scene and its cpu dispatcher
+	/// </summary>
+	void releaseScene();
+
+	/// <summary>
+	/// Ends the simulating state and executes the writes queued meanwhile
+	/// </summary>
+	void flushWrites();
+
+	/// <summary>
+	/// Takes the bodies of the actors that moved in the last step, before the writes can release any of them
+	/// </summary>
+	void collectActiveBodies();
+
+	/// <summary>
+	/// Sends the pose of the bodies collected by collectActiveBodies to their owners
+	/// </summary>
+	void syncActiveBodies();
+
+	std::atomic<bool> _simulating;
+	std::mutex _writesMutex;
+	std::vector<std::pair<const void*, std::function<void()>>> _deferredWrites;
+	std::vector<physx::PxActor*> _pendingActors;
+	//Bodies of the active actors of the last step, kept to reuse its memory
+	std::vector<CollisionBody*> _activeBodies;
+	//Dynamic actors of the scene read by the snapshots, kept to reuse its memory
+	std::vector<physx::PxActor*> _snapshotActors;
 };
 
 #endif PHYSXENGINE_H
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include "QueryBatch.h"
+#include "PxPhysicsAPI.h"
+#include "PhysxEngine.h"
+#include "CollisionBody.h"
+#include "Exceptions.h"
+#include "MotorMath/PhysxMath.h"
+#include <algorithm>
+
+namespace {
+	//Touches received from physx at once, more of them need another processTouches call
+	const physx::PxU32 TOUCH_BUFFER = 32;
+
+	GameObject* ownerOf(const physx::PxRigidActor* actor)
+	{
+		//Bodies destroyed during the simulation have no userData
+		CollisionBody* body = static_cast<CollisionBody*>(actor->userData);
+		return body != nullptr ? body->getGameObject() : nullptr;
+	}
+
+	PxQueryBatch::Hit toHit(const physx::PxLocationHit& hit)
+	{
+		return { ownerOf(hit.actor), fromPx(hit.position), fromPx(hit.normal), hit.distance };
+	}
+
+	PxQueryBatch::Hit toHit(const physx::PxOverlapHit& hit)
+	{
+		return { ownerOf(hit.actor), Vec3(), Vec3(), 0.0f };
+	}
+
+	/// <summary>
+	/// Writes the hits of a query straight into its part of the hit buffer, keeping the closest ones when there are more than it fits
+	/// </summary>
+	template<typename HitType>
+	struct HitCollector : public physx::PxHitCallback<HitType> {
+		HitType buffer[TOUCH_BUFFER];
+		PxQueryBatch::Hit* hits;
+		unsigned int capacity;
+		unsigned int count;
+
+		//Without touches physx only reports the closest blocking hit
+		HitCollector(PxQueryBatch::Hit* hits, unsigned int capacity, bool touches) :
+			physx::PxHitCallback<HitType>(touches ? buffer : nullptr, touches ? TOUCH_BUFFER : 0), hits(hits), capacity(capacity), count(0) {}
+
+		physx::PxAgain processTouches(const HitType* touches, physx::PxU32 nbHits) override
+		{
+			for (physx::PxU32 i = 0; i < nbHits; ++i)
+				keep(toHit(touches[i]));
+			return true;
+		}
+
+		void keep(const PxQueryBatch::Hit& hit)
+		{
+			if (hit.gameObject == nullptr) return;
+			if (count < capacity) {
+				hits[count++] = hit;
+				return;
+			}
+			PxQueryBatch::Hit* farthest = std::max_element(hits, hits + count,
+				[](const PxQueryBatch::Hit& a, const PxQueryBatch::Hit& b) { return a.distance < b.distance; });
+			if (hit.distance < farthest->distance) *farthest = hit;
+		}
+
+		unsigned int finish()
+		{
+			if (this->hasBlock) keep(toHit(this->block));
+			std::sort(hits, hits + count, [](const PxQueryBatch::Hit& a, const PxQueryBatch::Hit& b) { return a.distance < b.distance; });
+			return count;
+		}
+	};
+
+	physx::PxQueryFlags queryFlags(PxRayCast::Type collidesWith)
+	{
+		switch (collidesWith)
+		{
+		case PxRayCast::Type::Static:
+			return physx::PxQueryFlag::eSTATIC;
+		case PxRayCast::Type::Dynamic:
+			return physx::PxQueryFlag::eDYNAMIC;
+		default:
+			return physx::PxQueryFlag::eSTATIC | physx::PxQueryFlag::eDYNAMIC;
+		}
+	}
+}
+
+PxQueryBatch::PxQueryBatch(size_t queryCapacity, size_t hitCapacity) : _queries(), _hits()
+{
+	_queries.reserve(queryCapacity);
+	_hits.reserve(hitCapacity);
+}
+
+size_t PxQueryBatch::addRaycast(const Vec3& origin, const Vec3& direction, float distance, uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	return add(Kind::Raycast, Shape::Ray, origin, Quat(), Vec3(), direction, distance, layers, maxHits, collidesWith);
+}
+
+size_t PxQueryBatch::addSphereSweep(const Vec3& center, float radius, const Vec3& direction, float distance, uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	return add(Kind::Sweep, Shape::Sphere, center, Quat(), Vec3(radius, 0, 0), direction, distance, layers, maxHits, collidesWith);
+}
+
+size_t PxQueryBatch::addBoxSweep(const Vec3& center, const Vec3& halfExtents, const Quat& orientation, const Vec3& direction, float distance,
+	uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	return add(Kind::Sweep, Shape::Box, center, orientation, halfExtents, direction, distance, layers, maxHits, collidesWith);
+}
+
+size_t PxQueryBatch::addCapsuleSweep(const Vec3& center, float radius, float halfHeight, const Quat& orientation, const Vec3& direction, float distance,
+	uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	return add(Kind::Sweep, Shape::Capsule, center, orientation, Vec3(radius, halfHeight, 0), direction, distance, layers, maxHits, collidesWith);
+}
+
+size_t PxQueryBatch::addSphereOverlap(const Vec3& center, float radius, uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	return add(Kind::Overlap, Shape::Sphere, center, Quat(), Vec3(radius, 0, 0), Vec3(), 0, layers, maxHits, collidesWith);
+}
+
+size_t PxQueryBatch::addBoxOverlap(const Vec3& center, const Vec3& halfExtents, const Quat& orientation, uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	return add(Kind::Overlap, Shape::Box, center, orientation, halfExtents, Vec3(), 0, layers, maxHits, collidesWith);
+}
+
+size_t PxQueryBatch::addCapsuleOverlap(const Vec3& center, float radius, float halfHeight, const Quat& orientation, uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	return add(Kind::Overlap, Shape::Capsule, center, orientation, Vec3(radius, halfHeight, 0), Vec3(), 0, layers, maxHits, collidesWith);
+}
+
+size_t PxQueryBatch::add(Kind kind, Shape shape, const Vec3& position, const Quat& orientation, const Vec3& size, const Vec3& direction, float distance,
+	uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith)
+{
+	if (maxHits == 0)
+		throw ERayCast("A query needs room for one hit at least");
+	if (kind != Kind::Overlap) {
+		if (distance <= 0)
+			throw ERayCast("RayCast distance cannot negative or zero");
+		if (toPx(direction).isZero())
+			throw ERayCast("RayCast direction vector cannot be zero");
+	}
+
+	Query query = { kind, shape, collidesWith, layers, position, orientation, size,
+		kind != Kind::Overlap ? fromPx(toPx(direction).getNormalized()) : Vec3(), distance, maxHits, (unsigned int)_hits.size(), 0 };
+	_queries.push_back(query);
+	_hits.resize(_hits.size() + maxHits);
+	return _queries.size() - 1;
+}
+
+void PxQueryBatch::execute(const ParallelForFunction& parallelFor)
+{
+	if (parallelFor && _queries.size() > GRAIN)
+		parallelFor(_queries.size(), GRAIN, [this](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) run(_queries[i]);
+		});
+	else
+		for (Query& query : _queries) run(query);
+}
+
+void PxQueryBatch::clear()
+{
+	_queries.clear();
+	_hits.clear();
+}
+
+void PxQueryBatch::run(Query& query)
+{
+	//The filter data of physx would be all zeroes, and then it doesn't filter at all
+	if (query.layers == 0) {
+		query.hitCount = 0;
+		return;
+	}
+
+	physx::PxScene* scene = PhysxEngine::getPxInstance()->getScene();
+	Hit* hits = _hits.data() + query.firstHit;
+
+	//The query filter data of the shapes has the bit of their layer in word0 (CollisionLayers.h)
+	physx::PxQueryFilterData filter(physx::PxFilterData(query.layers, 0, 0, 0), queryFlags(query.collidesWith));
+	bool touches = query.kind == Kind::Overlap || query.maxHits > 1;
+	if (touches) filter.flags |= physx::PxQueryFlag::eNO_BLOCK;
+
+	if (query.kind == Kind::Raycast) {
+		HitCollector<physx::PxRaycastHit> collector(hits, query.maxHits, touches);
+		scene->raycast(toPx(query.position), toPx(query.direction), query.distance, collector, physx::PxHitFlag::eDEFAULT, filter);
+		query.hitCount = collector.finish();
+		return;
+	}
+
+	physx::PxGeometryHolder geometry;
+	switch (query.shape)
+	{
+	case Shape::Box:
+		geometry.storeAny(physx::PxBoxGeometry(toPx(query.size)));
+		break;
+	case Shape::Capsule:
+		geometry.storeAny(physx::PxCapsuleGeometry(query.size.x, query.size.y));
+		break;
+	default:
+		geometry.storeAny(physx::PxSphereGeometry(query.size.x));
+		break;
+	}
+	physx::PxTransform pose(toPx(query.position), toPx(query.orientation));
+
+	if (query.kind == Kind::Sweep) {
+		HitCollector<physx::PxSweepHit> collector(hits, query.maxHits, touches);
+		scene->sweep(geometry.any(), pose, toPx(query.direction), query.distance, collector, physx::PxHitFlag::eDEFAULT, filter);
+		query.hitCount = collector.finish();
+	}
+	else {
+		HitCollector<physx::PxOverlapHit> collector(hits, query.maxHits, touches);
+		scene->overlap(geometry.any(), pose, collector, filter);
+		query.hitCount = collector.finish();
+	}
+}
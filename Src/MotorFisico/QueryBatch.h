@@ -0,0 +1,184 @@
+#pragma once
+
+#ifndef PXQUERYBATCH_H
+#define PXQUERYBATCH_H
+
+#include "MotorMath/Vec3.h"
+#include "MotorMath/Quat.h"
+#include "RayCast.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+class GameObject;
+
+/*
+Raycasts, sweeps and overlaps against the physx scene, added to the batch and run together by execute.
+
+The queries and their hits are stored in buffers that keep their memory between frames, so a batch
+that is cleared and refilled every frame doesn't allocate once it has grown to its usual size.
+Each query has room for up to maxHits hits, a query with one hit gets the closest one.
+A query with an empty layer mask is skipped and has no hits.
+
+The queries can run while the scene is simulating, then they see the poses of the previous step.
+*/
+class PxQueryBatch {
+public:
+	using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	/// <summary>
+	/// Function that runs [0, count) in ranges of grain elements in parallel and returns when all of them are finished
+	/// </summary>
+	using ParallelForFunction = std::function<void(size_t count, size_t grain, const RangeFunction& function)>;
+
+	/// <summary>
+	/// Layer mask of the queries that hit every layer. Bit i is the layer i of CollisionLayers
+	/// </summary>
+	static const uint32_t ALL_LAYERS = UINT32_MAX;
+
+	struct Hit {
+		//Owner of the body hitted, read from the userData of the actor
+		GameObject* gameObject;
+		//Position and normal of the hit, zero for overlaps
+		Vec3 position;
+		Vec3 normal;
+		//Distance along the ray or sweep, zero for overlaps
+		float distance;
+	};
+
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	/// <param name="queryCapacity">Number of queries the memory is reserved for</param>
+	/// <param name="hitCapacity">Number of hits the memory is reserved for</param>
+	PxQueryBatch(size_t queryCapacity = 64, size_t hitCapacity = 64);
+
+	/// <summary>
+	/// Adds a ray from origin in direction a distance units
+	/// </summary>
+	/// <param name="layers">Mask of the layers the ray hits</param>
+	/// <param name="maxHits">Maximum number of hits, the closest ones are kept</param>
+	/// <param name="collidesWith">The ray only hits this types of bodies</param>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative or zero, direction is all zeroes or maxHits is zero</exception>
+	size_t addRaycast(const Vec3& origin, const Vec3& direction, float distance, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, PxRayCast::Type collidesWith = PxRayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a sphere that moves from center in direction a distance units
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative or zero, direction is all zeroes or maxHits is zero</exception>
+	size_t addSphereSweep(const Vec3& center, float radius, const Vec3& direction, float distance, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, PxRayCast::Type collidesWith = PxRayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a box that moves from center in direction a distance units
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative or zero, direction is all zeroes or maxHits is zero</exception>
+	size_t addBoxSweep(const Vec3& center, const Vec3& halfExtents, const Quat& orientation, const Vec3& direction, float distance,
+		uint32_t layers = ALL_LAYERS, unsigned int maxHits = 1, PxRayCast::Type collidesWith = PxRayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a capsule that moves from center in direction a distance units. The axis of the capsule is its local X axis
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative or zero, direction is all zeroes or maxHits is zero</exception>
+	size_t addCapsuleSweep(const Vec3& center, float radius, float halfHeight, const Quat& orientation, const Vec3& direction, float distance,
+		uint32_t layers = ALL_LAYERS, unsigned int maxHits = 1, PxRayCast::Type collidesWith = PxRayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a query of the bodies that overlap a sphere
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when maxHits is zero</exception>
+	size_t addSphereOverlap(const Vec3& center, float radius, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, PxRayCast::Type collidesWith = PxRayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a query of the bodies that overlap a box
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when maxHits is zero</exception>
+	size_t addBoxOverlap(const Vec3& center, const Vec3& halfExtents, const Quat& orientation, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, PxRayCast::Type collidesWith = PxRayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a query of the bodies that overlap a capsule. The axis of the capsule is its local X axis
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when maxHits is zero</exception>
+	size_t addCapsuleOverlap(const Vec3& center, float radius, float halfHeight, const Quat& orientation, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, PxRayCast::Type collidesWith = PxRayCast::Type::Both);
+
+	/// <summary>
+	/// Runs every query and stores their hits, replacing the ones of the previous execution. The queries without layers aren't run
+	/// </summary>
+	/// <param name="parallelFor">Function to run the queries in a thread pool, if it's empty they run in the calling thread</param>
+	void execute(const ParallelForFunction& parallelFor = nullptr);
+
+	/// <summary>
+	/// Removes every query and its hits, keeping the memory
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Returns the number of queries in the batch
+	/// </summary>
+	inline size_t size() const { return _queries.size(); }
+
+	/// <summary>
+	/// Returns the number of hits of the query in the last execution
+	/// </summary>
+	inline unsigned int getHitCount(size_t query) const { return _queries[query].hitCount; }
+
+	/// <summary>
+	/// Returns the hits of the query in the last execution, sorted by distance. Valid until the batch changes
+	/// </summary>
+	inline const Hit* getHits(size_t query) const { return _hits.data() + _queries[query].firstHit; }
+
+private:
+	enum class Kind : unsigned char {
+		Raycast, Sweep, Overlap
+	};
+
+	enum class Shape : unsigned char {
+		Ray, Sphere, Box, Capsule
+	};
+
+	struct Query {
+		Kind kind;
+		Shape shape;
+		PxRayCast::Type collidesWith;
+		uint32_t layers;
+		Vec3 position;
+		Quat orientation;
+		//Radius and half height, or the half extents of a box
+		Vec3 size;
+		Vec3 direction;
+		float distance;
+		unsigned int maxHits;
+		unsigned int firstHit;
+		unsigned int hitCount;
+	};
+
+	/// <summary>
+	/// Checks the parameters, stores the query and reserves its hits
+	/// </summary>
+	size_t add(Kind kind, Shape shape, const Vec3& position, const Quat& orientation, const Vec3& size, const Vec3& direction, float distance,
+		uint32_t layers, unsigned int maxHits, PxRayCast::Type collidesWith);
+
+	/// <summary>
+	/// Runs a query and writes its hits in its part of the hit buffer
+	/// </summary>
+	void run(Query& query);
+
+	//Queries run by each job of execute
+	static const size_t GRAIN = 32;
+
+	std::vector<Query> _queries;
+	std::vector<Hit> _hits;
+};
+
+#endif //!PXQUERYBATCH_H
@@ -1,15 +1,17 @@
 #include "RayCast.h"
 #include "PxPhysicsAPI.h"
 #include "PhysxEngine.h"
+#include "CollisionBody.h"
 #include "Exceptions.h"
+#include "MotorMath/PhysxMath.h"
 
-PxRayCast::PxRayCast(const std::tuple<float, float, float>& source, const std::tuple<float, float, float>& directionVector, float distance, PxRayCast::Type collidesWith) :
+PxRayCast::PxRayCast(const Vec3& source, const Vec3& directionVector, float distance, PxRayCast::Type collidesWith) :
 	_raycast()
 {
 
 	if (distance <= 0)
 		throw ERayCast("RayCast distance cannot negative or zero");
-	if(TUPLE_TO_PHYSXVEC3(directionVector).isZero())
+	if(toPx(directionVector).isZero())
 		throw ERayCast("RayCast direction vector cannot be zero");
 
 	physx::PxRaycastBuffer hit;
@@ -28,12 +30,14 @@ PxRayCast::PxRayCast(const std::tuple<float, float, float>& source, const std::t
 		break;
 	}
 	
-	_raycast.hit = PhysxEngine::getPxInstance()->getScene()->raycast(TUPLE_TO_PHYSXVEC3(source), TUPLE_TO_PHYSXVEC3(directionVector).getNormalized(), distance, hit,
+	_raycast.hit = PhysxEngine::getPxInstance()->getScene()->raycast(toPx(source), toPx(directionVector).getNormalized(), distance, hit,
 			physx::PxHitFlags(physx::PxHitFlag::eDEFAULT), filter);
 
 	if (_raycast.hit) {
-		_raycast.actorName = hit.block.actor->getName();
+		//Bodies destroyed during the simulation have no userData
+		CollisionBody* body = static_cast<CollisionBody*>(hit.block.actor->userData);
+		if (body != nullptr) _raycast.gameObject = body->getGameObject();
 		_raycast.distance = hit.block.distance;
-		_raycast.hitPosition = PHYSXVEC3_TO_TUPLE(hit.block.position);
+		_raycast.hitPosition = fromPx(hit.block.position);
 	}
 }
@@ -3,11 +3,11 @@
 #ifndef PXRAYCAST_H
 #define PXRAYCAST_H
 
-#include <tuple>
+#include "MotorMath/Vec3.h"
 #include <string>
 
-#define TUPLE_TO_PHYSXVEC3(tuple) physx::PxVec3(std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple))
-#define PHYSXVEC3_TO_TUPLE(vec) std::tuple<float,float,float>(vec.x,vec.y,vec.z)
+
+class GameObject;
 
 class PxRayCast {
 
@@ -21,8 +21,9 @@ public:
 
 	struct RayCastHit {
 		bool hit = false;
-		std::string actorName = "";
-		std::tuple<float, float, float> hitPosition = {0, 0, 0};
+		//Owner of the body hitted, read from the userData of the actor
+		GameObject* gameObject = nullptr;
+		Vec3 hitPosition;
 		float distance = -1.0f;
 	};
 
@@ -34,7 +35,7 @@ public:
 	/// <param name="distance">: Max distance</param>
 	/// <param name="collidesWith">: the ray only collides with this types of colliders</param>
 	/// <exception cref="ERayCast">thrown when distance is negative, or direction vector is all zeroes</exception>
-	PxRayCast(const std::tuple<float, float, float>& source, const std::tuple<float, float, float>& directionVector, float distance, PxRayCast::Type collidesWith);
+	PxRayCast(const Vec3& source, const Vec3& directionVector, float distance, PxRayCast::Type collidesWith);
 	
 	/// <summary>
 	/// Returns the raycast aftermath
@@ -6,122 +6,160 @@
 #include "PxRigidDynamic.h"
 #include "PxRigidStatic.h"
 #include "PhysxEngine.h"
+#include "CollisionLayers.h"
+#include "PhysicsCache.h"
 #include "extensions/PxRigidBodyExt.h"
+#include "MotorMath/PhysxMath.h"
 #include <iostream>
 
-RigidBody::RigidBody(float radious, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isKinematic, const std::tuple<float, float, float>& position,
+RigidBody::RigidBody(float radious, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isKinematic, const Vec3& position,
 	bool isStatic, float linearDamping, float angularDamping, float staticFriction,
 	float dynamicFriction, float restitution, float density) :_physx(nullptr), _dynamicBody(nullptr),
-	_staticBody(nullptr), _isStatic(isStatic), _scene(nullptr), _gameObject(gameObject), _collisionCallback(collisionCallback)
+	_staticBody(nullptr), _isStatic(isStatic), _scene(nullptr), _gameObject(gameObject), _collisionCallback(collisionCallback), _poseCallback(nullptr), _poseTarget(nullptr)
 {
 	initParams(position, density, isKinematic, linearDamping, angularDamping);
-	physx::PxSphereGeometry aux(radious);
-
-	//Set the material of the objct(how it interacts with other objects)
-	physx::PxMaterial* mat = _physx->createMaterial(staticFriction, dynamicFriction, restitution);
-	_shape = _physx->createShape(aux, *mat);
-	setFlags(_shape);
-	mat->release();
+	//Set the shape and the material of the object (how it interacts with other objects)
+	initShape(ShapeDesc::Sphere, radious, 0, 0, staticFriction, dynamicFriction, restitution);
 	if (_isStatic)
 	{
-		_staticBody->attachShape(*_shape);
-		_scene->addActor(*_staticBody);
+		//The static actors are added in batches, see PhysxEngine::addActor
+		PhysxEngine::getPxInstance()->addActor(_staticBody);
 		_staticBody->setName(gameObjectName.c_str());
 	}
 	else {
-		_dynamicBody->attachShape(*_shape);
-		_scene->addActor(*_dynamicBody);
+		write([this]() { _scene->addActor(*_dynamicBody); });
 		_dynamicBody->setName(gameObjectName.c_str());
 	}
 }
 
-RigidBody::RigidBody(float width, float height, float depth, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic, const std::tuple<float, float, float>& position,
+RigidBody::RigidBody(float width, float height, float depth, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic, const Vec3& position,
 	bool isKinematic, float linearDamping, float angularDamping, float staticFriction,
 	float dynamicFriction, float restitution, float mass) :
 	_physx(nullptr), _dynamicBody(nullptr), _staticBody(nullptr), _isStatic(isStatic), _scene(nullptr),
-	_gameObject(gameObject), _collisionCallback(collisionCallback)
+	_gameObject(gameObject), _collisionCallback(collisionCallback), _poseCallback(nullptr), _poseTarget(nullptr)
 {
 	initParams(position, mass, isKinematic, linearDamping, angularDamping);
-	//Set the material of the objct(how it interacts with other objects)
-	physx::PxMaterial* mat = _physx->createMaterial(staticFriction, dynamicFriction, restitution);
-	//Create the geometry for the collider
-	physx::PxBoxGeometry aux(width / 2, height / 2, depth / 2);
-	_shape = _physx->createShape(aux, *mat);
-	setFlags(_shape);
-	mat->release();
+	//Set the shape and the material of the object (how it interacts with other objects)
+	initShape(ShapeDesc::Box, width / 2, height / 2, depth / 2, staticFriction, dynamicFriction, restitution);
 
 	if (_isStatic)
 	{
-		_staticBody->attachShape(*_shape);
-		_scene->addActor(*_staticBody);
+		//The static actors are added in batches, see PhysxEngine::addActor
+		PhysxEngine::getPxInstance()->addActor(_staticBody);
 		_staticBody->setName(gameObjectName.c_str());
 	}
 	else {
-		_dynamicBody->attachShape(*_shape);
-		_scene->addActor(*_dynamicBody);
+		write([this]() { _scene->addActor(*_dynamicBody); });
 		_dynamicBody->setName(gameObjectName.c_str());
 	}
 }
 
-RigidBody::RigidBody(float radious, float height, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic, const std::tuple<float, float, float>& position, bool isKinematic,
+RigidBody::RigidBody(float radious, float height, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic, const Vec3& position, bool isKinematic,
 	float linearDamping, float angularDamping, float staticFriction, float dynamicFriction, float restitution, float mass) :
 	_physx(nullptr), _dynamicBody(nullptr), _staticBody(nullptr), _isStatic(isStatic), _scene(nullptr),
-	_gameObject(gameObject), _collisionCallback(collisionCallback)
+	_gameObject(gameObject), _collisionCallback(collisionCallback), _poseCallback(nullptr), _poseTarget(nullptr)
 {
 	initParams(position, mass, isKinematic, linearDamping, angularDamping);
-	//Set the material of the object(how it interacts with other objects)
-	physx::PxMaterial* mat = _physx->createMaterial(staticFriction, dynamicFriction, restitution);
-	//Create the geometry for the collider
-	physx::PxCapsuleGeometry aux(radious, height / 2);
-	_shape = _physx->createShape(aux, *mat);
-	setFlags(_shape);
-	mat->release();
+	//Set the shape and the material of the object (how it interacts with other objects)
+	initShape(ShapeDesc::Capsule, radious, height / 2, 0, staticFriction, dynamicFriction, restitution);
 	if (_isStatic)
 	{
-		_staticBody->attachShape(*_shape);
-		_scene->addActor(*_staticBody);
+		//The static actors are added in batches, see PhysxEngine::addActor
+		PhysxEngine::getPxInstance()->addActor(_staticBody);
 		_staticBody->setName(gameObjectName.c_str());
 	}
 	else {
-		_dynamicBody->attachShape(*_shape);
-		_scene->addActor(*_dynamicBody);
+		write([this]() { _scene->addActor(*_dynamicBody); });
 		_dynamicBody->setName(gameObjectName.c_str());
 	}
 }
 
+RigidBody::RigidBody(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* collisionCallback) :
+	_physx(PhysxEngine::getPxInstance()->getPhysics()), _dynamicBody(actor->is<physx::PxRigidDynamic>()), _staticBody(actor->is<physx::PxRigidStatic>()),
+	_isStatic(_staticBody != nullptr), _scene(PhysxEngine::getPxInstance()->getScene()), _shape(nullptr),
+	_gameObject(gameObject), _collisionCallback(collisionCallback), _poseCallback(nullptr), _poseTarget(nullptr)
+{
+	actor->getShapes(&_shape, 1);
+	actor->userData = this;
+}
+
 RigidBody::~RigidBody()
 {
-	_shape->release();
-	if (_isStatic)
-		_staticBody->release();
-	else
-		_dynamicBody->release();
+	PhysxEngine::getPxInstance()->cancelWrites(this);
+
+	//The actor may be in use by the simulation, so it is released through a write that doesn't depend on this.
+	//The shape belongs to the PhysicsCache, releasing the actor only detaches it
+	physx::PxRigidActor* actor = getActor();
+	actor->userData = nullptr;
+	PhysxEngine::getPxInstance()->cancelActor(actor);
+	PhysxEngine::getPxInstance()->write(nullptr, [actor]() { actor->release(); });
 }
 
 void RigidBody::enable()
 {
-	if (_isStatic)
-		_staticBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, false);
-	else
-		_dynamicBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, false);
+	write([this]() {
+		if (_isStatic)
+			_staticBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, false);
+		else
+			_dynamicBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, false);
+	});
 }
 
 void RigidBody::disable()
 {
-	if (_isStatic)
-		_staticBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, true);
-	else
+	write([this]() {
+		if (_isStatic)
+			_staticBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, true);
+		else
+			_dynamicBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, true);
+	});
+}
+
+void RigidBody::suspend()
+{
+	if (_isStatic) {
+		disable();
+		return;
+	}
+	write([this]() {
+		if (_dynamicBody->getActorFlags().isSet(physx::PxActorFlag::eDISABLE_SIMULATION)) return;
+		_suspendedLinear = fromPx(_dynamicBody->getLinearVelocity());
+		_suspendedAngular = fromPx(_dynamicBody->getAngularVelocity());
+		_suspendedAsleep = _dynamicBody->isSleeping();
 		_dynamicBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, true);
+	});
+}
+
+void RigidBody::resume()
+{
+	if (_isStatic) {
+		enable();
+		return;
+	}
+	write([this]() {
+		if (!_dynamicBody->getActorFlags().isSet(physx::PxActorFlag::eDISABLE_SIMULATION)) return;
+		_dynamicBody->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, false);
+		//Kinematic bodies have no velocities of their own
+		if (_dynamicBody->getRigidBodyFlags().isSet(physx::PxRigidBodyFlag::eKINEMATIC)) return;
+		if (_suspendedAsleep) {
+			_dynamicBody->putToSleep();
+			return;
+		}
+		_dynamicBody->setLinearVelocity(toPx(_suspendedLinear));
+		_dynamicBody->setAngularVelocity(toPx(_suspendedAngular));
+	});
 }
 
 bool RigidBody::setStaticFriction(float f)
 {
 	if (!_isStatic) {
-		std::list<physx::PxMaterial*> materials = getAllMaterials();
-		for (auto it = materials.begin(); it != materials.end(); ++it)
-		{
-			(*it)->setStaticFriction(f);
-		}
+		write([this, f]() {
+			//The materials are shared, so the body changes to the one with the new value
+			PhysicsCache* cache = PhysxEngine::getPxInstance()->getCache();
+			ShapeDesc desc = cache->describe(_shape);
+			desc.material = cache->getMaterial(f, desc.material->getDynamicFriction(), desc.material->getRestitution());
+			replaceShape(desc);
+		});
 		return true;
 	}
 	return false;
@@ -130,11 +168,13 @@ bool RigidBody::setStaticFriction(float f)
 bool RigidBody::setDynamicFriction(float f)
 {
 	if (!_isStatic) {
-		std::list<physx::PxMaterial*> materials = getAllMaterials();
-		for (auto it = materials.begin(); it != materials.end(); ++it)
-		{
-			(*it)->setDynamicFriction(f);
-		}
+		write([this, f]() {
+			//The materials are shared, so the body changes to the one with the new value
+			PhysicsCache* cache = PhysxEngine::getPxInstance()->getCache();
+			ShapeDesc desc = cache->describe(_shape);
+			desc.material = cache->getMaterial(desc.material->getStaticFriction(), f, desc.material->getRestitution());
+			replaceShape(desc);
+		});
 		return true;
 	}
 	return false;
@@ -144,11 +184,13 @@ bool RigidBody::setDynamicFriction(float f)
 bool RigidBody::setBounciness(float b)
 {
 	if (!_isStatic) {
-		std::list<physx::PxMaterial*> materials = getAllMaterials();
-		for (auto it = materials.begin(); it != materials.end(); ++it)
-		{
-			(*it)->setRestitution(b);
-		}
+		write([this, b]() {
+			//The materials are shared, so the body changes to the one with the new value
+			PhysicsCache* cache = PhysxEngine::getPxInstance()->getCache();
+			ShapeDesc desc = cache->describe(_shape);
+			desc.material = cache->getMaterial(desc.material->getStaticFriction(), desc.material->getDynamicFriction(), b);
+			replaceShape(desc);
+		});
 		return true;
 
 	}
@@ -160,47 +202,47 @@ bool RigidBody::setMass(float m)
 {
 	if (!_isStatic)
 	{
-		_dynamicBody->setMass(m);
+		write([this, m]() { _dynamicBody->setMass(m); });
 		return true;
 	}
 	return false;
 
 }
 
-bool RigidBody::setLinearVelocity(const std::tuple<float, float, float>& vel)
+bool RigidBody::setLinearVelocity(const Vec3& vel)
 {
 	if (!_isStatic)
 	{
-		_dynamicBody->setLinearVelocity(TUPLE_TO_PHYSXVEC3(vel));
+		write([this, vel]() { _dynamicBody->setLinearVelocity(toPx(vel)); });
 		return true;
 	}
 	return false;
 
 }
 
-bool RigidBody::setAngularVelocity(const std::tuple<float, float, float>& vel)
+bool RigidBody::setAngularVelocity(const Vec3& vel)
 {
 	if (!_isStatic)
 	{
-		_dynamicBody->setAngularVelocity(TUPLE_TO_PHYSXVEC3(vel));
+		write([this, vel]() { _dynamicBody->setAngularVelocity(toPx(vel)); });
 		return true;
 	}
 	return false;
 
 }
 
-const std::tuple<float, float, float> RigidBody::getAngularVelocity()
+Vec3 RigidBody::getAngularVelocity()
 {
 	if (_isStatic)
-		return std::tuple<float, float, float>(0, 0, 0);
-	else return  PHYSXVEC3_TO_TUPLE(_dynamicBody->getAngularVelocity());
+		return Vec3();
+	else return  fromPx(_dynamicBody->getAngularVelocity());
 }
 
-const std::tuple<float, float, float> RigidBody::getLinearVelocity()
+Vec3 RigidBody::getLinearVelocity()
 {
 	if (_isStatic)
-		return std::tuple<float, float, float>(0, 0, 0);
-	else return  PHYSXVEC3_TO_TUPLE(_dynamicBody->getLinearVelocity());
+		return Vec3();
+	else return  fromPx(_dynamicBody->getLinearVelocity());
 }
 
 float RigidBody::getMass()
@@ -209,32 +251,32 @@ float RigidBody::getMass()
 		0;
 	else return _dynamicBody->getMass();
 }
-bool RigidBody::addForce(std::tuple<float, float, float>& force)
+bool RigidBody::addForce(const Vec3& force)
 {
 	if (!_isStatic) {
 
-		_dynamicBody->addForce(TUPLE_TO_PHYSXVEC3(force));
+		write([this, force]() { _dynamicBody->addForce(toPx(force)); });
 		return true;
 	}
 	return false;
 }
 
-bool RigidBody::addImpulse(std::tuple<float, float, float>& impulse)
+bool RigidBody::addImpulse(const Vec3& impulse)
 {
 	if (!_isStatic)
 	{
-		_dynamicBody->addForce(TUPLE_TO_PHYSXVEC3(impulse), physx::PxForceMode::eIMPULSE);
+		write([this, impulse]() { _dynamicBody->addForce(toPx(impulse), physx::PxForceMode::eIMPULSE); });
 		return true;
 	}
 	return false;
 
 }
 
-bool RigidBody::addTorque(const std::tuple<float, float, float>& torque)
+bool RigidBody::addTorque(const Vec3& torque)
 {
 	if (!_isStatic)
 	{
-		_dynamicBody->addTorque(TUPLE_TO_PHYSXVEC3(torque));
+		write([this, torque]() { _dynamicBody->addTorque(toPx(torque)); });
 		return true;
 	}
 	return false;
@@ -244,18 +286,18 @@ bool RigidBody::setGravity(bool g)
 {
 	if (!_isStatic)
 	{
-		_dynamicBody->setActorFlag(physx::PxActorFlag::eDISABLE_GRAVITY, !g);
+		write([this, g]() { _dynamicBody->setActorFlag(physx::PxActorFlag::eDISABLE_GRAVITY, !g); });
 		return true;
 
 	}
 	return false;
 }
 
-bool RigidBody::moveTo(std::tuple<float, float, float>& dest)
+bool RigidBody::moveTo(const Vec3& dest)
 {
 	if (!_isStatic && _dynamicBody->getRigidBodyFlags().isSet(physx::PxRigidBodyFlag::eKINEMATIC))
 	{
-		_dynamicBody->setKinematicTarget(physx::PxTransform(TUPLE_TO_PHYSXVEC3(dest)));
+		write([this, dest]() { _dynamicBody->setKinematicTarget(physx::PxTransform(toPx(dest))); });
 		return true;
 
 	}
@@ -266,10 +308,12 @@ bool RigidBody::constrainX(bool constrain, bool linear)
 {
 	if (!_isStatic)
 	{
-		if (linear)
-			_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_X, constrain);
-		else
-			_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_X, constrain);
+		write([this, constrain, linear]() {
+			if (linear)
+				_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_X, constrain);
+			else
+				_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_X, constrain);
+		});
 		return true;
 
 	}
@@ -281,10 +325,12 @@ bool RigidBody::constrainY(bool constrain, bool linear)
 {
 	if (!_isStatic)
 	{
-		if (linear)
-			_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Y, constrain);
-		else
-			_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Y, constrain);
+		write([this, constrain, linear]() {
+			if (linear)
+				_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Y, constrain);
+			else
+				_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Y, constrain);
+		});
 		return true;
 
 	}
@@ -296,10 +342,12 @@ bool RigidBody::constrainZ(bool constrain, bool linear)
 {
 	if (!_isStatic)
 	{
-		if (linear)
-			_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Z, constrain);
-		else
-			_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Z, constrain);
+		write([this, constrain, linear]() {
+			if (linear)
+				_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_LINEAR_Z, constrain);
+			else
+				_dynamicBody->setRigidDynamicLockFlag(physx::PxRigidDynamicLockFlag::eLOCK_ANGULAR_Z, constrain);
+		});
 		return true;
 
 	}
@@ -307,188 +355,166 @@ bool RigidBody::constrainZ(bool constrain, bool linear)
 
 }
 
-bool RigidBody::setPosition(const std::tuple<float, float, float>& position)
+bool RigidBody::setPosition(const Vec3& position)
 {
 	if (!_isStatic) {
-		_dynamicBody->setGlobalPose(physx::PxTransform(TUPLE_TO_PHYSXVEC3(position)));
+		write([this, position]() { _dynamicBody->setGlobalPose(physx::PxTransform(toPx(position), _dynamicBody->getGlobalPose().q)); });
 		return true;
 
 	}
 	return false;
 }
 
-bool RigidBody::rotate(const std::tuple<float, float, float>& rotation)
+bool RigidBody::rotate(const Vec3& rotation)
 {
 	if (!_isStatic) {
-		physx::PxVec3 postRot = _dynamicBody->getGlobalPose().rotate(TUPLE_TO_PHYSXVEC3(rotation));
-		physx::PxQuat q = toQuaternion(PHYSXVEC3_TO_TUPLE(postRot));
-		physx::PxTransform tr(_dynamicBody->getGlobalPose().p, q);
-		_dynamicBody->setGlobalPose(tr);
+		write([this, rotation]() {
+			physx::PxVec3 postRot = _dynamicBody->getGlobalPose().rotate(toPx(rotation));
+			physx::PxTransform tr(_dynamicBody->getGlobalPose().p, toPx(Quat::fromEuler(fromPx(postRot))));
+			_dynamicBody->setGlobalPose(tr);
+		});
 		return true;
 	}
 	return false;
 }
 
-bool RigidBody::setRotation(const std::tuple<float, float, float>& rotation)
+bool RigidBody::setRotation(const Vec3& rotation)
 {
-	if (!_isStatic) { 
-		physx::PxQuat q = toQuaternion(rotation);
-		physx::PxTransform tr(_dynamicBody->getGlobalPose().p, q);
-		_dynamicBody->setGlobalPose(tr);
-		return true;
-	}
-	else {
-		physx::PxQuat q = toQuaternion(rotation);
-		physx::PxTransform tr(_staticBody->getGlobalPose().p, q);
-		_staticBody->setGlobalPose(tr);
-		return false;
-	}
+	return setOrientation(Quat::fromEuler(rotation));
 }
 
-bool RigidBody::setScale(const std::tuple<float, float, float>&scale)
+bool RigidBody::setOrientation(const Quat& orientation)
 {
-	if (!_isStatic) {
-
-		if (_shape->getGeometryType() == physx::PxGeometryType::eBOX) {
-			physx::PxVec3 boxScale = _shape->getGeometry().box().halfExtents;
-			physx::PxVec3 newScale = TUPLE_TO_PHYSXVEC3(scale);
-			boxScale.x *= newScale.x;
-			boxScale.y *= newScale.y;
-			boxScale.z *= newScale.z;
-
-			_shape->setGeometry(physx::PxBoxGeometry(boxScale));
-		}
-		else if (_shape->getGeometryType() == physx::PxGeometryType::eSPHERE) {
-
-			float sphereScale = _shape->getGeometry().sphere().radius;
-			_shape->setGeometry(physx::PxSphereGeometry(getGreater(scale) * sphereScale));
-		}
-		else if (_shape->getGeometryType() == physx::PxGeometryType::eCAPSULE)
-		{
-			float capsuleRadious = _shape->getGeometry().capsule().radius;
-			float capsuleHalfHeight = _shape->getGeometry().capsule().halfHeight;
-			float greater = getGreater(scale);
-			_shape->setGeometry(physx::PxCapsuleGeometry(capsuleRadious * greater, capsuleHalfHeight * greater));
+	physx::PxQuat q = toPx(orientation);
+	write([this, q]() {
+		physx::PxRigidActor* actor = getActor();
+		actor->setGlobalPose(physx::PxTransform(actor->getGlobalPose().p, q));
+	});
+	return !_isStatic;
+}
 
-		}
+bool RigidBody::setScale(const Vec3& scale)
+{
+	if (!_isStatic) {
+		write([this, scale]() {
+			ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_shape);
+			if (desc.type == ShapeDesc::Box) {
+				desc.size[0] *= scale.x;
+				desc.size[1] *= scale.y;
+				desc.size[2] *= scale.z;
+			}
+			else {
+				//Spheres and capsules keep their proportions
+				float greater = getGreater(scale);
+				desc.size[0] *= greater;
+				desc.size[1] *= greater;
+			}
+			replaceShape(desc);
+		});
 		return true;
 	}
 	return false;
 
 }
 
-const std::tuple<float, float, float> RigidBody::getPosition()
+Vec3 RigidBody::getPosition()
 {
 	if (_isStatic) {
-		return PHYSXVEC3_TO_TUPLE(_staticBody->getGlobalPose().p);
+		return fromPx(_staticBody->getGlobalPose().p);
 	}
 	else {
-		return PHYSXVEC3_TO_TUPLE(_dynamicBody->getGlobalPose().p);
+		return fromPx(_dynamicBody->getGlobalPose().p);
 	}
 
 }
 
-const std::tuple<float, float, float> RigidBody::getRotation()
+void RigidBody::syncPose()
 {
-	return PHYSXVEC3_TO_TUPLE(ToEulerAngles(_dynamicBody->getGlobalPose().q));
+	if (_poseCallback == nullptr || _isStatic) return;
+
+	physx::PxTransform pose = _dynamicBody->getGlobalPose();
+	_poseCallback(_poseTarget, fromPx(pose.p), fromPx(pose.q));
 }
 
-physx::PxQuat RigidBody::toQuaternion(const std::tuple<float, float, float>& rotation)
+Vec3 RigidBody::getRotation()
 {
-	physx::PxVec3 rot = TUPLE_TO_PHYSXVEC3(rotation);
-
-	double cy = cos(rot.x * 0.5);
-	double sy = sin(rot.x * 0.5);
-	double cp = cos(rot.y * 0.5);
-	double sp = sin(rot.y * 0.5);
-	double cr = cos(rot.z * 0.5);
-	double sr = sin(rot.z * 0.5);
-
-	physx::PxQuat q;
-	q.w = cr * cp * cy + sr * sp * sy;
-	q.z = sr * cp * cy - cr * sp * sy;
-	q.y = cr * sp * cy + sr * cp * sy;
-	q.x = cr * cp * sy - sr * sp * cy;
-
-	return q;
+	return getOrientation().toEuler();
 }
 
-physx::PxVec3 RigidBody::ToEulerAngles(physx::PxQuat q)
+Quat RigidBody::getOrientation()
 {
-	physx::PxVec3 angles;
-
-	// roll (x-axis rotation)
-	double sinr_cosp = 2 * (q.w * q.x + q.y * q.z);
-	double cosr_cosp = 1 - 2 * (q.x * q.x + q.y * q.y);
-	angles.x = std::atan2(sinr_cosp, cosr_cosp);
-
-	// pitch (y-axis rotation)
-	double sinp = 2 * (q.w * q.y - q.z * q.x);
-	if (std::abs(sinp) >= 1)
-		angles.y = std::copysign(physx::PxPi / 2, sinp); // use 90 degrees if out of range
+	if (_isStatic)
+		return fromPx(_staticBody->getGlobalPose().q);
 	else
-		angles.y = std::asin(sinp);
+		return fromPx(_dynamicBody->getGlobalPose().q);
+}
+
+void RigidBody::initShape(ShapeDesc::Type type, float x, float y, float z, float staticFriction, float dynamicFriction, float restitution)
+{
+	PhysicsCache* cache = PhysxEngine::getPxInstance()->getCache();
+	ShapeDesc desc = { type, { x, y, z }, cache->getMaterial(staticFriction, dynamicFriction, restitution), false, CollisionLayers::DEFAULT_LAYER };
+	_shape = cache->getShape(desc);
+	getActor()->attachShape(*_shape);
+}
 
-	// yaw (z-axis rotation)
-	double siny_cosp = 2 * (q.w * q.z + q.x * q.y);
-	double cosy_cosp = 1 - 2 * (q.y * q.y + q.z * q.z);
-	angles.z = std::atan2(siny_cosp, cosy_cosp);
+physx::PxRigidActor* RigidBody::getActor() const
+{
+	return _isStatic ? static_cast<physx::PxRigidActor*>(_staticBody) : static_cast<physx::PxRigidActor*>(_dynamicBody);
+}
 
-	return angles;
+void RigidBody::replaceShape(const ShapeDesc& desc)
+{
+	PhysxEngine::getPxInstance()->getCache()->replaceShape(getActor(), _shape, desc);
 }
 
-void RigidBody::setFlags(physx::PxShape * shape)
+void RigidBody::setLayer(int layer)
 {
-	shape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, true);
-	shape->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, true);
-	shape->setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, false);
-	shape->setFlag(physx::PxShapeFlag::eVISUALIZATION, false);
+	write([this, layer]() {
+		ShapeDesc desc = PhysxEngine::getPxInstance()->getCache()->describe(_shape);
+		desc.layer = layer;
+		replaceShape(desc);
+	});
 }
 
-void RigidBody::initParams(const std::tuple<float, float, float>&pos, float mass, bool isKinematic, float linearDamping, float angularDamping)
+void RigidBody::initParams(const Vec3& pos, float mass, bool isKinematic, float linearDamping, float angularDamping)
 {
 	_physx = PhysxEngine::getPxInstance()->getPhysics();
 	_scene = PhysxEngine::getPxInstance()->getScene();
 
 	if (_isStatic) {
-		_staticBody = _physx->createRigidStatic(physx::PxTransform(TUPLE_TO_PHYSXVEC3(pos)));
+		_staticBody = _physx->createRigidStatic(physx::PxTransform(toPx(pos)));
 		_staticBody->userData = this;
 	}
 	else
 	{
-		_dynamicBody = _physx->createRigidDynamic(physx::PxTransform(TUPLE_TO_PHYSXVEC3(pos)));
+		_dynamicBody = _physx->createRigidDynamic(physx::PxTransform(toPx(pos)));
 		_dynamicBody->setRigidBodyFlag(physx::PxRigidBodyFlag::eKINEMATIC, isKinematic);
 		_dynamicBody->setLinearDamping(linearDamping);
 		_dynamicBody->setAngularDamping(angularDamping);
 		_dynamicBody->userData = this;
 		physx::PxRigidBodyExt::updateMassAndInertia(*_dynamicBody, mass);
 		_dynamicBody->setMassSpaceInertiaTensor(physx::PxVec3(1, 1, 1));
+
+		const PhysicsConfig& config = PhysxEngine::getPxInstance()->getConfig();
+		_dynamicBody->setSolverIterationCounts(config.positionIterations, config.velocityIterations);
+		//Physx doesn't allow ccd on kinematic bodies
+		if (config.ccd && !isKinematic)
+			_dynamicBody->setRigidBodyFlag(physx::PxRigidBodyFlag::eENABLE_CCD, true);
 	}
 }
 
-std::list<physx::PxMaterial*> RigidBody::getAllMaterials()
+void RigidBody::write(const std::function<void()>& write)
 {
-	std::list<physx::PxMaterial*> list = std::list<physx::PxMaterial*>();
-
-	int nbMaterials = _shape->getNbMaterials();
-	physx::PxMaterial** auxMaterials = new physx::PxMaterial * [nbMaterials];
-	_shape->getMaterials(auxMaterials, nbMaterials);
-	for (int j = 0; j < nbMaterials; j++)
-	{
-		list.push_back(auxMaterials[j]);
-	}
-	delete[] auxMaterials;
-
-	return list;
+	PhysxEngine::getPxInstance()->write(this, write);
 }
 
-float RigidBody::getGreater(std::tuple<float, float, float> tuple)
+float RigidBody::getGreater(const Vec3& v)
 {
 	float greater;
-	if (std::get<0>(tuple) > std::get<1>(tuple))
-		greater = std::get<0>(tuple);
-	else greater = std::get<1>(tuple);
-	if (greater < std::get<2>(tuple))
-		greater = std::get<2>(tuple);
+	if (v.x > v.y)
+		greater = v.x;
+	else greater = v.y;
+	if (greater < v.z)
+		greater = v.z;
 	return greater;
 }
@@ -3,19 +3,20 @@
 #ifndef RIGIDBODY_H
 #define RIGIDBODY_H
 
-#include <list>
-#include <tuple>
+#include "MotorMath/Vec3.h"
+#include "MotorMath/Quat.h"
 #include <string>
+#include <functional>
 #include "CollisionBody.h"
+#include "PhysicsCache.h"
 
 class GameObject;
 
-#define TUPLE_TO_PHYSXVEC3(tuple) physx::PxVec3(std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple))
-#define PHYSXVEC3_TO_TUPLE(vec) std::tuple<float,float,float>(vec.x,vec.y,vec.z)
 
 namespace physx {
 	class PxPhysics;
 	class PxRigidBody;
+	class PxRigidActor;
 	class PxRigidDynamic;
 	class PxRigidStatic;
 	class PxShape;
@@ -47,7 +48,7 @@ public:
 	/// Dynamic friction defines the amount of friction applied between surfaces that are moving relative to each-other</param>
 	/// <param name="restitution">The bounciness, between 0 and 1</param>
 	/// <param name="mass">The mass of the sphere</param>
-	RigidBody(float radious, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic = false, const std::tuple<float, float, float>& position = std::tuple<float, float, float>(0, 0, 0),
+	RigidBody(float radious, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic = false, const Vec3& position = Vec3(),
 		bool isKinematic = false, float linearDamping = 0, float angularDamping = 0, float staticFriction = 1.0f,
 		float dynamicFriction = 1.0f, float restitution = 1.0f, float mass = 1000.0f);
 
@@ -71,7 +72,7 @@ public:
 	/// <param name="restitution">The bounciness, between 0 and 1</param>
 	/// <param name="mass">The mass of the sphere</param>
 	RigidBody(float width, float height, float depth, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic = false,
-		const std::tuple<float, float, float>& position = std::tuple<float, float, float>(0, 0, 0), bool isKinematic = false,
+		const Vec3& position = Vec3(), bool isKinematic = false,
 		float linearDamping = 0, float angularDamping = 0, float staticFriction = 1.0f, float dynamicFriction = 1.0f,
 		float restitution = 1.0f, float mass = 1000.0f);
 
@@ -92,40 +93,58 @@ public:
 	/// <param name="restitution">The bounciness, between 0 and 1</param>
 	/// <param name="mass">The mass of the sphere</param>
 	RigidBody(float radious, float height, GameObject* gameObject, const std::string& gameObjectName, ContactCallback* collisionCallback, bool isStatic = false,
-		const std::tuple<float, float, float>& position = std::tuple<float, float, float>(0, 0, 0), bool isKinematic = false, float linearDamping = 0,
+		const Vec3& position = Vec3(), bool isKinematic = false, float linearDamping = 0,
 		float AngularDamping = 0, float staticFriction = 1.0f, float dynamicFriction = 1.0f, float restitution = 1.0f, float mass = 1000.0f);
 
+	/// <summary>
+	/// Takes an actor loaded from a PhysicsCollection, with its shape and its settings, already in the scene
+	/// </summary>
+	/// <param name="gameObject">Pointer to the GameObject owning the component, used for collision callbacks</param>
+	/// <param name="collisionCallback">Pointer to the function called on collision</param>
+	RigidBody(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* collisionCallback);
+
 	~RigidBody();
 
 	void enable();
 
 	void disable();
 
+	/// <summary>
+	/// Stops simulating the body like disable, but keeps its velocities and whether it was asleep,
+	/// that physx clears when the simulation of an actor is disabled
+	/// </summary>
+	void suspend();
+
+	/// <summary>
+	/// Simulates the body again as it was when it was suspended
+	/// </summary>
+	void resume();
+
 	/// <summary>
 	/// Adds a force if it's a dynamic rigid body
 	/// </summary>
 	/// <param name="force">The force to add</param>
-	bool addForce(std::tuple<float, float, float>& force);
+	bool addForce(const Vec3& force);
 
 	/// <summary>
 	/// Adds an impulse if it's a dynamic rigid body
 	/// </summary>
 	/// <param name="impulse">The impulse to add</param>
-	bool addImpulse(std::tuple<float, float, float>& impulse);
+	bool addImpulse(const Vec3& impulse);
 
 	/// <summary>
 	/// Adds a torque if it's a dynamic rigid body
 	/// </summary>
 	/// <param name="torque">The torque to add</param>
 	/// <returns>The new rotation of the object and if it's valid</returns>
-	bool  addTorque(const std::tuple<float, float, float>& torque);
+	bool  addTorque(const Vec3& torque);
 
 	/// <summary>
 	/// Moves the rigidBody to a point, (only if Kinematic)
 	/// </summary>
 	/// <param name="dest">The point where the rigidBody will be moved</param>
 	/// <returns>The new position of the object and if it's valid</returns>
-	bool  moveTo(std::tuple<float, float, float>& dest);
+	bool  moveTo(const Vec3& dest);
 
 	/// <summary>
 	/// Enables or disables the constraint in the rigid body x axis
@@ -152,13 +171,13 @@ public:
 	/// Sets the transform position to a specified one
 	/// </summary>
 	/// <param name="position">Set of values that determine the position</param>
-	bool setPosition(const std::tuple<float, float, float>& position);
+	bool setPosition(const Vec3& position);
 
 	/// <summary>
 	/// rotate the object by a vector
 	/// </summary>
 	/// <param name="position">Set of values that determine the rotation</param>
-	bool rotate(const std::tuple<float, float, float>& rotation);
+	bool rotate(const Vec3& rotation);
 
 	/// <summary>
 	/// Sets the transform rotation to a specified one
@@ -166,13 +185,19 @@ public:
 	/// <param name="angle">angle in degrees to rotate</param>
 	/// <param name="axis">axis to rotate</param>
 	/// <returns></returns>
-	bool setRotation(const std::tuple<float, float, float>& rotation);
+	bool setRotation(const Vec3& rotation);
+
+	/// <summary>
+	/// Sets the rigidbody orientation, keeping its position
+	/// </summary>
+	/// <param name="orientation">The new orientation, normalized</param>
+	bool setOrientation(const Quat& orientation);
 
 	/// <summary>
 	/// Sets the rigidbodys scale to a specified one
 	/// </summary>
 	/// <param name="scale">Set of values that determine the scale</param>
-	bool setScale(const std::tuple<float, float, float>& scale);
+	bool setScale(const Vec3& scale);
 
 	/// <summary>
 	/// Sets the body static friction if it's a dynamic rigid body
@@ -202,13 +227,13 @@ public:
 	/// Sets the body linear velocity if it's a dynamic rigid body (static rigid bodies don't have mass)
 	/// </summary>
 	/// <param name="vel">The new velocity</param>
-	bool setLinearVelocity(const std::tuple<float, float, float>& vel);
+	bool setLinearVelocity(const Vec3& vel);
 
 	/// <summary>
 	/// Sets the body angular velocity if it's a dynamic rigid body (static rigid bodies don't have mass)
 	/// </summary>
 	/// <param name="vel">The new velocity</param>
-	bool setAngularVelocity(const std::tuple<float, float, float>& vel);
+	bool setAngularVelocity(const Vec3& vel);
 
 	/// <summary>
 	/// Enables or disables the gravity
@@ -220,13 +245,13 @@ public:
 	/// Gets the angular velocity of the body
 	/// </summary>
 	/// <returns>The angular velocity of the body</returns>
-	const std::tuple<float, float, float> getAngularVelocity();
+	Vec3 getAngularVelocity();
 
 	/// <summary>
 	/// Gets the linear velocity of the body
 	/// </summary>
 	/// <returns>The linear velocity of the body</returns>
-	const std::tuple<float, float, float> getLinearVelocity();
+	Vec3 getLinearVelocity();
 
 	/// <summary>
 	/// Gets the mass of the body
@@ -246,17 +271,46 @@ public:
 	/// <returns>A pointer to the static function called on collision</returns>
 	inline ContactCallback* getColliderCallback() const override { return _collisionCallback; }
 
+	/// <summary>
+	/// Sets the function that receives the pose of the body after every simulation step in which it moved.
+	/// Sleeping bodies aren't reported
+	/// </summary>
+	/// <param name="callback">The function, nullptr to stop the reports</param>
+	/// <param name="target">Pointer given back to the function</param>
+	inline void setPoseCallback(PoseCallback* callback, void* target) { _poseCallback = callback; _poseTarget = target; }
+
+	/// <summary>
+	/// Sends the pose of the actor to the pose callback
+	/// </summary>
+	void syncPose() override;
+
+	/// <summary>
+	/// Moves the rigidbody to a collision layer, it's in the default one until then
+	/// </summary>
+	/// <param name="layer">Index of the layer in CollisionLayers</param>
+	void setLayer(int layer);
+
 	/// <summary>
 	/// Returns rigidbody�s position
 	/// </summary>
-	/// <returns>Tuple of three floats (x, y, z)</returns>
-	const std::tuple<float, float, float> getPosition();
+	/// <returns>Vector (x, y, z)</returns>
+	Vec3 getPosition();
 
 	/// <summary>
 	/// Returns rigidbody�s rotation
 	/// </summary>
-	/// <returns>Tuple of three floats (x, y, z)</returns>
-	const std::tuple<float, float, float> getRotation();
+	/// <returns>Vector (x, y, z)</returns>
+	Vec3 getRotation();
+
+	/// <summary>
+	/// Returns rigidbody�s orientation
+	/// </summary>
+	Quat getOrientation();
+
+	/// <summary>
+	/// Returns the static or the dynamic actor, the one the rigidbody uses
+	/// </summary>
+	physx::PxRigidActor* getActor() const override;
 
 	/// <summary>
 	/// Returns whether the rigidbody is static or not
@@ -265,14 +319,17 @@ public:
 	inline bool isStatic() const { return _isStatic; }
 
 private:
-	physx::PxQuat toQuaternion(const std::tuple<float, float, float>& rotation);
-	physx::PxVec3 ToEulerAngles(physx::PxQuat q);
+	/// <summary>
+	/// Attaches the shared shape with that geometry and material, in the default layer
+	/// </summary>
+	/// <param name="type">Type of the geometry</param>
+	/// <param name="x, y, z">Size of the geometry, see ShapeDesc</param>
+	void initShape(ShapeDesc::Type type, float x, float y, float z, float staticFriction, float dynamicFriction, float restitution);
 
 	/// <summary>
-	/// Configures a shape to avoid collision detection and scene queries (raycasts, sweeps and overlays)
+	/// Changes the shape of the actor for the shared one with that description
 	/// </summary>
-	/// <param name="shape">The shape to modify</param>
-	void setFlags(physx::PxShape* shape);
+	void replaceShape(const ShapeDesc& desc);
 
 	/// <summary>
 	/// used for physic parameters initialization
@@ -283,20 +340,20 @@ private:
 	/// <param name="mass">The mass of the body</param>
 	/// <param name="linearDamping">The linear damping of the body</param>
 	/// <param name="angularDamping">The angular damping  of the body</param>
-	void initParams(const std::tuple<float, float, float>& pos, float mass, bool isKinematic, float linearDamping, float angularDamping);
-	
+	void initParams(const Vec3& pos, float mass, bool isKinematic, float linearDamping, float angularDamping);
+
 	/// <summary>
-	/// gets all materials from the dynamic rigidBody
+	/// Applies a change to the actor, delayed until the end of the simulation if the scene is simulating
 	/// </summary>
-	/// <returns></returns>
-	std::list<physx::PxMaterial*> getAllMaterials();
+	/// <param name="write">Function that changes the actor</param>
+	void write(const std::function<void()>& write);
 	
 	/// <summary>
-	/// gets the greater component of one tuple
+	/// gets the greater component of one vector
 	/// </summary>
-	/// <param name="tuple">the tuple to get the greater component</param>
+	/// <param name="v">the vector to get the greater component</param>
 	/// <returns></returns>
-	float getGreater(std::tuple<float, float, float> tuple);
+	float getGreater(const Vec3& v);
 
 	physx::PxPhysics* _physx;
 	physx::PxScene* _scene;
@@ -306,6 +363,13 @@ private:
 
 	GameObject* _gameObject;
 	ContactCallback* _collisionCallback;
+	PoseCallback* _poseCallback;
+	void* _poseTarget;
+
+	//State of the dynamic body kept by suspend
+	Vec3 _suspendedLinear;
+	Vec3 _suspendedAngular;
+	bool _suspendedAsleep = false;
 
 	bool _isStatic;
 };
@@ -0,0 +1,56 @@
+#include "StaticGeometry.h"
+#include "PhysxEngine.h"
+#include "PhysicsCache.h"
+#include "Exceptions.h"
+#include "MotorMath/PhysxMath.h"
+#include <PxPhysicsAPI.h>
+
+StaticGeometry::StaticGeometry(GameObject* gameObject, const std::string& name, ContactCallback* colliderCallback, const Vec3& position, const Quat& orientation)
+	: _actor(nullptr), _gameObject(gameObject), _colliderCallback(colliderCallback), _shapeCount(0), _built(false)
+{
+	_actor = PhysxEngine::getPxInstance()->getPhysics()->createRigidStatic(physx::PxTransform(toPx(position), toPx(orientation)));
+	_actor->setName(name.c_str());
+	_actor->userData = this;
+}
+
+StaticGeometry::StaticGeometry(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback)
+	: _actor(actor->is<physx::PxRigidStatic>()), _gameObject(gameObject), _colliderCallback(colliderCallback), _shapeCount(0), _built(true)
+{
+	if (_actor == nullptr)
+		throw EPhysxEngine("The actor of the static geometry of " + std::string(actor->getName() != nullptr ? actor->getName() : "") + " isn't static");
+	_shapeCount = _actor->getNbShapes();
+	_actor->userData = this;
+}
+
+StaticGeometry::~StaticGeometry()
+{
+	//The actor may be in use by the simulation, so it is released through a write that doesn't depend on this
+	physx::PxRigidStatic* actor = _actor;
+	actor->userData = nullptr;
+	PhysxEngine::getPxInstance()->cancelActor(actor);
+	PhysxEngine::getPxInstance()->write(nullptr, [actor]() { actor->release(); });
+}
+
+void StaticGeometry::addShape(ShapeDesc::Type type, float x, float y, float z, const Vec3& position, const Quat& orientation,
+	float staticFriction, float dynamicFriction, float restitution, int layer)
+{
+	if (_built)
+		throw EPhysxEngine("The shapes of a static geometry must be added before it's built");
+
+	PhysicsCache* cache = PhysxEngine::getPxInstance()->getCache();
+	ShapeDesc desc = { type, { x, y, z }, cache->getMaterial(staticFriction, dynamicFriction, restitution), false, layer };
+	cache->attachExclusiveShape(_actor, desc, position, orientation);
+	++_shapeCount;
+}
+
+physx::PxRigidActor* StaticGeometry::getActor() const
+{
+	return _actor;
+}
+
+void StaticGeometry::build()
+{
+	if (_built) return;
+	_built = true;
+	PhysxEngine::getPxInstance()->addActor(_actor);
+}
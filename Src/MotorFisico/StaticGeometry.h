@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef STATICGEOMETRY_H
+#define STATICGEOMETRY_H
+
+#include "CollisionBody.h"
+#include "PhysicsCache.h"
+#include "MotorMath/Vec3.h"
+#include "MotorMath/Quat.h"
+#include <string>
+
+namespace physx {
+	class PxRigidStatic;
+}
+
+/*
+Many static shapes merged in one PxRigidStatic, for the scenery of a level (floors, walls, props that never move).
+
+One actor with many shapes is cheaper for the broad phase and the scene queries than one actor for each shape,
+and it's added to the scene with the rest of the static actors of the level. Contacts with any of the shapes
+are reported with the GameObject of the geometry.
+
+	StaticGeometry geometry(gameObject, "Level", callback, Vec3(), Quat());
+	geometry.addShape(ShapeDesc::Box, 50, 1, 50, Vec3(0, -1, 0), Quat());
+	geometry.addShape(ShapeDesc::Box, 1, 5, 50, Vec3(50, 5, 0), Quat());
+	geometry.build();
+*/
+class StaticGeometry : public CollisionBody
+{
+public:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	/// <param name="gameObject">GameObject the geometry belongs to</param>
+	/// <param name="name">Name of the actor</param>
+	/// <param name="colliderCallback">Function called when something touches the geometry</param>
+	/// <param name="position">Position of the actor, the shapes are placed relative to it</param>
+	/// <param name="orientation">Orientation of the actor</param>
+	StaticGeometry(GameObject* gameObject, const std::string& name, ContactCallback* colliderCallback, const Vec3& position, const Quat& orientation);
+
+	/// <summary>
+	/// Takes a static actor loaded from a PhysicsCollection, it's already built and in the scene
+	/// </summary>
+	/// <exception cref="EPhysxEngine">thrown when the actor isn't static</exception>
+	StaticGeometry(physx::PxRigidActor* actor, GameObject* gameObject, ContactCallback* colliderCallback);
+
+	/// <summary>
+	/// Destructor of the class, the actor is released once the simulation doesn't use it
+	/// </summary>
+	virtual ~StaticGeometry();
+
+	StaticGeometry& operator=(const StaticGeometry&) = delete;
+	StaticGeometry(StaticGeometry& other) = delete;
+
+	/// <summary>
+	/// Adds a shape to the geometry. It must be called before build
+	/// </summary>
+	/// <param name="type">Geometry of the shape</param>
+	/// <param name="x">Radius of a sphere, half width of a box or radius of a capsule</param>
+	/// <param name="y">Half height of a box or half height of a capsule</param>
+	/// <param name="z">Half depth of a box</param>
+	/// <param name="position">Position of the shape relative to the actor</param>
+	/// <param name="orientation">Orientation of the shape relative to the actor</param>
+	/// <param name="layer">Index of the layer of the shape in CollisionLayers</param>
+	void addShape(ShapeDesc::Type type, float x, float y, float z, const Vec3& position, const Quat& orientation,
+		float staticFriction = 0.5f, float dynamicFriction = 0.5f, float restitution = 0.5f, int layer = 0);
+
+	/// <summary>
+	/// Adds the actor with all its shapes to the scene, with the next batch of static actors
+	/// </summary>
+	void build();
+
+	/// <summary>
+	/// Returns the number of shapes added to the geometry
+	/// </summary>
+	inline unsigned int getShapeCount() const { return _shapeCount; }
+
+	inline ContactCallback* getColliderCallback() const override { return _colliderCallback; }
+
+	inline GameObject* getGameObject() const override { return _gameObject; }
+
+	physx::PxRigidActor* getActor() const override;
+
+private:
+	physx::PxRigidStatic* _actor;
+	GameObject* _gameObject;
+	ContactCallback* _colliderCallback;
+	unsigned int _shapeCount;
+	bool _built;
+};
+
+#endif // !STATICGEOMETRY_H
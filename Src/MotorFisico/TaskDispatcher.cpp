@@ -0,0 +1,29 @@
+#include "TaskDispatcher.h"
+
+TaskDispatcher::TaskDispatcher(const TaskSubmitFunction& submit, unsigned int workerCount) : _submit(submit), _workerCount(workerCount)
+{
+}
+
+TaskDispatcher::~TaskDispatcher()
+{
+}
+
+void TaskDispatcher::submitTask(physx::PxBaseTask& task)
+{
+	if (_workerCount == 0 || !_submit) {
+		task.run();
+		task.release();
+		return;
+	}
+
+	physx::PxBaseTask* pxTask = &task;
+	_submit([pxTask]() {
+		pxTask->run();
+		pxTask->release();
+	});
+}
+
+uint32_t TaskDispatcher::getWorkerCount() const
+{
+	return _workerCount;
+}
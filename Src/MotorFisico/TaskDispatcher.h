@@ -0,0 +1,34 @@
+#pragma once
+#ifndef TASKDISPATCHER_H
+#define TASKDISPATCHER_H
+
+#include <PxPhysicsAPI.h>
+#include "PhysxEngine.h"
+
+/// <summary>
+/// Cpu dispatcher that sends the physx tasks to the thread pool of the engine
+/// </summary>
+class TaskDispatcher : public physx::PxCpuDispatcher
+{
+public:
+	/// <summary>
+	/// Constructor of the class
+	/// </summary>
+	/// <param name="submit">Function that runs a task in the thread pool</param>
+	/// <param name="workerCount">Number of threads of the pool</param>
+	TaskDispatcher(const TaskSubmitFunction& submit, unsigned int workerCount);
+	virtual ~TaskDispatcher();
+
+	/// <summary>
+	/// Called by physx to run a task, if there are no workers it runs in the calling thread
+	/// </summary>
+	virtual void submitTask(physx::PxBaseTask& task) override;
+
+	virtual uint32_t getWorkerCount() const override;
+
+private:
+	TaskSubmitFunction _submit;
+	unsigned int _workerCount;
+};
+
+#endif TASKDISPATCHER_H
@@ -5,6 +5,7 @@
 #include <OgreViewport.h>
 #include "GraphicsEngine.h"
 #include "Euler.h"
+#include "MotorMath/OgreMath.h"
 #include "OgreRTShaderSystem.h"
 #include <iostream>
 #include <OgreCompositorManager.h>
@@ -100,21 +101,7 @@ void Camera::renderOverlays(bool render)
 
 void Camera::setOrientation(double pitch, double yaw, double roll)
 {
-	// Abbreviations for the various angular functions
-	double cy = cos(pitch * 0.5);
-	double sy = sin(pitch * 0.5);
-	double cp = cos(yaw * 0.5);
-	double sp = sin(yaw * 0.5);
-	double cr = cos(roll * 0.5);
-	double sr = sin(roll * 0.5);
-
-	Ogre::Quaternion q;
-	q.w = cr * cp * cy + sr * sp * sy;
-	q.z = sr * cp * cy - cr * sp * sy;
-	q.y = cr * sp * cy + sr * cp * sy;
-	q.x = cr * cp * sy - sr * sp * cy;
-
-	_node->setOrientation(q);
+	setOrientation(Quat::fromEuler((float)pitch, (float)yaw, (float)roll));
 }
 
 void Camera::setOrientation(Ogre::Quaternion orientation)
@@ -122,6 +109,11 @@ void Camera::setOrientation(Ogre::Quaternion orientation)
 	_node->setOrientation(orientation);
 }
 
+void Camera::setOrientation(const Quat& orientation)
+{
+	_node->setOrientation(toOgre(orientation));
+}
+
 void Camera::setPosition(float x, float y, float z)
 {
 	_node->setPosition(Ogre::Vector3(x, y, z));
@@ -162,10 +154,10 @@ void Camera::setViewportDimensions(float left, float top, float w, float h)
 	_viewport->setDimensions(left, top, w, h);
 }
 
-std::tuple<float, float, float> Camera::getOrientation() {
+Vec3 Camera::getOrientation() {
 	Ogre::Euler rot;
 	rot.fromQuaternion(_node->getOrientation());
-	return std::tuple<float, float, float>(rot.getPitch().valueDegrees(), rot.getYaw().valueDegrees(), rot.getRoll().valueDegrees());
+	return Vec3(rot.getPitch().valueDegrees(), rot.getYaw().valueDegrees(), rot.getRoll().valueDegrees());
 }
 
 void Camera::setViewportVisibility(bool visible, float x, float y, float w, float h)
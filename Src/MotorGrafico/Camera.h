@@ -16,7 +16,8 @@ namespace Ogre {
 }
 //class Transform;
 #include <string>
-#include <tuple>
+#include "MotorMath/Vec3.h"
+#include "MotorMath/Quat.h"
 
 class Camera
 {
@@ -97,6 +98,12 @@ public:
 	/// <param name="orientation">Quaternion wich specifies the camera new orientation </param>
 	void setOrientation(Ogre::Quaternion orientation);
 
+	/// <summary>
+	/// Adjusts the cameras node so that it is oriented given a Quat
+	/// </summary>
+	/// <param name="orientation">Quat wich specifies the camera new orientation </param>
+	void setOrientation(const Quat& orientation);
+
 	/// <summary>
 	/// Sets the camera position to a specified location
 	/// </summary>
@@ -154,7 +161,7 @@ public:
 	/// gets the rotation in degrees
 	/// </summary>
 	/// <returns>The rotation in degrees</returns>
-	std::tuple<float, float, float> getOrientation();
+	Vec3 getOrientation();
 
 	/// <summary>
 	/// Creates a new viewport if visible is True and removes it if Visible is false
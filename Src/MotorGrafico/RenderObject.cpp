@@ -8,8 +8,14 @@
 #include <OgreQuaternion.h>
 #include <OgreSceneManager.h>
 #include <OgreMesh.h>
+#include <OgreSubMesh.h>
+#include <OgreMeshManager.h>
+#include <OgreMeshSerializer.h>
+#include <OgreResourceGroupManager.h>
+#include <OgreDataStream.h>
 #include <OgreException.h>
 #include "Exceptions.h"
+#include "MotorMath/OgreMath.h"
 
 RenderObject::RenderObject(std::string const& meshName, std::string const& objectName) :
 	_objectNode(nullptr), _objectEntity(nullptr), _objectName(objectName), _meshName(meshName), _meshSize()
@@ -34,7 +40,7 @@ void RenderObject::init()
 	}
 
 	Ogre::Vector3 s = _objectEntity->getMesh()->getBounds().getSize();
-	_meshSize = { s.x, s.y, s.z };
+	_meshSize = fromOgre(s);
 }
 
 void RenderObject::setMaterial(std::string const& materialName)
@@ -47,12 +53,22 @@ void RenderObject::setPosition(float x, float y, float z)
 	_objectNode->setPosition(Ogre::Vector3(x, y, z));
 }
 
+void RenderObject::setPosition(const Vec3& position)
+{
+	_objectNode->setPosition(toOgre(position));
+}
+
 void RenderObject::setRotation(float x, float y, float z, float w)
 {
 	_objectNode->setOrientation(w, x, y, z);
 }
 
-const std::tuple<float, float, float>& RenderObject::getMeshSize()
+void RenderObject::setRotation(const Quat& rotation)
+{
+	_objectNode->setOrientation(toOgre(rotation));
+}
+
+const Vec3& RenderObject::getMeshSize()
 {
 	return _meshSize;
 }
@@ -64,7 +80,12 @@ void RenderObject::rotate(float angle, float x, float y, float z)
 
 void RenderObject::setScale(float x, float y, float z)
 {
-	_objectNode->setScale(Ogre::Vector3(x / std::get<0>(_meshSize), y / std::get<1>(_meshSize), z / std::get<2>(_meshSize)));
+	_objectNode->setScale(Ogre::Vector3(x / _meshSize.x, y / _meshSize.y, z / _meshSize.z));
+}
+
+void RenderObject::setScale(const Vec3& scale)
+{
+	_objectNode->setScale(toOgre(scale / _meshSize));
 }
 
 void RenderObject::scale(float x, float y, float z)
@@ -90,4 +111,81 @@ void RenderObject::setCastShadows(bool castShadows)
 void RenderObject::setRenderingDistance(float distance)
 {
 	_objectEntity->setRenderingDistance(distance);
-}
\ No newline at end of file
+}
+
+void RenderObject::readMeshFile(std::string const& meshName, std::vector<unsigned char>& data)
+{
+	Ogre::DataStreamPtr stream;
+	try {
+		//Only the file is read, the mesh isn't loaded
+		stream = Ogre::ResourceGroupManager::getSingleton().openResource(meshName, Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+	}
+	catch (Ogre::Exception e) {
+		throw EGraphicEngine("The mesh " + meshName + " can't be found: " + e.getDescription());
+	}
+	data.resize(stream->size());
+	if (stream->read(data.data(), data.size()) != data.size())
+		throw EGraphicEngine("The mesh " + meshName + " can't be read");
+}
+
+void RenderObject::readMeshTriangles(std::string const& meshName, std::vector<unsigned char>& data, std::vector<Vec3>& vertices, std::vector<uint32_t>& indices)
+{
+	//A private copy of the mesh with shadow buffers, so the vertices are read from memory instead of the gpu
+	Ogre::MeshManager& manager = Ogre::MeshManager::getSingleton();
+	Ogre::MeshPtr mesh = manager.createManual(meshName + "#triangles", Ogre::ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+	mesh->setVertexBufferPolicy(Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+	mesh->setIndexBufferPolicy(Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+	try {
+		Ogre::DataStreamPtr stream(new Ogre::MemoryDataStream(data.data(), data.size(), false, true));
+		Ogre::MeshSerializer().importMesh(stream, mesh.get());
+	}
+	catch (Ogre::Exception e) {
+		manager.remove(mesh);
+		throw EGraphicEngine("The mesh " + meshName + " can't be read: " + e.getDescription());
+	}
+
+	vertices.clear();
+	indices.clear();
+	//The submeshes that use the shared vertices add them once, and all of them index from the same place
+	size_t sharedOffset = 0;
+	bool sharedAdded = false;
+	for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i) {
+		Ogre::SubMesh* subMesh = mesh->getSubMesh(i);
+		if (subMesh->operationType != Ogre::RenderOperation::OT_TRIANGLE_LIST || subMesh->indexData->indexCount == 0) continue;
+
+		Ogre::VertexData* vertexData = subMesh->useSharedVertices ? mesh->sharedVertexData : subMesh->vertexData;
+		size_t offset = subMesh->useSharedVertices && sharedAdded ? sharedOffset : vertices.size();
+		if (!subMesh->useSharedVertices || !sharedAdded) {
+			if (subMesh->useSharedVertices) {
+				sharedAdded = true;
+				sharedOffset = offset;
+			}
+
+			const Ogre::VertexElement* position = vertexData->vertexDeclaration->findElementBySemantic(Ogre::VES_POSITION);
+			Ogre::HardwareVertexBufferSharedPtr buffer = vertexData->vertexBufferBinding->getBuffer(position->getSource());
+			Ogre::HardwareBufferLockGuard lock(buffer.get(), Ogre::HardwareBuffer::HBL_READ_ONLY);
+			unsigned char* vertex = static_cast<unsigned char*>(lock.pData) + vertexData->vertexStart * buffer->getVertexSize();
+			float* p;
+			for (size_t v = 0; v < vertexData->vertexCount; ++v, vertex += buffer->getVertexSize()) {
+				position->baseVertexPointerToElement(vertex, &p);
+				vertices.push_back(Vec3(p[0], p[1], p[2]));
+			}
+		}
+
+		Ogre::IndexData* indexData = subMesh->indexData;
+		Ogre::HardwareIndexBufferSharedPtr buffer = indexData->indexBuffer;
+		Ogre::HardwareBufferLockGuard lock(buffer.get(), Ogre::HardwareBuffer::HBL_READ_ONLY);
+		if (buffer->getType() == Ogre::HardwareIndexBuffer::IT_32BIT) {
+			const uint32_t* index = static_cast<const uint32_t*>(lock.pData) + indexData->indexStart;
+			for (size_t n = 0; n < indexData->indexCount; ++n)
+				indices.push_back((uint32_t)offset + index[n]);
+		}
+		else {
+			const uint16_t* index = static_cast<const uint16_t*>(lock.pData) + indexData->indexStart;
+			for (size_t n = 0; n < indexData->indexCount; ++n)
+				indices.push_back((uint32_t)offset + index[n]);
+		}
+	}
+
+	manager.remove(mesh);
+}
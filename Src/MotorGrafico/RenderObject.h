@@ -4,7 +4,10 @@
 #define RENDEROBJECT_H
 
 #include <string>
-#include <tuple>
+#include <vector>
+#include <cstdint>
+#include "MotorMath/Vec3.h"
+#include "MotorMath/Quat.h"
 
 namespace Ogre {
 	class SceneNode;
@@ -77,6 +80,12 @@ public:
 	///<param name="z">: Z scale</param>
 	void setScale(float x, float y, float z);
 
+	/// <summary>
+	/// Sets the object scale
+	/// </summary>
+	///<param name="scale">: Scale of each axis</param>
+	void setScale(const Vec3& scale);
+
 	/// <summary>
 	/// Set the object material
 	/// </summary>
@@ -91,6 +100,12 @@ public:
 	///<param name="z">: Z position</param>
 	void setPosition(float x, float y, float z);
 
+	/// <summary>
+	/// Set the object position
+	/// </summary>
+	///<param name="position">: Position</param>
+	void setPosition(const Vec3& position);
+
 	/// <summary>
 	/// Set the object rotation
 	/// </summary>
@@ -99,12 +114,32 @@ public:
 	///<param name="z">: Z rotation</param>
 	void setRotation(float x, float y, float z, float w);
 
+	/// <summary>
+	/// Set the object rotation
+	/// </summary>
+	///<param name="rotation">: Rotation</param>
+	void setRotation(const Quat& rotation);
+
 	/// <summary>
 	/// Returns the size of the mesh in absolute units
 	/// </summary>
 	/// <returns></returns>
-	const std::tuple<float, float, float>& getMeshSize();
+	const Vec3& getMeshSize();
+
+	/// <summary>
+	/// Reads the bytes of the .mesh file from the resource groups, without loading the mesh
+	/// </summary>
+	///<param name="meshName">: Name of the mesh, the same one the render objects use</param>
+	/// <exception cref="EGraphicEngine">thrown when the file can't be found</exception>
+	static void readMeshFile(std::string const& meshName, std::vector<unsigned char>& data);
 
+	/// <summary>
+	/// Reads the triangles of a mesh file, for the physics. The vertices of every submesh go in one list and
+	/// each three indices are a triangle. Only the submeshes made of triangle lists are read
+	/// </summary>
+	///<param name="data">: Bytes of the file, see readMeshFile</param>
+	/// <exception cref="EGraphicEngine">thrown when the mesh can't be read</exception>
+	static void readMeshTriangles(std::string const& meshName, std::vector<unsigned char>& data, std::vector<Vec3>& vertices, std::vector<uint32_t>& indices);
 
 
 protected:
@@ -114,7 +149,7 @@ protected:
 	std::string _objectName;
 	std::string _meshName;
 private:
-	std::tuple<float, float, float> _meshSize;
+	Vec3 _meshSize;
 };
 
 #endif //!RENDEROBJECT_H
\ No newline at end of file
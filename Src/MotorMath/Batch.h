@@ -0,0 +1,117 @@
+#pragma once
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "MathConfig.h"
+#include "Vec3.h"
+#include "Quat.h"
+#include "Mat4.h"
+#include <cstddef>
+
+/*
+Operations over arrays. The input and output arrays can be the same one.
+
+The Vec3 arrays are handled as arrays of floats, so the SSE path works on 4 floats at a time
+without caring where a vector ends.
+*/
+
+namespace Batch {
+
+	/// <summary>
+	/// out[i] = a[i] + b[i] * s, the integration of positions and velocities
+	/// </summary>
+	inline void multiplyAdd(const Vec3* a, const Vec3* b, float s, Vec3* out, size_t count)
+	{
+		const float* fa = &a->x;
+		const float* fb = &b->x;
+		float* fo = &out->x;
+		size_t n = count * 3, i = 0;
+#ifdef MOTORMATH_SSE
+		__m128 vs = _mm_set1_ps(s);
+		for (; i + 4 <= n; i += 4)
+			_mm_storeu_ps(fo + i, _mm_add_ps(_mm_loadu_ps(fa + i), _mm_mul_ps(_mm_loadu_ps(fb + i), vs)));
+#endif
+		for (; i < n; ++i)
+			fo[i] = fa[i] + fb[i] * s;
+	}
+
+	/// <summary>
+	/// out[i] = a[i] + b[i]
+	/// </summary>
+	inline void add(const Vec3* a, const Vec3* b, Vec3* out, size_t count)
+	{
+		multiplyAdd(a, b, 1.0f, out, count);
+	}
+
+	/// <summary>
+	/// out[i] = v[i] * s
+	/// </summary>
+	inline void scale(const Vec3* v, float s, Vec3* out, size_t count)
+	{
+		const float* fv = &v->x;
+		float* fo = &out->x;
+		size_t n = count * 3, i = 0;
+#ifdef MOTORMATH_SSE
+		__m128 vs = _mm_set1_ps(s);
+		for (; i + 4 <= n; i += 4)
+			_mm_storeu_ps(fo + i, _mm_mul_ps(_mm_loadu_ps(fv + i), vs));
+#endif
+		for (; i < n; ++i)
+			fo[i] = fv[i] * s;
+	}
+
+	/// <summary>
+	/// out[i] = m * points[i], with the translation
+	/// </summary>
+	inline void transformPoints(const Mat4& m, const Vec3* points, Vec3* out, size_t count)
+	{
+#ifdef MOTORMATH_SSE
+		__m128 c0 = _mm_loadu_ps(m.m);
+		__m128 c1 = _mm_loadu_ps(m.m + 4);
+		__m128 c2 = _mm_loadu_ps(m.m + 8);
+		__m128 c3 = _mm_loadu_ps(m.m + 12);
+		for (size_t i = 0; i < count; ++i) {
+			const Vec3& p = points[i];
+			__m128 r = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(p.x)));
+			r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(p.y)));
+			r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(p.z)));
+			//Only 3 floats are written, the next vector may be right after
+			_mm_storel_pi(reinterpret_cast<__m64*>(&out[i].x), r);
+			_mm_store_ss(&out[i].z, _mm_movehl_ps(r, r));
+		}
+#else
+		for (size_t i = 0; i < count; ++i)
+			out[i] = m.transformPoint(points[i]);
+#endif
+	}
+
+	/// <summary>
+	/// out[i] = q.rotate(v[i])
+	/// </summary>
+	inline void rotate(const Quat& q, const Vec3* v, Vec3* out, size_t count)
+	{
+		//The matrix of the rotation does it with 9 products per vector, rotate needs 18
+		Mat4 m = Mat4::fromTRS(Vec3(), q, Vec3(1, 1, 1));
+		transformPoints(m, v, out, count);
+	}
+
+	/// <summary>
+	/// out[i] = a[i] * b[i], out can't be a or b
+	/// </summary>
+	inline void multiply(const Mat4* a, const Mat4* b, Mat4* out, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			Mat4::multiply(a[i], b[i], out[i]);
+	}
+
+	/// <summary>
+	/// out[i] = Quat::fromEuler(angles[i])
+	/// </summary>
+	inline void fromEuler(const Vec3* angles, Quat* out, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			out[i] = Quat::fromEuler(angles[i]);
+	}
+}
+
+#endif // !BATCH_H
@@ -0,0 +1,95 @@
+#pragma once
+#ifndef MAT4_H
+#define MAT4_H
+
+#include "MathConfig.h"
+#include "Vec3.h"
+#include "Vec4.h"
+#include "Quat.h"
+
+/// <summary>
+/// 4x4 float matrix stored by columns, the last column is the translation
+/// </summary>
+struct alignas(16) Mat4 {
+	float m[16];
+
+	/// <summary>
+	/// Builds translation * rotation * scale. The quaternion must be normalized
+	/// </summary>
+	static inline Mat4 fromTRS(const Vec3& t, const Quat& q, const Vec3& s)
+	{
+		float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+		Mat4 r;
+		r.m[0] = (1 - 2 * (yy + zz)) * s.x;	r.m[1] = 2 * (xy + wz) * s.x;		r.m[2] = 2 * (xz - wy) * s.x;		r.m[3] = 0;
+		r.m[4] = 2 * (xy - wz) * s.y;		r.m[5] = (1 - 2 * (xx + zz)) * s.y;	r.m[6] = 2 * (yz + wx) * s.y;		r.m[7] = 0;
+		r.m[8] = 2 * (xz + wy) * s.z;		r.m[9] = 2 * (yz - wx) * s.z;		r.m[10] = (1 - 2 * (xx + yy)) * s.z;	r.m[11] = 0;
+		r.m[12] = t.x;						r.m[13] = t.y;						r.m[14] = t.z;						r.m[15] = 1;
+		return r;
+	}
+
+	static inline Mat4 identity()
+	{
+		return fromTRS(Vec3(), Quat(), Vec3(1, 1, 1));
+	}
+
+	/// <summary>
+	/// out = a * b, out can't be a or b
+	/// </summary>
+	static inline void multiply(const Mat4& a, const Mat4& b, Mat4& out)
+	{
+#ifdef MOTORMATH_SSE
+		__m128 c0 = _mm_loadu_ps(a.m);
+		__m128 c1 = _mm_loadu_ps(a.m + 4);
+		__m128 c2 = _mm_loadu_ps(a.m + 8);
+		__m128 c3 = _mm_loadu_ps(a.m + 12);
+		//Each column of the result is a combination of the columns of a
+		for (int i = 0; i < 4; ++i) {
+			const float* col = b.m + i * 4;
+			__m128 r = _mm_mul_ps(c0, _mm_set1_ps(col[0]));
+			r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(col[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(col[2])));
+			r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(col[3])));
+			_mm_storeu_ps(out.m + i * 4, r);
+		}
+#else
+		for (int i = 0; i < 4; ++i)
+			for (int j = 0; j < 4; ++j)
+				out.m[i * 4 + j] = a.m[j] * b.m[i * 4] + a.m[4 + j] * b.m[i * 4 + 1] + a.m[8 + j] * b.m[i * 4 + 2] + a.m[12 + j] * b.m[i * 4 + 3];
+#endif
+	}
+
+	inline Mat4 operator*(const Mat4& b) const { Mat4 r; multiply(*this, b, r); return r; }
+
+	inline Vec4 operator*(const Vec4& v) const
+	{
+#ifdef MOTORMATH_SSE
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(m), _mm_set1_ps(v.x));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_set1_ps(v.y)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_set1_ps(v.z)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(v.w)));
+		return Vec4::store(r);
+#else
+		return Vec4(m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+			m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+			m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+			m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w);
+#endif
+	}
+
+	/// <summary>
+	/// Transforms a point, the translation is applied
+	/// </summary>
+	inline Vec3 transformPoint(const Vec3& p) const { return ((*this) * Vec4(p, 1)).xyz(); }
+
+	/// <summary>
+	/// Transforms a direction, the translation is not applied
+	/// </summary>
+	inline Vec3 transformVector(const Vec3& v) const { return ((*this) * Vec4(v, 0)).xyz(); }
+
+	inline Vec3 getTranslation() const { return Vec3(m[12], m[13], m[14]); }
+};
+
+#endif // !MAT4_H
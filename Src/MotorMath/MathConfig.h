@@ -0,0 +1,20 @@
+#pragma once
+#ifndef MATHCONFIG_H
+#define MATHCONFIG_H
+
+/*
+Shared by every module of the engine, it only has headers.
+
+The SSE path is used when the target has it (always on x64, and on x86 with /arch:SSE or higher).
+The loads and stores are unaligned, std::vector and the allocators of the engine don't guarantee
+16 byte alignment before C++17, and they cost the same as the aligned ones when the data is aligned.
+*/
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#define MOTORMATH_SSE
+#include <xmmintrin.h>
+#endif
+
+#define MOTORMATH_PI 3.14159265358979f
+
+#endif // !MATHCONFIG_H
@@ -0,0 +1,12 @@
+#pragma once
+#ifndef MOTORMATH_H
+#define MOTORMATH_H
+
+#include "MathConfig.h"
+#include "Vec3.h"
+#include "Vec4.h"
+#include "Quat.h"
+#include "Mat4.h"
+#include "Batch.h"
+
+#endif // !MOTORMATH_H
@@ -0,0 +1,27 @@
+#pragma once
+#ifndef OGREMATH_H
+#define OGREMATH_H
+
+#include "Vec3.h"
+#include "Quat.h"
+#include <OgreVector3.h>
+#include <OgreQuaternion.h>
+
+/*
+Conversions between the types of MotorMath and the ones of Ogre. Only for the modules that link Ogre.
+Ogre::Vector3 has the layout of Vec3 and is reinterpreted. Ogre::Quaternion has the components in
+the order w, x, y, z, so it's copied.
+*/
+
+static_assert(sizeof(Vec3) == sizeof(Ogre::Vector3), "Vec3 must have the layout of Ogre::Vector3, Ogre must use float as Real");
+
+inline const Ogre::Vector3& toOgre(const Vec3& v) { return reinterpret_cast<const Ogre::Vector3&>(v); }
+inline const Ogre::Vector3* toOgre(const Vec3* v) { return reinterpret_cast<const Ogre::Vector3*>(v); }
+
+inline const Vec3& fromOgre(const Ogre::Vector3& v) { return reinterpret_cast<const Vec3&>(v); }
+
+inline Ogre::Quaternion toOgre(const Quat& q) { return Ogre::Quaternion(q.w, q.x, q.y, q.z); }
+
+inline Quat fromOgre(const Ogre::Quaternion& q) { return Quat(q.x, q.y, q.z, q.w); }
+
+#endif // !OGREMATH_H
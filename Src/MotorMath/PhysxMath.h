@@ -0,0 +1,28 @@
+#pragma once
+#ifndef PHYSXMATH_H
+#define PHYSXMATH_H
+
+#include "Vec3.h"
+#include "Quat.h"
+#include "foundation/PxVec3.h"
+#include "foundation/PxQuat.h"
+
+/*
+Conversions between the types of MotorMath and the ones of PhysX. Only for the modules that link PhysX.
+The layouts are the same, so the references are reinterpreted and nothing is copied.
+*/
+
+static_assert(sizeof(Vec3) == sizeof(physx::PxVec3), "Vec3 must have the layout of physx::PxVec3");
+static_assert(sizeof(Quat) == sizeof(physx::PxQuat), "Quat must have the layout of physx::PxQuat");
+
+inline const physx::PxVec3& toPx(const Vec3& v) { return reinterpret_cast<const physx::PxVec3&>(v); }
+inline physx::PxVec3& toPx(Vec3& v) { return reinterpret_cast<physx::PxVec3&>(v); }
+inline const physx::PxVec3* toPx(const Vec3* v) { return reinterpret_cast<const physx::PxVec3*>(v); }
+
+inline const Vec3& fromPx(const physx::PxVec3& v) { return reinterpret_cast<const Vec3&>(v); }
+inline const Vec3* fromPx(const physx::PxVec3* v) { return reinterpret_cast<const Vec3*>(v); }
+
+inline const physx::PxQuat& toPx(const Quat& q) { return reinterpret_cast<const physx::PxQuat&>(q); }
+inline const Quat& fromPx(const physx::PxQuat& q) { return reinterpret_cast<const Quat&>(q); }
+
+#endif // !PHYSXMATH_H
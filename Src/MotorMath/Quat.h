@@ -0,0 +1,116 @@
+#pragma once
+#ifndef QUAT_H
+#define QUAT_H
+
+#include "MathConfig.h"
+#include "Vec3.h"
+#include <cmath>
+
+/// <summary>
+/// Rotation quaternion. The components are in the order of physx::PxQuat, so it can be reinterpreted as it (PhysxMath.h)
+/// </summary>
+struct Quat {
+	float x, y, z, w;
+
+	/// <summary>
+	/// The identity
+	/// </summary>
+	Quat() : x(0), y(0), z(0), w(1) {}
+	Quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+	/// <summary>
+	/// Rotation of angles (radians) around the X, Y and Z axes, applied in that order: Rz * Ry * Rx
+	/// </summary>
+	static inline Quat fromEuler(float x, float y, float z)
+	{
+		float cx = std::cos(x * 0.5f), sx = std::sin(x * 0.5f);
+		float cy = std::cos(y * 0.5f), sy = std::sin(y * 0.5f);
+		float cz = std::cos(z * 0.5f), sz = std::sin(z * 0.5f);
+
+		return Quat(cz * cy * sx - sz * sy * cx,
+			cz * sy * cx + sz * cy * sx,
+			sz * cy * cx - cz * sy * sx,
+			cz * cy * cx + sz * sy * sx);
+	}
+
+	static inline Quat fromEuler(const Vec3& angles) { return fromEuler(angles.x, angles.y, angles.z); }
+
+	/// <summary>
+	/// Rotation of angle (radians) around a normalized axis
+	/// </summary>
+	static inline Quat fromAxisAngle(const Vec3& axis, float angle)
+	{
+		float s = std::sin(angle * 0.5f);
+		return Quat(axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f));
+	}
+
+	/// <summary>
+	/// Inverse of fromEuler, the angle around Y is in [-PI/2, PI/2]
+	/// </summary>
+	inline Vec3 toEuler() const
+	{
+		Vec3 angles;
+		angles.x = std::atan2(2 * (w * x + y * z), 1 - 2 * (x * x + y * y));
+
+		float sinY = 2 * (w * y - z * x);
+		if (std::abs(sinY) >= 1)
+			angles.y = std::copysign(MOTORMATH_PI / 2, sinY);
+		else
+			angles.y = std::asin(sinY);
+
+		angles.z = std::atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z));
+		return angles;
+	}
+
+	/// <summary>
+	/// Rotation q followed by this one
+	/// </summary>
+	inline Quat operator*(const Quat& q) const
+	{
+		return Quat(w * q.x + x * q.w + y * q.z - z * q.y,
+			w * q.y - x * q.z + y * q.w + z * q.x,
+			w * q.z + x * q.y - y * q.x + z * q.w,
+			w * q.w - x * q.x - y * q.y - z * q.z);
+	}
+
+	inline bool operator==(const Quat& q) const { return x == q.x && y == q.y && z == q.z && w == q.w; }
+	inline bool operator!=(const Quat& q) const { return !(*this == q); }
+
+	/// <summary>
+	/// Inverse of a normalized quaternion
+	/// </summary>
+	inline Quat conjugate() const { return Quat(-x, -y, -z, w); }
+
+	inline float dot(const Quat& q) const { return x * q.x + y * q.y + z * q.z + w * q.w; }
+
+	inline Quat normalized() const
+	{
+		float l = std::sqrt(dot(*this));
+		if (l <= 0) return Quat();
+		float inv = 1.0f / l;
+		return Quat(x * inv, y * inv, z * inv, w * inv);
+	}
+
+	/// <summary>
+	/// Normalized linear interpolation by the shortest path, a when t is 0 and b when t is 1.
+	/// Close to slerp for the small rotations between two frames, and much cheaper
+	/// </summary>
+	static inline Quat nlerp(const Quat& a, const Quat& b, float t)
+	{
+		float s = a.dot(b) < 0 ? -t : t;
+		float u = 1.0f - t;
+		return Quat(a.x * u + b.x * s, a.y * u + b.y * s, a.z * u + b.z * s, a.w * u + b.w * s).normalized();
+	}
+
+	/// <summary>
+	/// Rotates a vector, the quaternion must be normalized
+	/// </summary>
+	inline Vec3 rotate(const Vec3& v) const
+	{
+		Vec3 u(x, y, z);
+		Vec3 t = u.cross(v) * 2.0f;
+		return v + t * w + u.cross(t);
+	}
+};
+
+#endif // !QUAT_H
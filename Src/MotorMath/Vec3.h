@@ -0,0 +1,56 @@
+#pragma once
+#ifndef VEC3_H
+#define VEC3_H
+
+#include <cmath>
+
+/// <summary>
+/// Vector of 3 floats. It has the layout of physx::PxVec3 and Ogre::Vector3, so arrays of it can be
+/// reinterpreted as arrays of them (PhysxMath.h and OgreMath.h)
+/// </summary>
+struct Vec3 {
+	float x, y, z;
+
+	Vec3() : x(0), y(0), z(0) {}
+	Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+	inline Vec3 operator+(const Vec3& v) const { return Vec3(x + v.x, y + v.y, z + v.z); }
+	inline Vec3 operator-(const Vec3& v) const { return Vec3(x - v.x, y - v.y, z - v.z); }
+	inline Vec3 operator-() const { return Vec3(-x, -y, -z); }
+	inline Vec3 operator*(float s) const { return Vec3(x * s, y * s, z * s); }
+	inline Vec3 operator/(float s) const { float inv = 1.0f / s; return Vec3(x * inv, y * inv, z * inv); }
+
+	/// <summary>
+	/// Component by component product
+	/// </summary>
+	inline Vec3 operator*(const Vec3& v) const { return Vec3(x * v.x, y * v.y, z * v.z); }
+	inline Vec3 operator/(const Vec3& v) const { return Vec3(x / v.x, y / v.y, z / v.z); }
+
+	inline Vec3& operator+=(const Vec3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+	inline Vec3& operator-=(const Vec3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+	inline Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+
+	inline bool operator==(const Vec3& v) const { return x == v.x && y == v.y && z == v.z; }
+	inline bool operator!=(const Vec3& v) const { return x != v.x || y != v.y || z != v.z; }
+
+	inline float dot(const Vec3& v) const { return x * v.x + y * v.y + z * v.z; }
+	inline Vec3 cross(const Vec3& v) const { return Vec3(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x); }
+
+	inline float lengthSquared() const { return x * x + y * y + z * z; }
+	inline float length() const { return std::sqrt(lengthSquared()); }
+
+	/// <summary>
+	/// Returns the vector with length 1, or the zero vector if it has no length
+	/// </summary>
+	inline Vec3 normalized() const {
+		float l = length();
+		return l > 0 ? (*this) / l : Vec3();
+	}
+
+	/// <summary>
+	/// Linear interpolation, a when t is 0 and b when t is 1
+	/// </summary>
+	static inline Vec3 lerp(const Vec3& a, const Vec3& b, float t) { return a + (b - a) * t; }
+};
+
+#endif // !VEC3_H
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef VEC4_H
+#define VEC4_H
+
+#include "MathConfig.h"
+#include "Vec3.h"
+
+/// <summary>
+/// Vector of 4 floats, it fits in a SSE register
+/// </summary>
+struct alignas(16) Vec4 {
+	float x, y, z, w;
+
+	Vec4() : x(0), y(0), z(0), w(0) {}
+	Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+	Vec4(const Vec3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+	inline Vec3 xyz() const { return Vec3(x, y, z); }
+
+#ifdef MOTORMATH_SSE
+	inline __m128 load() const { return _mm_loadu_ps(&x); }
+	static inline Vec4 store(__m128 r) { Vec4 v; _mm_storeu_ps(&v.x, r); return v; }
+
+	inline Vec4 operator+(const Vec4& v) const { return store(_mm_add_ps(load(), v.load())); }
+	inline Vec4 operator-(const Vec4& v) const { return store(_mm_sub_ps(load(), v.load())); }
+	inline Vec4 operator*(const Vec4& v) const { return store(_mm_mul_ps(load(), v.load())); }
+	inline Vec4 operator*(float s) const { return store(_mm_mul_ps(load(), _mm_set1_ps(s))); }
+#else
+	inline Vec4 operator+(const Vec4& v) const { return Vec4(x + v.x, y + v.y, z + v.z, w + v.w); }
+	inline Vec4 operator-(const Vec4& v) const { return Vec4(x - v.x, y - v.y, z - v.z, w - v.w); }
+	inline Vec4 operator*(const Vec4& v) const { return Vec4(x * v.x, y * v.y, z * v.z, w * v.w); }
+	inline Vec4 operator*(float s) const { return Vec4(x * s, y * s, z * s, w * s); }
+#endif
+
+	inline bool operator==(const Vec4& v) const { return x == v.x && y == v.y && z == v.z && w == v.w; }
+	inline bool operator!=(const Vec4& v) const { return !(*this == v); }
+
+	inline float dot(const Vec4& v) const { return x * v.x + y * v.y + z * v.z + w * v.w; }
+};
+
+#endif // !VEC4_H
@@ -0,0 +1,32 @@
+#include "ActivatableComponent.h"
+#include "ActivationRegions.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "ComponentIDs.h"
+#include "includeLUA.h"
+
+ActivatableComponent::ActivatableComponent() : Component(ComponentId::Activatable), _tr(nullptr), _regionIndex(-1)
+{
+}
+
+ActivatableComponent::~ActivatableComponent()
+{
+	ActivationRegions::getInstance()->removeObject(this);
+}
+
+void ActivatableComponent::awake(luabridge::LuaRef& data)
+{
+	_tr = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
+	ActivationRegions::getInstance()->addObject(this);
+}
+
+void ActivatableComponent::onEnable()
+{
+	ActivationRegions::getInstance()->addObject(this);
+}
+
+void ActivatableComponent::onDisable()
+{
+	ActivationRegions::getInstance()->removeObject(this);
+	_gameObject->setDormant(false);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef ACTIVATABLECOMPONENT_H
+#define ACTIVATABLECOMPONENT_H
+
+#include "Component.h"
+
+class Transform;
+
+/// <summary>
+/// Makes the GameObject go dormant out of the regions of the activators, see ActivationRegions.
+/// A disabled Activatable keeps its GameObject awake
+/// </summary>
+class ActivatableComponent : public Component
+{
+public:
+
+	/// <summary>
+	/// Default constructor of the class
+	/// </summary>
+	ActivatableComponent();
+
+	/// <summary>
+	/// Destructor of the class
+	/// </summary>
+	~ActivatableComponent();
+
+	/// <summary>
+	/// Method to initialize required attributes for the component
+	/// </summary>
+	virtual void awake(luabridge::LuaRef& data) override;
+
+	/// <summary>
+	/// The component isn't called in any update phase
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::None; }
+
+	inline Transform* getTransform() const { return _tr; }
+
+protected:
+
+	void onEnable() override;
+
+	void onDisable() override;
+
+private:
+	friend class ActivationRegions;
+
+	Transform* _tr;
+	//Position in the objects of ActivationRegions, -1 if it isn't there
+	int _regionIndex;
+};
+
+#endif // !ACTIVATABLECOMPONENT_H
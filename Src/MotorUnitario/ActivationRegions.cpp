@@ -0,0 +1,114 @@
+#include "ActivationRegions.h"
+#include "ActivatableComponent.h"
+#include "GameObject.h"
+#include "Transform.h"
+
+#include <algorithm>
+
+std::unique_ptr<ActivationRegions> ActivationRegions::instance = nullptr;
+
+ActivationRegions::ActivationRegions() : _activators(), _centers(), _wakeDistances(), _sleepDistances(), _objects(),
+_next(0), _objectsPerUpdate(0), _dormantCount(0)
+{
+}
+
+ActivationRegions::~ActivationRegions()
+{
+}
+
+ActivationRegions* ActivationRegions::getInstance()
+{
+	if (instance.get() == nullptr) {
+		instance.reset(new ActivationRegions());
+	}
+	return instance.get();
+}
+
+void ActivationRegions::addActivator(Transform* transform, float radius, float margin)
+{
+	for (Activator& activator : _activators) {
+		if (activator.transform == transform) {
+			activator.radius = radius;
+			activator.margin = margin;
+			return;
+		}
+	}
+	_activators.push_back({ transform, radius, margin });
+}
+
+void ActivationRegions::removeActivator(Transform* transform)
+{
+	_activators.erase(std::remove_if(_activators.begin(), _activators.end(),
+		[transform](const Activator& activator) { return activator.transform == transform; }), _activators.end());
+}
+
+void ActivationRegions::addObject(ActivatableComponent* object)
+{
+	if (object->_regionIndex >= 0) return;
+
+	object->_regionIndex = (int)_objects.size();
+	_objects.push_back(object);
+	if (object->getGameObject()->isDormant()) ++_dormantCount;
+}
+
+void ActivationRegions::removeObject(ActivatableComponent* object)
+{
+	int index = object->_regionIndex;
+	if (index < 0) return;
+
+	if (object->getGameObject()->isDormant()) --_dormantCount;
+	_objects[index] = _objects.back();
+	_objects[index]->_regionIndex = index;
+	_objects.pop_back();
+	object->_regionIndex = -1;
+}
+
+void ActivationRegions::update()
+{
+	if (_objects.empty()) return;
+
+	if (_activators.empty()) {
+		//The regions are off, the objects left dormant by the last activator wake up
+		for (size_t i = 0; i < _objects.size() && _dormantCount > 0; ++i)
+			setDormant(_objects[i], false);
+		return;
+	}
+
+	size_t activators = _activators.size();
+	_centers.resize(activators);
+	_wakeDistances.resize(activators);
+	_sleepDistances.resize(activators);
+	for (size_t a = 0; a < activators; ++a) {
+		const Activator& activator = _activators[a];
+		_centers[a] = activator.transform->getWorldPosition().toVec3();
+		_wakeDistances[a] = activator.radius * activator.radius;
+		float sleepRadius = activator.radius + activator.margin;
+		_sleepDistances[a] = sleepRadius * sleepRadius;
+	}
+
+	size_t count = _objectsPerUpdate == 0 ? _objects.size() : std::min(_objectsPerUpdate, _objects.size());
+	for (size_t i = 0; i < count; ++i) {
+		if (_next >= _objects.size()) _next = 0;
+		ActivatableComponent* object = _objects[_next++];
+
+		bool dormant = object->getGameObject()->isDormant();
+		const std::vector<float>& distances = dormant ? _wakeDistances : _sleepDistances;
+		Vec3 position = object->getTransform()->getWorldPosition().toVec3();
+		bool inside = false;
+		for (size_t a = 0; a < activators && !inside; ++a)
+			inside = (position - _centers[a]).lengthSquared() <= distances[a];
+
+		if (inside == dormant)
+			setDormant(object, !inside);
+	}
+}
+
+void ActivationRegions::setDormant(ActivatableComponent* object, bool dormant)
+{
+	GameObject* go = object->getGameObject();
+	if (go->isDormant() == dormant) return;
+
+	go->setDormant(dormant);
+	if (dormant) ++_dormantCount;
+	else --_dormantCount;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef ACTIVATIONREGIONS_H
+#define ACTIVATIONREGIONS_H
+
+#include <memory>
+#include <vector>
+
+#include "MotorMath/Vec3.h"
+
+class Transform;
+class ActivatableComponent;
+
+/*
+Spheres around the activators (the player, the camera...) out of which the GameObjects with an Activatable
+component go dormant: their components aren't updated and their bodies aren't simulated, see GameObject::setDormant.
+They wake up as they were when an activator gets close again.
+
+A dormant object wakes up inside the radius of an activator, and an awake one goes dormant out of the radius plus
+the margin, so the objects on the border don't change every frame. Without activators every object is awake.
+*/
+
+class ActivationRegions
+{
+public:
+	~ActivationRegions();
+
+	/// <summary>
+	/// Returns the instance of ActivationRegions, in case there is no such instance, it creates one and returns that one
+	/// </summary>
+	static ActivationRegions* getInstance();
+	ActivationRegions& operator=(const ActivationRegions&) = delete;
+	ActivationRegions(ActivationRegions& other) = delete;
+
+	/// <summary>
+	/// Adds an activator, or changes the region of the one of that transform
+	/// </summary>
+	/// <param name="radius">Distance at which the objects wake up</param>
+	/// <param name="margin">Extra distance before the objects go dormant again</param>
+	void addActivator(Transform* transform, float radius, float margin);
+
+	void removeActivator(Transform* transform);
+
+	/// <summary>
+	/// Adds an object, it's awake until the next update puts it in its state
+	/// </summary>
+	void addObject(ActivatableComponent* object);
+
+	/// <summary>
+	/// Removes an object, it's left in the state it had
+	/// </summary>
+	void removeObject(ActivatableComponent* object);
+
+	/// <summary>
+	/// Objects checked by each update, the next update goes on from where this one stopped. 0 checks all of them
+	/// </summary>
+	inline void setObjectsPerUpdate(size_t count) { _objectsPerUpdate = count; }
+	inline size_t getObjectsPerUpdate() const { return _objectsPerUpdate; }
+
+	/// <summary>
+	/// Wakes up the objects that entered a region and puts to sleep those that left all of them. Called once per frame by the Engine
+	/// </summary>
+	void update();
+
+	inline size_t getObjectCount() const { return _objects.size(); }
+	inline size_t getDormantCount() const { return _dormantCount; }
+
+private:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	ActivationRegions();
+
+	/// <summary>
+	/// Changes the state of the object keeping the count of the dormant ones
+	/// </summary>
+	void setDormant(ActivatableComponent* object, bool dormant);
+
+	struct Activator {
+		Transform* transform;
+		float radius;
+		float margin;
+	};
+
+	static std::unique_ptr<ActivationRegions> instance;
+
+	std::vector<Activator> _activators;
+	//World positions of the activators in the current update, and the squared distances to wake up and to go dormant
+	std::vector<Vec3> _centers;
+	std::vector<float> _wakeDistances;
+	std::vector<float> _sleepDistances;
+	//Unordered, a removed object is replaced by the last one
+	std::vector<ActivatableComponent*> _objects;
+	//Next object to check
+	size_t _next;
+	size_t _objectsPerUpdate;
+	size_t _dormantCount;
+};
+
+#endif // !ACTIVATIONREGIONS_H
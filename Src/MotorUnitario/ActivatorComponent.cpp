@@ -0,0 +1,44 @@
+#include "ActivatorComponent.h"
+#include "ActivationRegions.h"
+#include "GameObject.h"
+#include "Transform.h"
+#include "ComponentIDs.h"
+#include "includeLUA.h"
+
+ActivatorComponent::ActivatorComponent() : Component(ComponentId::Activator), _tr(nullptr), _radius(100), _margin(10)
+{
+}
+
+ActivatorComponent::~ActivatorComponent()
+{
+	ActivationRegions::getInstance()->removeActivator(_tr);
+}
+
+void ActivatorComponent::awake(luabridge::LuaRef& data)
+{
+	if (LUAFIELDEXIST(Radius)) _radius = GETLUAFIELD(Radius, float);
+	//By default the objects go dormant a tenth of the radius farther than they wake up
+	_margin = _radius * 0.1f;
+	if (LUAFIELDEXIST(Margin)) _margin = GETLUAFIELD(Margin, float);
+
+	_tr = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
+	ActivationRegions::getInstance()->addActivator(_tr, _radius, _margin);
+}
+
+void ActivatorComponent::setRadius(float radius, float margin)
+{
+	_radius = radius;
+	_margin = margin;
+	if (getEnabled())
+		ActivationRegions::getInstance()->addActivator(_tr, _radius, _margin);
+}
+
+void ActivatorComponent::onEnable()
+{
+	ActivationRegions::getInstance()->addActivator(_tr, _radius, _margin);
+}
+
+void ActivatorComponent::onDisable()
+{
+	ActivationRegions::getInstance()->removeActivator(_tr);
+}
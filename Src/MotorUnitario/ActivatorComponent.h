@@ -0,0 +1,58 @@
+#pragma once
+#ifndef ACTIVATORCOMPONENT_H
+#define ACTIVATORCOMPONENT_H
+
+#include "Component.h"
+
+class Transform;
+
+/// <summary>
+/// Center of an activation region, the GameObjects with an Activatable wake up around it. See ActivationRegions
+/// </summary>
+class ActivatorComponent : public Component
+{
+public:
+
+	/// <summary>
+	/// Default constructor of the class
+	/// </summary>
+	ActivatorComponent();
+
+	/// <summary>
+	/// Destructor of the class
+	/// </summary>
+	~ActivatorComponent();
+
+	/// <summary>
+	/// Method to initialize required attributes for the component
+	/// </summary>
+	virtual void awake(luabridge::LuaRef& data) override;
+
+	/// <summary>
+	/// The component isn't called in any update phase
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::None; }
+
+	/// <summary>
+	/// Changes the region of the activator
+	/// </summary>
+	/// <param name="radius">Distance at which the objects wake up</param>
+	/// <param name="margin">Extra distance before the objects go dormant again</param>
+	void setRadius(float radius, float margin);
+
+	inline float getRadius() const { return _radius; }
+	inline float getMargin() const { return _margin; }
+
+protected:
+
+	void onEnable() override;
+
+	void onDisable() override;
+
+private:
+	Transform* _tr;
+	float _radius;
+	float _margin;
+};
+
+#endif // !ACTIVATORCOMPONENT_H
@@ -44,6 +44,11 @@ public:
 	/// </summary>
 	void lateUpdate() override;
 
+	/// <summary>
+	/// The component is only called in LateUpdate
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::LateUpdate); }
+
 	/// <summary>
 	/// Sets the initial state, searches for such state by name
 	/// </summary>
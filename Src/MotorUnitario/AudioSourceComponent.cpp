@@ -8,7 +8,7 @@
 #include "Exceptions.h"
 
 
-AudioSourceComponent::AudioSourceComponent() : Component(ComponentId::AudioSource), _audioSource(nullptr), _tr(nullptr), _route(), _stopOnDestroy(true)
+AudioSourceComponent::AudioSourceComponent() : Component(ComponentId::AudioSource), _audioSource(nullptr), _tr(nullptr), _syncedVersion(0), _route(), _stopOnDestroy(true)
 {
 	_audioSource = new AudioSource();
 }
@@ -114,9 +114,13 @@ void AudioSourceComponent::start()
 
 void AudioSourceComponent::update()
 {
-	float x = static_cast<float>(_tr->getPosition().getX());
-	float y = static_cast<float>(_tr->getPosition().getY());
-	float z = static_cast<float>(_tr->getPosition().getZ());
+	if (_tr->getWorldVersion() == _syncedVersion) return;
+	_syncedVersion = _tr->getWorldVersion();
+
+	Vector3 position = _tr->getWorldPosition();
+	float x = static_cast<float>(position.getX());
+	float y = static_cast<float>(position.getY());
+	float z = static_cast<float>(position.getZ());
 	_audioSource->setPosition(x, y, z);
 }
 
@@ -125,6 +129,11 @@ void AudioSourceComponent::lateUpdate()
 	_audioSource->update();
 }
 
+bool AudioSourceComponent::isParallelSafe(UpdatePhase::UpdatePhase phase) const
+{
+	return phase == UpdatePhase::Update || phase == UpdatePhase::LateUpdate;
+}
+
 void AudioSourceComponent::createAudioInChannel()
 {
 	_audioSource->createAudio();
@@ -38,6 +38,15 @@ public:
 	/// Called each frame after update. 
 	/// </summary>
 	virtual void lateUpdate() override;
+
+	/// <summary>
+	/// The component is only called in Update and LateUpdate
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update) | UpdatePhase::mask(UpdatePhase::LateUpdate); }
+	/// <summary>
+	/// Update and lateUpdate only move their own FMOD channels, so they can run in parallel
+	/// </summary>
+	virtual bool isParallelSafe(UpdatePhase::UpdatePhase phase) const override;
 	/// <summary>
 	/// Create an audio. You MUST change the route before create it.
 	/// </summary>
@@ -112,6 +121,8 @@ private:
 
 	AudioSource* _audioSource;
 	Transform* _tr;
+	//Version of the transform copied last time, see Transform::getWorldVersion
+	unsigned int _syncedVersion;
 	// Sound routes
 	std::vector<std::string> _route;
 
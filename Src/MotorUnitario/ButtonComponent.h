@@ -39,6 +39,11 @@ public:
 	/// </summary>
 	virtual void update() override;
 
+	/// <summary>
+	/// The component is only called in Update
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update); }
+
 	/// <summary>
 	/// Hide or show the button graphically. Also stop being active.
 	/// </summary>
@@ -55,7 +55,7 @@ void CameraComponent::awake(luabridge::LuaRef& data)
 	}
 }
 
-CameraComponent::CameraComponent() : Component(ComponentId::Camera), _camera(nullptr), _tr(nullptr), _slaveRotation(false)
+CameraComponent::CameraComponent() : Component(ComponentId::Camera), _camera(nullptr), _tr(nullptr), _syncedVersion(0), _interpolating(false), _slaveRotation(false)
 {
 }
 
@@ -68,18 +68,22 @@ void CameraComponent::start()
 {
 	_tr = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
 
-	Vector3 rot = _tr->getRotation();
-	_camera->setOrientation(rot.getX(), rot.getY(), rot.getZ());
+	_camera->setOrientation(_tr->getOrientation());
 }
 
 void CameraComponent::update()
 {
-	Vector3 pos = _tr->getPosition();
-	_camera->setPosition(static_cast<float>(pos.getX()), static_cast<float>(pos.getY()), static_cast<float>(pos.getZ()));
+	//A camera that follows a body is blended between two physics steps like the render objects
+	bool interpolated = _tr->isInterpolated();
+	if (!interpolated && !_interpolating && _tr->getWorldVersion() == _syncedVersion) return;
+	_syncedVersion = _tr->getWorldVersion();
+	_interpolating = interpolated;
+
+	Vec3 pos = _tr->getInterpolatedPosition();
+	_camera->setPosition(pos.x, pos.y, pos.z);
 
 	if (_slaveRotation) {
-		Vector3 rot = _tr->getRotation();
-		_camera->setOrientation(rot.getX(), rot.getY(), rot.getZ());
+		_camera->setOrientation(_tr->getInterpolatedOrientation());
 	}
 }
 
@@ -173,8 +177,7 @@ void CameraComponent::setViewportDimensions(float left, float top, float w, floa
 
 Vector3 CameraComponent::getOrientation()
 {
-	std::tuple<float, float, float> rot = _camera->getOrientation();
-	return Vector3(std::get<0>(rot), std::get<1>(rot), std::get<2>(rot));
+	return _camera->getOrientation();
 }
 
 void CameraComponent::setCompositor(const char* compositor, bool enable)
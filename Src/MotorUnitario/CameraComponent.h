@@ -38,6 +38,11 @@ public:
 	/// </summary>
 	virtual void update() override;
 
+	/// <summary>
+	/// The component is only called in Update
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update); }
+
 	/// <summary>
 	/// Rotate the camera "angle" angles in the given axis
 	/// </summary>
@@ -169,6 +174,10 @@ private:
 
 	Camera* _camera;
 	Transform* _tr;
+	//Version of the transform copied last time, see Transform::getWorldVersion
+	unsigned int _syncedVersion;
+	//The camera was blended between two physics steps last frame
+	bool _interpolating;
 
 	bool _slaveRotation;
 };
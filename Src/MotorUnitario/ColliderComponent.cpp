@@ -1,10 +1,52 @@
 #include "ColliderComponent.h"
 #include "MotorFisico/Collider.h"
+#include "MotorFisico/CollisionLayers.h"
+#include "MotorFisico/PhysxEngine.h"
+#include "MotorFisico/PhysicsCache.h"
+#include "MotorFisico/MeshCooker.h"
+#include "MotorGrafico/RenderObject.h"
 #include "GameObject.h"
 #include "ComponentIDs.h"
 #include "Transform.h"
+#include "Logger.h"
+#include "Engine.h"
+#include "Exceptions.h"
 #include "includeLUA.h"
 #include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+	/// <summary>
+	/// Scale of the mesh that matches the RenderObject, which scales the mesh so its largest side is the size of the transform
+	/// </summary>
+	/// <param name="size">Size of the bounds of the mesh</param>
+	Vec3 getRenderScale(const Vec3& size, const Transform* t)
+	{
+		float maxSize = std::max({ size.x, size.y, size.z });
+		if (maxSize <= 0) maxSize = 1;
+		return t->getScale().toVec3() / maxSize;
+	}
+
+	/// <summary>
+	/// Readers of the .mesh for the MeshCooker, the file is read once and its triangles only when it hasn't been cooked
+	/// </summary>
+	MeshCooker::SourceReader meshFileReader(const std::string& meshName, std::vector<unsigned char>& data)
+	{
+		return [&meshName, &data](std::vector<unsigned char>& source) {
+			if (data.empty()) RenderObject::readMeshFile(meshName, data);
+			source = data;
+		};
+	}
+
+	MeshCooker::TriangleReader meshTriangleReader(const std::string& meshName, std::vector<unsigned char>& data)
+	{
+		return [&meshName, &data](std::vector<Vec3>& vertices, std::vector<uint32_t>& indices) {
+			if (data.empty()) RenderObject::readMeshFile(meshName, data);
+			RenderObject::readMeshTriangles(meshName, data, vertices, indices);
+		};
+	}
+}
 
 ColliderComponent::ColliderComponent(int id) : Component(id, nullptr), _collider(nullptr)
 {
@@ -12,7 +54,8 @@ ColliderComponent::ColliderComponent(int id) : Component(id, nullptr), _collider
 
 void ColliderComponent::onEnable()
 {
-	_collider->enable();
+	if (!_gameObject->isDormant())
+		_collider->enable();
 }
 
 void ColliderComponent::onDisable()
@@ -20,6 +63,13 @@ void ColliderComponent::onDisable()
 	_collider->disable();
 }
 
+void ColliderComponent::onDormant(bool dormant)
+{
+	if (!getEnabled()) return;
+	if (dormant) _collider->disable();
+	else _collider->enable();
+}
+
 ColliderComponent::~ColliderComponent()
 {
 	delete _collider; _collider == nullptr;
@@ -35,12 +85,72 @@ void ColliderComponent::setTrigger() {
 
 void ColliderComponent::setPosition(Vector3 pos)
 {
-	_collider->setPosition(pos.toTuple());
+	_collider->setPosition(pos.toVec3());
 }
 
 void ColliderComponent::setRotation(Vector3 rot)
 {
-	_collider->setRotation(rot.toTuple());
+	_collider->setRotation(rot.toVec3());
+}
+
+void ColliderComponent::setOrientation(const Quat& orientation)
+{
+	_collider->setOrientation(orientation);
+}
+
+CollisionBody* ColliderComponent::getCollisionBody() const
+{
+	return _collider;
+}
+
+bool ColliderComponent::setLayer(const std::string& name)
+{
+	int layer = CollisionLayers::getInstance()->getLayer(name);
+	if (layer < 0) {
+		Logger::getInstance()->log("There is no collision layer " + name + ", " + _gameObject->getName() + " stays in its layer", Logger::Level::WARN);
+		return false;
+	}
+	_collider->setLayer(layer);
+	return true;
+}
+
+void ColliderComponent::readMaterial(const std::string& name, float& staticFriction, float& dynamicFriction, float& restitution) const
+{
+	const MaterialDesc* material = PhysxEngine::getPxInstance()->getCache()->findMaterial(name);
+	if (material == nullptr) {
+		Logger::getInstance()->log("There is no physics material " + name + ", " + _gameObject->getName() + " uses its own values", Logger::Level::WARN);
+		return;
+	}
+	staticFriction = material->staticFriction;
+	dynamicFriction = material->dynamicFriction;
+	restitution = material->restitution;
+}
+
+void ColliderComponent::awake(luabridge::LuaRef& data)
+{
+	std::unique_ptr<ComponentState> state(readState(data));
+	awakeFromState(*state);
+}
+
+void ColliderComponent::readColliderState(luabridge::LuaRef& data, ColliderState& state) const
+{
+	if (LUAFIELDEXIST(IsTrigger)) state.isTrigger = GETLUAFIELD(IsTrigger, bool);
+	if (LUAFIELDEXIST(StaticFriction)) state.staticFriction = GETLUAFIELD(StaticFriction, float);
+	if (LUAFIELDEXIST(DynamicFriction)) state.dynamicFriction = GETLUAFIELD(DynamicFriction, float);
+	if (LUAFIELDEXIST(Restitution)) state.restitution = GETLUAFIELD(Restitution, float);
+	if (LUAFIELDEXIST(Material)) state.material = GETLUASTRINGFIELD(Material);
+	//Only the scene can say a collider is part of the scenery, gameplay may move the others through their Transform
+	//and a static actor would pay for every move
+	if (LUAFIELDEXIST(Static)) state.isStatic = GETLUAFIELD(Static, bool);
+	if (LUAFIELDEXIST(Layer)) state.layer = GETLUASTRINGFIELD(Layer);
+}
+
+void ColliderComponent::getMaterial(const ColliderState& state, float& staticFriction, float& dynamicFriction, float& restitution) const
+{
+	staticFriction = state.staticFriction;
+	dynamicFriction = state.dynamicFriction;
+	restitution = state.restitution;
+	if (!state.material.empty()) readMaterial(state.material, staticFriction, dynamicFriction, restitution);
 }
 
 /////////////////////////////////////////////
@@ -52,37 +162,42 @@ BoxColliderComponent::BoxColliderComponent() : ColliderComponent(ComponentId::Bo
 }
 
 
-void BoxColliderComponent::awake(luabridge::LuaRef& data)
+ComponentState* BoxColliderComponent::readState(luabridge::LuaRef& data) const
 {
-	float width = 1;
-	if (LUAFIELDEXIST(Width)) width = GETLUAFIELD(Width, float);
-	float height = 1;
-	if (LUAFIELDEXIST(Height)) height = GETLUAFIELD(Height, float);
-	float depth = 1;
-	if (LUAFIELDEXIST(Depth)) depth = GETLUAFIELD(Depth, float);
+	State* state = new State();
+	readColliderState(data, *state);
+	if (LUAFIELDEXIST(Width)) state->width = GETLUAFIELD(Width, float);
+	if (LUAFIELDEXIST(Height)) state->height = GETLUAFIELD(Height, float);
+	if (LUAFIELDEXIST(Depth)) state->depth = GETLUAFIELD(Depth, float);
+	return state;
+}
+
+void BoxColliderComponent::awakeFromState(const ComponentState& state)
+{
+	const State& values = static_cast<const State&>(state);
 
-	bool isTrigger = false;
-	if (LUAFIELDEXIST(IsTrigger)) isTrigger = GETLUAFIELD(IsTrigger, bool);
+	//The actor loaded from the physics collection of the level already has its shape, material and layer
+	physx::PxRigidActor* loaded = Engine::getInstance()->takeLoadedActor(_gameObject, getId());
+	if (loaded != nullptr) {
+		_collider = new BoxCollider(loaded, _gameObject, gameObjectsCollision, gameObjectTriggered);
+		return;
+	}
 
-	float staticFriction = 0.5f;
-	if (LUAFIELDEXIST(StaticFriction)) staticFriction = GETLUAFIELD(StaticFriction, float);
-	float dynamicFriction = 0.5f;
-	if (LUAFIELDEXIST(DynamicFriction)) dynamicFriction = GETLUAFIELD(DynamicFriction, float);
-	float restitution = 0.5f;
-	if (LUAFIELDEXIST(Restitution)) restitution = GETLUAFIELD(Restitution, float);
+	float staticFriction, dynamicFriction, restitution;
+	getMaterial(values, staticFriction, dynamicFriction, restitution);
 
 	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
-	std::tuple<float, float, float> pos = t->getPosition().toTuple();
-	std::tuple<float, float, float> rot = t->getRotation().toTuple();
+	Vec3 pos = t->getPosition().toVec3();
 	
 	Vector3 scale = t->getSize();
-	width *= scale.getX();
-	height *= scale.getY();
-	depth *= scale.getZ();
-
-	_collider = new BoxCollider(width, height, depth, isTrigger, _gameObject, _gameObject->getName(),
-		gameObjectsCollision, gameObjectTriggered, pos, staticFriction, dynamicFriction, restitution);
-	_collider->setRotation(rot);
+	float width = values.width * scale.getX();
+	float height = values.height * scale.getY();
+	float depth = values.depth * scale.getZ();
+
+	_collider = new BoxCollider(width, height, depth, values.isTrigger, _gameObject, _gameObject->getName(),
+		gameObjectsCollision, gameObjectTriggered, pos, staticFriction, dynamicFriction, restitution, values.isStatic);
+	_collider->setOrientation(t->getOrientation());
+	if (!values.layer.empty()) setLayer(values.layer);
 }
 
 void BoxColliderComponent::setScale(float width, float heigh, float depth)
@@ -115,28 +230,34 @@ SphereColliderComponent::SphereColliderComponent() : ColliderComponent(Component
 }
 
 
-void SphereColliderComponent::awake(luabridge::LuaRef& data)
+ComponentState* SphereColliderComponent::readState(luabridge::LuaRef& data) const
+{
+	State* state = new State();
+	readColliderState(data, *state);
+	if (LUAFIELDEXIST(Radius)) state->radius = GETLUAFIELD(Radius, float);
+	return state;
+}
+
+void SphereColliderComponent::awakeFromState(const ComponentState& state)
 {
-	float radius = 2;
-	if (LUAFIELDEXIST(Radius))radius = GETLUAFIELD(Radius, float);
+	const State& values = static_cast<const State&>(state);
 
-	bool isTrigger = false;
-	if (LUAFIELDEXIST(IsTrigger)) isTrigger = GETLUAFIELD(IsTrigger, bool);
+	physx::PxRigidActor* loaded = Engine::getInstance()->takeLoadedActor(_gameObject, getId());
+	if (loaded != nullptr) {
+		_collider = new SphereCollider(loaded, _gameObject, gameObjectsCollision, gameObjectTriggered);
+		return;
+	}
 
-	float staticFriction = 0.5f;
-	if (LUAFIELDEXIST(StaticFriction)) staticFriction = GETLUAFIELD(StaticFriction, float);
-	float dynamicFriction = 0.5f;
-	if (LUAFIELDEXIST(DynamicFriction)) dynamicFriction = GETLUAFIELD(DynamicFriction, float);
-	float restitution = 0.5f;
-	if (LUAFIELDEXIST(Restitution)) restitution = GETLUAFIELD(Restitution, float);
+	float staticFriction, dynamicFriction, restitution;
+	getMaterial(values, staticFriction, dynamicFriction, restitution);
 
 	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
-	std::tuple<float, float, float> pos = t->getPosition().toTuple();
-	std::tuple<float, float, float> rot = t->getRotation().toTuple();
+	Vec3 pos = t->getPosition().toVec3();
 
-	_collider = new SphereCollider(radius, isTrigger, _gameObject, _gameObject->getName(),
-		gameObjectsCollision, gameObjectTriggered, pos, staticFriction, dynamicFriction, restitution);
-	_collider->setRotation(rot);
+	_collider = new SphereCollider(values.radius, values.isTrigger, _gameObject, _gameObject->getName(),
+		gameObjectsCollision, gameObjectTriggered, pos, staticFriction, dynamicFriction, restitution, values.isStatic);
+	_collider->setOrientation(t->getOrientation());
+	if (!values.layer.empty()) setLayer(values.layer);
 }
 
 void SphereColliderComponent::setScale(float radius)
@@ -158,36 +279,41 @@ CapsuleColliderComponent::CapsuleColliderComponent() : ColliderComponent(Compone
 
 }
 
-void CapsuleColliderComponent::awake(luabridge::LuaRef& data)
+ComponentState* CapsuleColliderComponent::readState(luabridge::LuaRef& data) const
+{
+	State* state = new State();
+	readColliderState(data, *state);
+	if (LUAFIELDEXIST(Radius)) state->radius = GETLUAFIELD(Radius, float);
+	if (LUAFIELDEXIST(Length)) state->length = GETLUAFIELD(Length, float);
+	return state;
+}
+
+void CapsuleColliderComponent::awakeFromState(const ComponentState& state)
 {
-	float radius = 1;
-	if (LUAFIELDEXIST(Radius)) radius = GETLUAFIELD(Radius, float);
-	float length = 3;
-	if (LUAFIELDEXIST(Length)) length = GETLUAFIELD(Length, float);
+	const State& values = static_cast<const State&>(state);
 
-	bool isTrigger = false;
-	if (LUAFIELDEXIST(IsTrigger)) isTrigger = GETLUAFIELD(IsTrigger, bool);
+	physx::PxRigidActor* loaded = Engine::getInstance()->takeLoadedActor(_gameObject, getId());
+	if (loaded != nullptr) {
+		_collider = new CapsuleCollider(loaded, _gameObject, gameObjectsCollision, gameObjectTriggered);
+		return;
+	}
 
-	float staticFriction = 0.5f;
-	if (LUAFIELDEXIST(StaticFriction)) staticFriction = GETLUAFIELD(StaticFriction, float);
-	float dynamicFriction = 0.5f;
-	if (LUAFIELDEXIST(DynamicFriction)) dynamicFriction = GETLUAFIELD(DynamicFriction, float);
-	float restitution = 0.5f;
-	if (LUAFIELDEXIST(Restitution)) restitution = GETLUAFIELD(Restitution, float);
+	float staticFriction, dynamicFriction, restitution;
+	getMaterial(values, staticFriction, dynamicFriction, restitution);
 
 	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
-	std::tuple<float, float, float> pos = t->getPosition().toTuple();
-	std::tuple<float, float, float> rot = t->getRotation().toTuple();
+	Vec3 pos = t->getPosition().toVec3();
 	
 	Vector3 scale = t->getSize();
-	radius *= std::max({ scale.getX(), scale.getZ() });
+	float radius = values.radius * std::max({ scale.getX(), scale.getZ() });
 	radius /= 2;
-	length *= scale.getY();
+	float length = values.length * scale.getY();
 	length = abs(length - radius);
 
-	_collider = new CapsuleCollider(radius, length, isTrigger, _gameObject, _gameObject->getName(),
-		gameObjectsCollision, gameObjectTriggered, pos, staticFriction, dynamicFriction, restitution);
-	_collider->setRotation(rot);
+	_collider = new CapsuleCollider(radius, length, values.isTrigger, _gameObject, _gameObject->getName(),
+		gameObjectsCollision, gameObjectTriggered, pos, staticFriction, dynamicFriction, restitution, values.isStatic);
+	_collider->setOrientation(t->getOrientation());
+	if (!values.layer.empty()) setLayer(values.layer);
 }
 
 void CapsuleColliderComponent::setScale(float radius, float length)
@@ -207,14 +333,145 @@ float CapsuleColliderComponent::getHeight()
 
 }
 
-void ColliderComponent::gameObjectsCollision(GameObject* thisGO, GameObject* otherGO)
+/////////////////////////////////////////////////////////
+
+
+MeshColliderComponent::MeshColliderComponent() : ColliderComponent(ComponentId::MeshCollider)
+{
+
+}
+
+ComponentState* MeshColliderComponent::readState(luabridge::LuaRef& data) const
+{
+	State* state = new State();
+	readColliderState(data, *state);
+	if (LUAFIELDEXIST(MeshName)) state->meshName = GETLUASTRINGFIELD(MeshName);
+	return state;
+}
+
+void MeshColliderComponent::awakeFromState(const ComponentState& state)
+{
+	const State& values = static_cast<const State&>(state);
+
+	physx::PxRigidActor* loaded = Engine::getInstance()->takeLoadedActor(_gameObject, getId());
+	if (loaded != nullptr) {
+		_collider = new MeshCollider(loaded, _gameObject, gameObjectsCollision);
+		return;
+	}
+
+	const std::string& meshName = values.meshName;
+	float staticFriction, dynamicFriction, restitution;
+	getMaterial(values, staticFriction, dynamicFriction, restitution);
+	if (_gameObject->hasComponent(ComponentId::Rigidbody))
+		Logger::getInstance()->log("The MeshCollider of " + _gameObject->getName() + " is static, use a ConvexCollider for a rigidbody", Logger::Level::WARN);
+
+	//The mesh files are read through the resource groups of Ogre
+	if (Engine::getInstance()->isHeadless()) {
+		//The loader of the scene replaces the message of the exception, so it's logged too
+		std::string error = "The MeshCollider of " + _gameObject->getName() + " can't read " + meshName +
+			" in headless mode, it must be loaded from the physics collection of the level";
+		Logger::getInstance()->log(error, Logger::Level::ERROR);
+		throw ExcepcionTAD(error);
+	}
+
+	std::vector<unsigned char> source;
+	physx::PxTriangleMesh* mesh = PhysxEngine::getPxInstance()->getMeshCooker()->getTriangleMesh(meshName,
+		meshFileReader(meshName, source), meshTriangleReader(meshName, source));
+
+	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
+	Vec3 pos = t->getPosition().toVec3();
+
+	_collider = new MeshCollider(mesh, getRenderScale(MeshCooker::getSize(mesh), t), _gameObject, _gameObject->getName(),
+		gameObjectsCollision, pos, staticFriction, dynamicFriction, restitution, true);
+	_collider->setOrientation(t->getOrientation());
+	if (!values.layer.empty()) setLayer(values.layer);
+}
+
+void MeshColliderComponent::setScale(const Vector3& scale)
+{
+	static_cast<MeshCollider*>(_collider)->setScale(scale.toVec3());
+}
+
+Vector3 MeshColliderComponent::getScale()
+{
+	return static_cast<MeshCollider*>(_collider)->getScale();
+}
+
+/////////////////////////////////////////////////////////
+
+
+ConvexColliderComponent::ConvexColliderComponent() : ColliderComponent(ComponentId::ConvexCollider)
+{
+
+}
+
+ComponentState* ConvexColliderComponent::readState(luabridge::LuaRef& data) const
+{
+	State* state = new State();
+	readColliderState(data, *state);
+	if (LUAFIELDEXIST(MeshName)) state->meshName = GETLUASTRINGFIELD(MeshName);
+	return state;
+}
+
+void ConvexColliderComponent::awakeFromState(const ComponentState& state)
+{
+	const State& values = static_cast<const State&>(state);
+
+	physx::PxRigidActor* loaded = Engine::getInstance()->takeLoadedActor(_gameObject, getId());
+	if (loaded != nullptr) {
+		_collider = new ConvexCollider(loaded, _gameObject, gameObjectsCollision, gameObjectTriggered);
+		return;
+	}
+
+	const std::string& meshName = values.meshName;
+	float staticFriction, dynamicFriction, restitution;
+	getMaterial(values, staticFriction, dynamicFriction, restitution);
+
+	if (Engine::getInstance()->isHeadless()) {
+		//The loader of the scene replaces the message of the exception, so it's logged too
+		std::string error = "The ConvexCollider of " + _gameObject->getName() + " can't read " + meshName +
+			" in headless mode, it must be loaded from the physics collection of the level";
+		Logger::getInstance()->log(error, Logger::Level::ERROR);
+		throw ExcepcionTAD(error);
+	}
+
+	std::vector<unsigned char> source;
+	physx::PxConvexMesh* mesh = PhysxEngine::getPxInstance()->getMeshCooker()->getConvexMesh(meshName,
+		meshFileReader(meshName, source), meshTriangleReader(meshName, source));
+
+	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
+	Vec3 pos = t->getPosition().toVec3();
+
+	_collider = new ConvexCollider(mesh, getRenderScale(MeshCooker::getSize(mesh), t), values.isTrigger, _gameObject, _gameObject->getName(),
+		gameObjectsCollision, gameObjectTriggered, pos, staticFriction, dynamicFriction, restitution, values.isStatic);
+	_collider->setOrientation(t->getOrientation());
+	if (!values.layer.empty()) setLayer(values.layer);
+}
+
+void ConvexColliderComponent::setScale(const Vector3& scale)
+{
+	static_cast<ConvexCollider*>(_collider)->setScale(scale.toVec3());
+}
+
+Vector3 ConvexColliderComponent::getScale()
+{
+	return static_cast<ConvexCollider*>(_collider)->getScale();
+}
+
+void ColliderComponent::gameObjectsCollision(GameObjectHandle thisGO, GameObjectHandle otherGO, const ContactEvent& event)
 {
-	thisGO->onCollision(otherGO);
-	otherGO->onCollision(thisGO);
+	Engine* engine = Engine::getInstance();
+	GameObject* go = engine->getGameObject(thisGO);
+	if (go != nullptr) go->onContact(otherGO, event);
+	go = engine->getGameObject(otherGO);
+	if (go != nullptr) go->onContact(thisGO, event);
 }
 
-void ColliderComponent::gameObjectTriggered(GameObject* thisGO, GameObject* otherGO)
+void ColliderComponent::gameObjectTriggered(GameObjectHandle thisGO, GameObjectHandle otherGO, const ContactEvent& event)
 {
-	thisGO->onTrigger(otherGO);
-	otherGO->onTrigger(thisGO);
+	Engine* engine = Engine::getInstance();
+	GameObject* go = engine->getGameObject(thisGO);
+	if (go != nullptr) go->onContact(otherGO, event);
+	go = engine->getGameObject(otherGO);
+	if (go != nullptr) go->onContact(thisGO, event);
 }
@@ -3,36 +3,50 @@
 #define COLLIDERCOMPONENT_H
 
 #include "Component.h"
+#include <string>
 
 class GameObject;
 class Collider;
+class CollisionBody;
 class BoxCollider;
 class SphereCollider;
 class CapsuleCollider;
 class Vector3;
+struct Quat;
+struct ContactEvent;
 
 class ColliderComponent : public Component {
 public:
 
+	/// <summary>
+	/// The component isn't called in any update phase
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::None; }
+
 	/// <summary>
 	/// Callback for gameobject collision
 	/// </summary>
 	/// <param name="thisGO"></param>
 	/// <param name="otherGO"></param>
-	static void gameObjectsCollision(GameObject* thisGO, GameObject* otherGO);
+	static void gameObjectsCollision(GameObjectHandle thisGO, GameObjectHandle otherGO, const ContactEvent& event);
 
 	/// <summary>
 	/// Callback for trgger collision
 	/// </summary>
 	/// <param name="thisGO"></param>
 	/// <param name="otherGO"></param>
-	static void gameObjectTriggered(GameObject* thisGO, GameObject* otherGO);
+	static void gameObjectTriggered(GameObjectHandle thisGO, GameObjectHandle otherGO, const ContactEvent& event);
 
 	/// <summary>
 	/// Destructor of the class
 	/// </summary>
 	virtual ~ColliderComponent();
 
+	/// <summary>
+	/// Creates the collider with the values of readState of its type
+	/// </summary>
+	void awake(luabridge::LuaRef& data) override;
+
 	/// <summary>
 	/// Sets the collider for collisions
 	/// </summary>
@@ -53,6 +67,27 @@ public:
 	/// </summary>
 	void setRotation(Vector3 rot);
 
+	/// <summary>
+	/// Sets the orientation of the collider to a specified one
+	/// </summary>
+	void setOrientation(const Quat& orientation);
+
+	/// <summary>
+	/// Moves the collider to the collision layer with that name, the layers are registered in CollisionLayers
+	/// </summary>
+	/// <returns>False if there is no such layer, then the layer doesn't change</returns>
+	bool setLayer(const std::string& name);
+
+	/// <summary>
+	/// Returns the body of the physics, used to save the collection of the level
+	/// </summary>
+	CollisionBody* getCollisionBody() const;
+
+	/// <summary>
+	/// Takes the collider out of the simulation while the GameObject is dormant
+	/// </summary>
+	void onDormant(bool dormant) override;
+
 protected:
 
 	/// <summary>
@@ -61,6 +96,34 @@ protected:
 	/// <param name="id">Component ID</param>
 	ColliderComponent(int id);
 
+	/// <summary>
+	/// Values every type of collider reads from Lua
+	/// </summary>
+	struct ColliderState : public ComponentState {
+		bool isTrigger = false;
+		float staticFriction = 0.5f;
+		float dynamicFriction = 0.5f;
+		float restitution = 0.5f;
+		std::string material;
+		bool isStatic = false;
+		std::string layer;
+	};
+
+	/// <summary>
+	/// Reads the fields every collider has
+	/// </summary>
+	void readColliderState(luabridge::LuaRef& data, ColliderState& state) const;
+
+	/// <summary>
+	/// Returns the frictions and restitution of the state, or the ones of its material if it has one
+	/// </summary>
+	void getMaterial(const ColliderState& state, float& staticFriction, float& dynamicFriction, float& restitution) const;
+
+	/// <summary>
+	/// Replaces the values with the ones of the named physics material, if there is no such material they don't change
+	/// </summary>
+	void readMaterial(const std::string& name, float& staticFriction, float& dynamicFriction, float& restitution) const;
+
 	void onEnable() override;
 
 	void onDisable() override;
@@ -83,7 +146,9 @@ public:
 	/// </summary>
 	BoxColliderComponent();
 
-	void awake(luabridge::LuaRef& data) override;
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
 
 	/// <summary>
 	/// Changes box size
@@ -111,6 +176,11 @@ public:
 	/// <returns>The depth of the box</returns>
 	float getDepth();
 
+private:
+	struct State : public ColliderState {
+		//Sizes of the box, before the scale of the Transform
+		float width = 1, height = 1, depth = 1;
+	};
 };
 
 #endif
@@ -129,7 +199,9 @@ public:
 	/// </summary>
 	SphereColliderComponent();
 
-	void awake(luabridge::LuaRef& data) override;
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
 
 	/// <summary>
 	/// Changes sphere radius
@@ -142,6 +214,11 @@ public:
 	/// </summary>
 	/// <returns>The radius of the sphere</returns>
 	float getRadius();
+
+private:
+	struct State : public ColliderState {
+		float radius = 2;
+	};
 };
 
 
@@ -161,7 +238,9 @@ public:
 	/// </summary>
 	CapsuleColliderComponent();
 
-	void awake(luabridge::LuaRef& data) override;
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
 
 	/// <summary>
 	/// Changes capsule's dimensions
@@ -182,7 +261,90 @@ public:
 	/// </summary>
 	/// <returns>The height of the capsule</returns>
 	float getHeight();
+
+private:
+	struct State : public ColliderState {
+		//Sizes of the capsule, before the scale of the Transform
+		float radius = 1, length = 3;
+	};
 };
 
 
+#endif
+
+////////////////////////////////////////////////////
+
+#ifndef MESHCOLLIDERCOMPONENT_H
+#define MESHCOLLIDERCOMPONENT_H
+
+/// <summary>
+/// Collider with the triangles of a .mesh, for the scenery that a box can't fit.
+/// It's always static, physx doesn't simulate triangle meshes in bodies that move
+/// </summary>
+class MeshColliderComponent : public ColliderComponent {
+public:
+
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	MeshColliderComponent();
+
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
+
+	/// <summary>
+	/// Changes the scale of the mesh
+	/// </summary>
+	void setScale(const Vector3& scale);
+
+	/// <summary>
+	/// Gets the scale of the mesh
+	/// </summary>
+	Vector3 getScale();
+
+private:
+	struct State : public ColliderState {
+		std::string meshName = "cube.mesh";
+	};
+};
+
+#endif
+
+////////////////////////////////////////////////////
+
+#ifndef CONVEXCOLLIDERCOMPONENT_H
+#define CONVEXCOLLIDERCOMPONENT_H
+
+/// <summary>
+/// Collider with the convex hull of the vertices of a .mesh, it can be used by rigidbodies
+/// </summary>
+class ConvexColliderComponent : public ColliderComponent {
+public:
+
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	ConvexColliderComponent();
+
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
+
+	/// <summary>
+	/// Changes the scale of the mesh
+	/// </summary>
+	void setScale(const Vector3& scale);
+
+	/// <summary>
+	/// Gets the scale of the mesh
+	/// </summary>
+	Vector3 getScale();
+
+private:
+	struct State : public ColliderState {
+		std::string meshName = "cube.mesh";
+	};
+};
+
 #endif
@@ -1,18 +1,32 @@
 #include "Component.h"
 #include "Exceptions.h"
+#include "MemoryArena.h"
 #include "includeLUA.h"
 
 Component::Component(unsigned int id):_id(id), _gameObject(nullptr), _enabled(true)
 {
+	for (int& slot : _phaseSlots) slot = -1;
 }
 
 Component::Component(unsigned int id, GameObject* gameObject):
 	_id(id), _gameObject(gameObject), _enabled(true)
-{}
+{
+	for (int& slot : _phaseSlots) slot = -1;
+}
 
 Component::~Component()
 {}
 
+void* Component::operator new(size_t size)
+{
+	return MemoryArena::allocateObject(size);
+}
+
+void Component::operator delete(void* ptr)
+{
+	MemoryArena::deallocateObject(ptr);
+}
+
 void Component::setGameObject(GameObject * gameObject)
 {
 	if (gameObject == nullptr) {
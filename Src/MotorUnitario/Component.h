@@ -5,8 +5,11 @@
 #include "ComponentIDs.h"
 #include "ComponentsFactory.h"
 #include "ComponentFactory.h"
+#include "UpdateScheduler.h"
+#include "GameObjectHandle.h"
 
 class GameObject;
+struct ContactEvent;
 namespace luabridge {
 	class LuaRef;
 }
@@ -22,6 +25,13 @@ namespace luabridge {
 	CMP_FACTORY(component)			\
 	static FactoryAdder component##FactoryGlobalVar(new component##Factory(), #component);	\
 
+/// <summary>
+/// Values of a component read from Lua, see Component::readState
+/// </summary>
+struct ComponentState {
+	virtual ~ComponentState() {}
+};
+
 class Component
 {
 public:
@@ -30,16 +40,39 @@ public:
 	Component(unsigned int id, GameObject* gameObject);
 	virtual ~Component();
 
+	/// <summary>
+	/// Allocated in the current MemoryArena if there is one, as the objects of the scene being loaded, or in the heap otherwise
+	/// </summary>
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr);
+
 	/// <summary>
 	/// Method to initialize required attributes for the component
 	/// </summary>
 	virtual void awake(luabridge::LuaRef &data) {}
 
+	/// <summary>
+	/// Reads the data of awake without creating anything, so a Prefab reads its Lua once and awakes every instance
+	/// with awakeFromState. Returns nullptr if the type doesn't support it, then its instances use awake
+	/// </summary>
+	virtual ComponentState* readState(luabridge::LuaRef& data) const { return nullptr; }
+
+	/// <summary>
+	/// Same as awake with the values returned by readState of the same type of component
+	/// </summary>
+	virtual void awakeFromState(const ComponentState& state) {}
+
 	/// <summary>
 	/// Initializes the component, called once at the start of the execution
 	/// </summary>
 	virtual void start() {}
 
+	/// <summary>
+	/// Called when a pooled GameObject is reused instead of creating a new one, see Prefab
+	/// <para> Must leave the component as it was after awake and start </para>
+	/// </summary>
+	virtual void reset() {}
+
 	/// <summary>
 	/// Called each frame to update non-physical information
 	/// </summary>
@@ -61,17 +94,45 @@ public:
 	virtual void lateUpdate() {}
 
 	/// <summary>
-	/// Called when the owner is not a trigger and collides with another GameObject
+	/// Returns the mask of the phases this type of component overrides, see UpdatePhase::mask. The UpdateScheduler only calls
+	/// the component in those phases. Every phase by default, so a component that doesn't declare them is always called
+	/// </summary>
+	virtual unsigned int getUpdatePhases() const { return UpdatePhase::All; }
+
+	/// <summary>
+	/// Returns true if the phase of this type of component can run in parallel with other instances of the same type
+	/// <para> It must not create or remove components and it must only write its own data </para>
+	/// </summary>
+	/// <param name="phase">: update phase</param>
+	virtual bool isParallelSafe(UpdatePhase::UpdatePhase phase) const { return false; }
+
+	/// <summary>
+	/// Called when the owner is not a trigger and collides with another GameObject, and every step while they touch
+	/// if their collision layers are reported every step
 	/// </summary>
 	/// <param name="other">Pointer to Gameobject owner collided with</param>
 	virtual void onCollision(GameObject* other) {}
 
 	/// <summary>
-	/// Called when the owner is a trigger and collides with another GameObject
+	/// Called when the owner or the other GameObject is a trigger and they start touching
 	/// </summary>
 	/// <param name="other">Pointer to Gameobject owner collided with</param>
 	virtual void onTrigger(GameObject* other) {}
 
+	/// <summary>
+	/// Called for every contact and trigger event of the owner after the physics step, with its state (enter, stay or exit)
+	/// and its contact points if PhysxEngine records them
+	/// </summary>
+	/// <param name="other">Handle of the Gameobject owner collided with, it may have been destroyed during the step</param>
+	/// <param name="event">The event, valid only during the call</param>
+	virtual void onContact(GameObjectHandle other, const ContactEvent& event) {}
+
+	/// <summary>
+	/// Called when the owner leaves every activation region (true) or enters one again (false), see ActivationRegions
+	/// <para> The component isn't updated while dormant, the ones with physics stop simulating </para>
+	/// </summary>
+	virtual void onDormant(bool dormant) {}
+
 	/// <summary>
 	/// Returns a pointer to the GameObject that own the component
 	/// </summary>
@@ -117,9 +178,13 @@ protected:
 	GameObject* _gameObject;
 
 private:
+	friend class UpdateScheduler;
 
 	unsigned int _id;
 	bool _enabled;
+
+	//Position of the component in each phase of the UpdateScheduler, -1 if it's not registered
+	int _phaseSlots[UpdatePhase::__Count__];
 };
 
 #endif //!COMPONENT_H
\ No newline at end of file
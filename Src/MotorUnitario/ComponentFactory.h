@@ -11,6 +11,15 @@ public:
 	virtual Component* create() const = 0;
 };
 
+/// <summary>
+/// Factory that doesn't create any component, the LuaParser skips the components it returns
+/// </summary>
+class NullComponentFactory : public ComponentFactory
+{
+public:
+	virtual Component* create() const { return nullptr; }
+};
+
 class FactoryAdder {
 public: 
 	FactoryAdder(ComponentFactory* factory, const char* name) {
@@ -1,5 +1,6 @@
 /*
-This enum controls de order of updates of components in every gameObject, 
+This enum controls de order of updates of components: the UpdateScheduler updates every component
+	of one id before moving to the next one (every Transform, then every ImageRender...),
 	except those defined by the user, which always update the latest
 
 It's recommendable to keep an order when introducing a new Component to the enum 
@@ -21,6 +22,9 @@ namespace ComponentId {
 		BoxCollider,
 		SphereCollider,
 		CapsuleCollider,
+		StaticGeometry,
+		MeshCollider,
+		ConvexCollider,
 	
 		AudioSource,
 		ListenerComponent,
@@ -28,6 +32,9 @@ namespace ComponentId {
 		OverlayComponent,
 		ButtonComponent,
 
+		Activator,
+		Activatable,
+
 		//from this point, every id forward is of a component defined by the user
 		__StartPointUser__
 	};
@@ -35,3 +35,11 @@ Component* ComponentsFactory::getComponentByName(const std::string& name)
 		throw ComponentException("The component " + name + " doesn't exist");
 	return (*it).second->create();
 }
+
+ComponentFactory* ComponentsFactory::getFactory(const std::string& name)
+{
+	auto it = _componentTranslator.find(name);
+	if (it == _componentTranslator.end())
+		throw ComponentException("The component " + name + " doesn't exist");
+	return (*it).second;
+}
@@ -36,6 +36,13 @@ public:
 	/// <returns>The desired component</returns>
 	Component* getComponentByName(const std::string& name);
 
+	/// <summary>
+	/// Gets the factory of a component, to create many without looking up its name
+	/// </summary>
+	/// <param name="name">The name of the desired component</param>
+	/// <returns>The factory registered with that name</returns>
+	ComponentFactory* getFactory(const std::string& name);
+
 private:
 
 	ComponentsFactory() : _componentTranslator() {
@@ -4,32 +4,47 @@
 #include <SDL.h>
 #include "MotorGrafico/GraphicsEngine.h"
 #include "MotorFisico/PhysxEngine.h"
+#include "MotorFisico/PhysicsCollection.h"
 #include "InputManager.h"
 #include "MotorAudio/AudioEngine.h"
 #include "EngineTime.h"
 #include "LuaParser.h"
+#include "UpdateScheduler.h"
+#include "TransformHierarchy.h"
+#include "ActivationRegions.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "MemoryArena.h"
+#include "WorldSnapshot.h"
+#include "PrefabManager.h"
 #include "Logger.h"
 #include "ComponentsFactory.h"
 #include "Exceptions.h"
 
 #include "Factories.h"
 
+//The low bits of a name id are the position of the name, the high ones its generation
+#define _NAME_INDEX_BITS_ 24
+#define _NAME_INDEX_MASK_ ((1u << _NAME_INDEX_BITS_) - 1)
+
 std::unique_ptr<Engine> Engine::instance = nullptr;
 
 Engine::Engine() : _physxEngine(nullptr), _graphicsEngine(nullptr), _audioEngine(nullptr),
-_GOs(), _deleteGOs(),
-_inputManager(nullptr), _time(nullptr), _luaParser(nullptr),
-_run(true), alredyInitialized(false), _changeScene(false), scenesPath(""), _currentScene("")
+_GOs(), _GOSlots(), _slots(), _freeSlots(), _deleteGOs(), _names(), _nameIds(), _freeNames(),
+_inputManager(nullptr), _time(nullptr), _luaParser(nullptr), _jobSystem(nullptr), _sceneArena(new MemoryArena()),
+_run(true), alredyInitialized(false), _changeScene(false), _mode(EngineMode::Default), _asyncPhysics(false), _physicsPending(false), _physicsConfig(), _physicsConfigChanged(false), scenesPath(""), _currentScene("")
 {
 }
 
 void Engine::processEvents()
 {
-	_inputManager->update();
+	if (_inputManager != nullptr)
+		_inputManager->update();
 }
 
 Engine::~Engine()
 {
+	delete _sceneArena; _sceneArena = nullptr;
 	ComponentsFactory::getInstance()->~ComponentsFactory();
 }
 
@@ -50,29 +65,64 @@ void Engine::CreateInstance()
 
 void Engine::setViewportColour(float r, float g, float b)
 {
-	_graphicsEngine->setViewportColour(r, g, b);
+	if (_graphicsEngine != nullptr)
+		_graphicsEngine->setViewportColour(r, g, b);
 }
 
 void Engine::disableShadows()
 {
-	_graphicsEngine->disableShadows();
+	if (_graphicsEngine != nullptr)
+		_graphicsEngine->disableShadows();
 }
 
 
 void Engine::tick()
 {
+	PROFILE_FRAME();
 	try {
-		processEvents();
-		fixedUpdate();
-		update();
-		lateUpdate();
-		_graphicsEngine->render();
-		_audioEngine->update();
+		{
+			PROFILE_SCOPE("ProcessEvents");
+			processEvents();
+		}
+		{
+			//The objects that stay dormant are left out of every phase of the frame
+			PROFILE_SCOPE("ActivationRegions");
+			ActivationRegions::getInstance()->update();
+		}
+		{
+			PROFILE_SCOPE("FixedUpdate");
+			fixedUpdate();
+		}
+		{
+			PROFILE_SCOPE("Update");
+			update();
+		}
+		{
+			PROFILE_SCOPE("LateUpdate");
+			lateUpdate();
+		}
+		if (_graphicsEngine != nullptr) {
+			PROFILE_SCOPE("Render");
+			_graphicsEngine->render();
+		}
+		{
+			PROFILE_SCOPE("SyncPhysics");
+			syncPhysics();
+		}
+		if (_audioEngine != nullptr) {
+			PROFILE_SCOPE("Audio");
+			_audioEngine->update();
+		}
 		_time->update();
 
-		cleanUpGameObjects();
-		if (_changeScene)
+		{
+			PROFILE_SCOPE("CleanUp");
+			cleanUpGameObjects();
+		}
+		if (_changeScene) {
+			PROFILE_SCOPE("ChangeScene");
 			changeScene();
+		}
 	}
 	catch (ExcepcionTAD e) {
 		Logger::getInstance()->log("Error while executing engine: " + e.msg(), Logger::Level::FATAL);
@@ -81,7 +131,7 @@ void Engine::tick()
 	}
 }
 
-bool Engine::init(std::string const& resourcesPath, std::string const& scenesP)
+bool Engine::init(std::string const& resourcesPath, std::string const& scenesP, EngineMode::EngineMode mode, const std::string& physicsConfig)
 {
 	if (alredyInitialized) {
 		Logger::getInstance()->log("Engine class is already initialized", Logger::Level::WARN);
@@ -89,37 +139,52 @@ bool Engine::init(std::string const& resourcesPath, std::string const& scenesP)
 	}
 
 	scenesPath = scenesP + '/';
+	_mode = mode;
 
 	//--------------GraphicsEngine---------------------
 	try {
-		GraphicsEngine::CreateInstance();
-		_graphicsEngine = GraphicsEngine::getInstance();
-		_graphicsEngine->setResourcePath(resourcesPath);
-		if (!_graphicsEngine->initializeRenderEngine()) {
-			Logger::getInstance()->log("Graphics Engine init error", Logger::Level::ERROR);
-			throw "Graphics Engine init error";
+		if (!isHeadless()) {
+			GraphicsEngine::CreateInstance();
+			_graphicsEngine = GraphicsEngine::getInstance();
+			_graphicsEngine->setResourcePath(resourcesPath);
+			if (!_graphicsEngine->initializeRenderEngine()) {
+				Logger::getInstance()->log("Graphics Engine init error", Logger::Level::ERROR);
+				throw "Graphics Engine init error";
+			}
+			Logger::getInstance()->log("Graphics Engine initialized correctly", Logger::Level::INFO);
 		}
-		Logger::getInstance()->log("Graphics Engine initialized correctly", Logger::Level::INFO);
+		//--------------JobSystem--------------------
+		JobSystem::CreateInstance();
+		_jobSystem = JobSystem::getInstance();
+		Logger::getInstance()->log("Job system initialized with " + std::to_string(_jobSystem->getWorkerCount()) + " workers", Logger::Level::INFO);
+		_luaParser = new LuaParser();
 		//--------------PhysXEngine--------------------
+		if (!physicsConfig.empty())
+			_luaParser->loadPhysicsConfig(scenesPath + physicsConfig, _physicsConfig);
 		PhysxEngine::CreateInstance();
 		_physxEngine = PhysxEngine::getPxInstance();
-		_physxEngine->init();
+		//PhysX tasks run in the same pool as the components
+		_physxEngine->init([](std::function<void()> task) { JobSystem::getInstance()->schedule(std::move(task)); }, _jobSystem->getWorkerCount(), _physicsConfig);
+		_physxEngine->setHandleFunction([](const GameObject* go) { return go->getHandle(); });
+		_physicsConfigChanged = false;
 		Logger::getInstance()->log("Physics Engine initialized correctly", Logger::Level::INFO);
-		//---------------AudioEngine--------------------
-		AudioEngine::CreateInstance();
-		_audioEngine = AudioEngine::getInstance();
-		_audioEngine->init();
-		Logger::getInstance()->log("Audio Engine initialized correctly", Logger::Level::INFO);
-		//-------------InputManager--------------
-		_inputManager = InputManager::getInstance();
-		Logger::getInstance()->log("Input manager initialized correctly", Logger::Level::INFO);
+		if (!isHeadless()) {
+			//---------------AudioEngine--------------------
+			AudioEngine::CreateInstance();
+			_audioEngine = AudioEngine::getInstance();
+			_audioEngine->init();
+			Logger::getInstance()->log("Audio Engine initialized correctly", Logger::Level::INFO);
+			//-------------InputManager--------------
+			_inputManager = InputManager::getInstance();
+			Logger::getInstance()->log("Input manager initialized correctly", Logger::Level::INFO);
+		}
+		else
+			Logger::getInstance()->log("Engine running headless, graphics, audio and input are disabled", Logger::Level::INFO);
 
 		_time = EngineTime::getInstance();
 
 		initEngineFactories();
 
-		_luaParser = new LuaParser();
-
 		alredyInitialized = true;
 	}
 	catch (ExcepcionTAD e) {
@@ -146,6 +211,36 @@ void Engine::changeScene(const std::string& scene)
 	_changeScene = true;
 }
 
+bool Engine::loadPrefabs(const std::string& file)
+{
+	return _luaParser->loadPrefabs(scenesPath + file);
+}
+
+bool Engine::loadPhysicsMaterials(const std::string& file)
+{
+	return _luaParser->loadPhysicsMaterials(scenesPath + file);
+}
+
+void Engine::setPhysicsConfig(const PhysicsConfig& config)
+{
+	_physicsConfig = config;
+	_physicsConfigChanged = true;
+}
+
+bool Engine::loadPhysicsConfig(const std::string& file)
+{
+	//Before init the file is given to init, which knows the scenes path
+	if (_luaParser == nullptr) {
+		Logger::getInstance()->log("The physics config " + file + " can't be read before init", Logger::Level::WARN);
+		return false;
+	}
+	PhysicsConfig config = _physicsConfig;
+	if (!_luaParser->loadPhysicsConfig(scenesPath + file, config))
+		return false;
+	setPhysicsConfig(config);
+	return true;
+}
+
 void Engine::stopExecution()
 {
 	_run = false;
@@ -153,12 +248,14 @@ void Engine::stopExecution()
 
 void Engine::start()
 {
-	for (auto& it : _GOs) {
+	//GameObjects created during start are appended, so size is read every iteration
+	for (size_t i = 0; i < _GOs.size(); ++i) {
+		GameObject* go = _GOs[i];
 		try {
-			it->start();
+			go->start();
 		}
 		catch (...) {
-			throw ExcepcionTAD("Error in Start at gameObject " + it->getName());
+			throw ExcepcionTAD("Error in Start at gameObject " + go->getName());
 		}
 	}
 
@@ -167,73 +264,159 @@ void Engine::start()
 
 void Engine::fixedUpdate()
 {
-	int calls = _time->fixedUpdateRequired();
-
+	//The steps are taken from the time accumulated by the clock, the remainder waits for the next frame
+	unsigned int calls = _time->fixedUpdateRequired();
 	if (calls == 0) return;
-	else if (calls > 2) calls = 2;
 
+	const float step = _time->fixedDeltaTime();
 	while (calls--) {
-		for (auto& it : _GOs) {
-			if (it->getEnabled()) {
-				try {
-					it->fixedUpdate();
-				}
-				catch (...) {
-					throw ExcepcionTAD("Error in FixedUpdate at gameObject " + it->getName());
-				}
+		_time->consumeFixedStep();
+		UpdateScheduler::getInstance()->run(UpdatePhase::FixedUpdate);
+		//The last step keeps simulating while the frame goes on
+		if (_asyncPhysics && calls == 0) {
+			PROFILE_SCOPE("PhysxEngine::simulate");
+			_physxEngine->simulate(step);
+			_physicsPending = true;
+		}
+		else {
+			{
+				PROFILE_SCOPE("PhysxEngine::update");
+				_time->nextFixedStep();
+				_physxEngine->update(step);
 			}
+			PROFILE_SCOPE("ContactEvents");
+			_physxEngine->dispatchContactEvents();
+		}
+	}
+
+	if (!_physicsPending) {
+		PROFILE_SCOPE("PostFixedUpdate");
+		UpdateScheduler::getInstance()->run(UpdatePhase::PostFixedUpdate);
+	}
+}
+
+void Engine::savePhysicsCollection(const std::string& file)
+{
+	const unsigned int physicComponents[] = { ComponentId::Rigidbody, ComponentId::BoxCollider, ComponentId::SphereCollider,
+		ComponentId::CapsuleCollider, ComponentId::StaticGeometry, ComponentId::MeshCollider, ComponentId::ConvexCollider };
+
+	//The key of each actor is the name of its GameObject and its component, in the order the scene creates them
+	std::vector<std::pair<std::string, CollisionBody*>> bodies;
+	for (GameObject* go : _GOs) {
+		for (unsigned int id : physicComponents) {
+			if (!go->hasComponent(id)) continue;
+			CollisionBody* body = nullptr;
+			if (id == ComponentId::Rigidbody) body = static_cast<RigidBodyComponent*>(go->getComponent(id))->getCollisionBody();
+			else if (id == ComponentId::StaticGeometry) body = static_cast<StaticGeometryComponent*>(go->getComponent(id))->getCollisionBody();
+			else body = static_cast<ColliderComponent*>(go->getComponent(id))->getCollisionBody();
+			if (body != nullptr) bodies.push_back(std::make_pair(go->getName() + "#" + std::to_string(id), body));
 		}
-		_physxEngine->update(_time->fixedDeltaTime() / 1000);
 	}
+	_physxEngine->getCollection()->save(file, bodies);
+}
+
+physx::PxRigidActor* Engine::takeLoadedActor(const GameObject* go, unsigned int componentId)
+{
+	PhysicsCollection* collection = _physxEngine != nullptr ? _physxEngine->getCollection() : nullptr;
+	if (collection == nullptr || !collection->hasUnbound()) return nullptr;
+	return collection->take(go->getName() + "#" + std::to_string(componentId));
+}
 
+void Engine::captureSnapshot(WorldSnapshot& snapshot)
+{
+	syncPhysics();
+	snapshot.clear();
 
-	for (auto& it : _GOs) {
-		if (it->getEnabled()) {
-			try {
-				it->postFixedUpdate();
-			}
-			catch (...) {
-				throw ExcepcionTAD("Error in PostFixedUpdate at gameObject " + it->getName());
-			}
-		}		
+	for (GameObject* go : _GOs) {
+		Transform* tr = static_cast<Transform*>(go->getComponent(ComponentId::Transform));
+		if (tr == nullptr) continue;
+		snapshot._transforms.push_back({ go->getHandle(), tr->getPosition(), tr->getOrientation(), tr->getScale() });
+	}
+	_physxEngine->captureSnapshot(snapshot._physics);
+}
+
+void Engine::restoreSnapshot(const WorldSnapshot& snapshot)
+{
+	syncPhysics();
+
+	for (const WorldSnapshot::TransformState& state : snapshot._transforms) {
+		GameObject* go = getGameObject(state.handle);
+		if (go == nullptr) continue;
+		Transform* tr = static_cast<Transform*>(go->getComponent(ComponentId::Transform));
+		if (tr != nullptr) tr->restore(state.position, state.orientation, state.scale);
+	}
+	_physxEngine->restoreSnapshot(snapshot._physics);
+}
+
+void Engine::resimulate(const WorldSnapshot& snapshot, unsigned int steps, const std::function<void(unsigned int)>& beforeStep)
+{
+	PROFILE_SCOPE("Engine::resimulate");
+	restoreSnapshot(snapshot);
+
+	const float step = _time->fixedDeltaTime();
+	for (unsigned int i = 0; i < steps; ++i) {
+		if (beforeStep) beforeStep(i);
+		UpdateScheduler::getInstance()->run(UpdatePhase::FixedUpdate);
+		_physxEngine->update(step);
+		_physxEngine->dispatchContactEvents();
+		UpdateScheduler::getInstance()->run(UpdatePhase::PostFixedUpdate);
+	}
+}
+
+void Engine::syncPhysics()
+{
+	if (!_physicsPending) return;
+
+	_physicsPending = false;
+	{
+		PROFILE_SCOPE("PhysxEngine::fetchResults");
+		_time->nextFixedStep();
+		_physxEngine->fetchResults(true);
 	}
+	{
+		PROFILE_SCOPE("ContactEvents");
+		_physxEngine->dispatchContactEvents();
+	}
+	PROFILE_SCOPE("PostFixedUpdate");
+	UpdateScheduler::getInstance()->run(UpdatePhase::PostFixedUpdate);
+}
 
-	_time->fixedTimeUpdate();
+void Engine::setAsyncPhysics(bool async)
+{
+	if (!async && _physicsPending)
+		syncPhysics();
+	_asyncPhysics = async;
 }
 
 void Engine::update()
 {
-	for (auto& it : _GOs) {
-		if (it->getEnabled()) {
-			try {
-				it->update();
-			}
-			catch (...) {
-				throw ExcepcionTAD("Error in Update at gameObject " + it->getName());
-			}
-		}
+	{
+		//World transforms of the changes made since the last frame, including the physics
+		PROFILE_SCOPE("TransformHierarchy");
+		TransformHierarchy::getInstance()->update();
 	}
+	UpdateScheduler::getInstance()->run(UpdatePhase::Update);
 }
 
 void Engine::lateUpdate()
 {
-	for (auto& it : _GOs) {
-		if (it->getEnabled()) {
-			try {
-				it->lateUpdate();
-			}
-			catch (...) {
-				throw ExcepcionTAD("Error in LateUpdate at gameObject " + it->getName());
-			}
-		}
-	}
+	UpdateScheduler::getInstance()->run(UpdatePhase::LateUpdate);
 }
 
 void Engine::shutDown()
 {
-	for (auto go : _GOs) {
-		delete go; go = nullptr;
-	}
+#ifdef MOTOR_PROFILE
+	Profiler* profiler = Profiler::getInstance();
+	if (!profiler->getTracePath().empty() && !profiler->dumpChromeTrace(profiler->getTracePath()))
+		Logger::getInstance()->log("The profiler trace can't be written to " + profiler->getTracePath(), Logger::Level::WARN);
+#endif
+
+	if (_physxEngine != nullptr)
+		_physxEngine->fetchResults(true);
+
+	while (!_GOs.empty())
+		destroyGameObject(_GOs.back()->getHandle());
+	_deleteGOs.clear();
 
 	if (_graphicsEngine != nullptr) {
 		_graphicsEngine->shutdown();
@@ -242,33 +425,52 @@ void Engine::shutDown()
 		delete _physxEngine;
 		_physxEngine = nullptr;
 	}
+	if (_jobSystem != nullptr) {
+		_jobSystem->shutdown();
+		_jobSystem = nullptr;
+	}
+	//The prefabs reference Lua tables
+	PrefabManager::getInstance()->clear();
 	_luaParser->closeLuaVM();
 }
 
 void Engine::initEngineFactories()
 {
+	//Graphic and audio components need their engines, in headless mode they are skipped when loading a scene
+	bool headless = isHeadless();
+#define ENGINE_FACTORY(factory) (headless ? static_cast<ComponentFactory*>(new NullComponentFactory()) : static_cast<ComponentFactory*>(new factory()))
+
 	ComponentsFactory::getInstance()->add("Transform", new TransformFactory());
-	ComponentsFactory::getInstance()->add("ImageRenderer", new ImageRenderComponentFactory());
-	ComponentsFactory::getInstance()->add("LightComponent", new LightComponentFactory());
-	ComponentsFactory::getInstance()->add("RenderObject", new RenderObjectComponentFactory());
-	ComponentsFactory::getInstance()->add("Listener", new ListenerComponentFactory());
-	ComponentsFactory::getInstance()->add("AudioSource", new AudioSourceComponentFactory());
+	ComponentsFactory::getInstance()->add("ImageRenderer", ENGINE_FACTORY(ImageRenderComponentFactory));
+	ComponentsFactory::getInstance()->add("LightComponent", ENGINE_FACTORY(LightComponentFactory));
+	ComponentsFactory::getInstance()->add("RenderObject", ENGINE_FACTORY(RenderObjectComponentFactory));
+	ComponentsFactory::getInstance()->add("Listener", ENGINE_FACTORY(ListenerComponentFactory));
+	ComponentsFactory::getInstance()->add("AudioSource", ENGINE_FACTORY(AudioSourceComponentFactory));
 	ComponentsFactory::getInstance()->add("RigidBody", new RigidBodyComponentFactory());
 	ComponentsFactory::getInstance()->add("BoxCollider", new BoxColliderComponentFactory());
 	ComponentsFactory::getInstance()->add("SphereCollider", new SphereColliderComponentFactory());
 	ComponentsFactory::getInstance()->add("CapsuleCollider", new CapsuleColliderComponentFactory());
-	ComponentsFactory::getInstance()->add("Camera", new CameraComponentFactory());
-	ComponentsFactory::getInstance()->add("Animator", new AnimatorComponentFactory());
-	ComponentsFactory::getInstance()->add("ParticleSystem", new ParticleSystemComponentFactory());
-	ComponentsFactory::getInstance()->add("ButtonComponent", new ButtonComponentFactory());
-	ComponentsFactory::getInstance()->add("OverlayComponent", new OverlayComponentFactory());
+	ComponentsFactory::getInstance()->add("StaticGeometry", new StaticGeometryComponentFactory());
+	ComponentsFactory::getInstance()->add("MeshCollider", new MeshColliderComponentFactory());
+	ComponentsFactory::getInstance()->add("ConvexCollider", new ConvexColliderComponentFactory());
+	ComponentsFactory::getInstance()->add("Camera", ENGINE_FACTORY(CameraComponentFactory));
+	ComponentsFactory::getInstance()->add("Animator", ENGINE_FACTORY(AnimatorComponentFactory));
+	ComponentsFactory::getInstance()->add("ParticleSystem", ENGINE_FACTORY(ParticleSystemComponentFactory));
+	ComponentsFactory::getInstance()->add("ButtonComponent", ENGINE_FACTORY(ButtonComponentFactory));
+	ComponentsFactory::getInstance()->add("OverlayComponent", ENGINE_FACTORY(OverlayComponentFactory));
+	ComponentsFactory::getInstance()->add("Activator", new ActivatorComponentFactory());
+	ComponentsFactory::getInstance()->add("Activatable", new ActivatableComponentFactory());
+
+#undef ENGINE_FACTORY
 }
 
 void Engine::cleanUpGameObjects()
 {
-	for (GameObject* go : _deleteGOs) {
-		_GOs.remove(go);
-		delete go; go = nullptr;
+	//Destroying a GameObject can remove others, so size is read every iteration
+	for (size_t i = 0; i < _deleteGOs.size(); ++i) {
+		//Stale handles belong to GameObjects already destroyed
+		if (isAlive(_deleteGOs[i]))
+			destroyGameObject(_deleteGOs[i]);
 	}
 	_deleteGOs.clear();
 }
@@ -276,80 +478,233 @@ void Engine::cleanUpGameObjects()
 void Engine::changeScene()
 {
 	_changeScene = false;
-	//Remove current scene
-	for (auto it = _GOs.begin(); it != _GOs.end();) {
-		if (!(*it)->getPersist()) {
-			GameObject* go = *it;
-			it = _GOs.erase(it);
-			delete go;
+	//Remove current scene, backwards because removing moves the last GameObject to the hole
+	for (size_t i = _GOs.size(); i-- > 0;) {
+		if (i < _GOs.size() && !_GOs[i]->getPersist())
+			destroyGameObject(_GOs[i]->getHandle());
+	}
+	_deleteGOs.clear();
+	//The names interned without being given to any GameObject are released with the scene
+	for (auto it = _nameIds.begin(); it != _nameIds.end();) {
+		uint32_t index = (it++)->second & _NAME_INDEX_MASK_;
+		if (_names[index].objects.empty())
+			releaseName(index);
+	}
+	PrefabManager::getInstance()->clearPools();
+	if (_physxEngine != nullptr) {
+		_physxEngine->clearShapeCache();
+		//The physics scene is created again with the new config while it's empty
+		if (_physicsConfigChanged) {
+			_physicsConfigChanged = false;
+			try {
+				_physxEngine->setConfig(_physicsConfig);
+			}
+			catch (ExcepcionTAD e) {
+				Logger::getInstance()->log(e.msg() + ", the persistent GameObjects keep the physics config as it was", Logger::Level::WARN);
+				_physicsConfig = _physxEngine->getConfig();
+			}
+		}
+	}
+	//Every object of the scene has been destroyed, its memory is released at once
+	if (!_sceneArena->reset())
+		Logger::getInstance()->log("The scene arena can't be released, " + std::to_string(_sceneArena->getLiveCount()) + " of its objects are still alive", Logger::Level::WARN);
+	if (_graphicsEngine != nullptr)
+		_graphicsEngine->clearScene();
+	//The actors of a scene with a physics collection are loaded at once, the bodies take them when they are created
+	if (_physxEngine != nullptr) {
+		_physxEngine->getCollection()->releaseUnused();
+		try {
+			_physxEngine->getCollection()->load(scenesPath + _currentScene + ".physx");
+		}
+		catch (ExcepcionTAD e) {
+			Logger::getInstance()->log(e.msg() + ", the physics of the scene are created from its Lua file", Logger::Level::WARN);
 		}
-		else
-			++it;
 	}
-	_graphicsEngine->clearScene();
 	//Load new scene
 	_luaParser->loadScene(scenesPath + _currentScene);
+	if (_physxEngine != nullptr) {
+		//The actors of GameObjects no longer in the scene
+		_physxEngine->getCollection()->releaseUnbound();
+		//The static actors of the whole scene go into the scene at once
+		_physxEngine->flushActors();
+	}
 
 	start();
 }
 
-GameObject* Engine::addGameObject()
+GameObjectHandle Engine::addGameObject()
 {
-	_GOs.push_back(new GameObject());
-	return _GOs.back();
+	uint32_t index;
+	if (!_freeSlots.empty()) {
+		index = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+	else {
+		index = (uint32_t)_slots.size();
+		_slots.push_back({ 1, 0 });
+	}
+
+	GameObject* go = new GameObject();
+	go->_handle = GameObjectHandle(index, _slots[index].generation);
+	_slots[index].denseIndex = (uint32_t)_GOs.size();
+	_GOs.push_back(go);
+	_GOSlots.push_back(index);
+	return go->_handle;
 }
 
 void Engine::remGameObject(GameObject* GO)
 {
-	_deleteGOs.push_back(GO);
+	if (GO == nullptr) return;
+	remGameObject(GO->getHandle());
 }
 
-void Engine::remGameObjectString(const std::string& GOname)
+void Engine::remGameObject(GameObjectHandle handle)
 {
-	auto it = _GOs.begin();
-	while (it != _GOs.end()) {
-		if ((*it)->getName() == GOname) {
-			_deleteGOs.push_back(*it);
-			break;
-		}
-		else
-			it++;
+	if (!isAlive(handle)) {
+		Logger::getInstance()->log("Trying to remove a GameObject that doesn't exist", Logger::Level::WARN);
+		return;
 	}
+	_deleteGOs.push_back(handle);
 }
 
-GameObject* Engine::findGameObject(const std::string& name)
+void Engine::remGameObjectString(const std::string& GOname)
 {
-	auto it = _GOs.begin();
-	while (it != _GOs.end()) {
-		if ((*it)->getName() == name) {
-			break;
-		}
-		else
-			it++;
-	}
-	if (it == _GOs.end()) {
+	GameObjectHandle handle = findGameObject(GOname);
+	if (handle.isValid())
+		remGameObject(handle);
+}
+
+GameObjectHandle Engine::findGameObject(const std::string& name)
+{
+	auto it = _nameIds.find(name);
+	GameObjectHandle handle = it == _nameIds.end() ? GameObjectHandle() : findGameObject(it->second);
+	if (!handle.isValid())
 		Logger::getInstance()->log("The game object with the name " + name + " has not been found", Logger::Level::WARN);
-		return nullptr;
+	return handle;
+}
+
+GameObjectHandle Engine::findGameObject(uint32_t nameId)
+{
+	uint32_t index = nameId & _NAME_INDEX_MASK_;
+	if (index >= _names.size() || _names[index].generation != nameId >> _NAME_INDEX_BITS_ || _names[index].objects.empty())
+		return GameObjectHandle();
+	return _names[index].objects.front();
+}
+
+uint32_t Engine::internName(const std::string& name)
+{
+	auto it = _nameIds.find(name);
+	if (it != _nameIds.end())
+		return it->second;
+
+	uint32_t index;
+	if (!_freeNames.empty()) {
+		index = _freeNames.back();
+		_freeNames.pop_back();
 	}
-	return (*it);
+	else {
+		index = (uint32_t)_names.size();
+		_names.emplace_back();
+	}
+	_names[index].name = name;
+
+	uint32_t id = (_names[index].generation << _NAME_INDEX_BITS_) | index;
+	_nameIds.insert({ name, id });
+	return id;
+}
+
+void Engine::renameGameObject(GameObject* go, const std::string& name)
+{
+	unindexName(go);
+	go->_name = name;
+	if (name.empty()) return;
+
+	go->_nameId = internName(name);
+	std::vector<GameObjectHandle>& named = _names[go->_nameId & _NAME_INDEX_MASK_].objects;
+	go->_nameSlot = (uint32_t)named.size();
+	named.push_back(go->getHandle());
+}
+
+void Engine::unindexName(GameObject* go)
+{
+	if (go->_nameId == UINT32_MAX) return;
+
+	//The last GameObject with the name takes the place of the removed one
+	uint32_t index = go->_nameId & _NAME_INDEX_MASK_;
+	std::vector<GameObjectHandle>& named = _names[index].objects;
+	GameObjectHandle last = named.back();
+	named[go->_nameSlot] = last;
+	getGameObject(last)->_nameSlot = go->_nameSlot;
+	named.pop_back();
+
+	if (named.empty())
+		releaseName(index);
+	go->_nameId = UINT32_MAX;
+}
+
+void Engine::releaseName(uint32_t index)
+{
+	NameEntry& entry = _names[index];
+	_nameIds.erase(entry.name);
+	entry.name.clear();
+	entry.generation = (entry.generation + 1) & (UINT32_MAX >> _NAME_INDEX_BITS_);
+	_freeNames.push_back(index);
+}
+
+GameObject* Engine::getGameObject(GameObjectHandle handle) const
+{
+	if (!isAlive(handle))
+		return nullptr;
+	return _GOs[_slots[handle.index].denseIndex];
+}
+
+bool Engine::isAlive(GameObjectHandle handle) const
+{
+	return handle.isValid() && handle.index < _slots.size() && _slots[handle.index].generation == handle.generation;
+}
+
+void Engine::destroyGameObject(GameObjectHandle handle)
+{
+	GameObjectSlot& slot = _slots[handle.index];
+	uint32_t dense = slot.denseIndex;
+	GameObject* go = _GOs[dense];
+	unindexName(go);
+
+	//The slot is freed before deleting, so the handles of the GameObject are already stale for its components
+	uint32_t last = (uint32_t)_GOs.size() - 1;
+	_GOs[dense] = _GOs[last];
+	_GOSlots[dense] = _GOSlots[last];
+	_slots[_GOSlots[dense]].denseIndex = dense;
+	_GOs.pop_back();
+	_GOSlots.pop_back();
+
+	if (++slot.generation == 0) slot.generation = 1;
+	_freeSlots.push_back(handle.index);
+
+	delete go;
 }
 
 std::pair<int, int> Engine::getWindowSize()
 {
+	if (_graphicsEngine == nullptr)
+		return std::pair<int, int>(0, 0);
 	return _graphicsEngine->getWindowSize();
 }
 
 void Engine::setWindowFullScreen()
 {
-	_graphicsEngine->setFullScreen();
+	if (_graphicsEngine != nullptr)
+		_graphicsEngine->setFullScreen();
 }
 
 void Engine::setShadowColour(float r, float g, float b)
 {
-	_graphicsEngine->setShadowColour(r, g, b);
+	if (_graphicsEngine != nullptr)
+		_graphicsEngine->setShadowColour(r, g, b);
 }
 
 void Engine::setAmbientLight(float r, float g, float b)
 {
-	_graphicsEngine->setAmbientLight(r, g, b);
+	if (_graphicsEngine != nullptr)
+		_graphicsEngine->setAmbientLight(r, g, b);
 }
@@ -3,9 +3,15 @@
 #ifndef ENGINE_H
 #define ENGINE_H
 
-#include <list>
+#include <vector>
 #include <string>
+#include <unordered_map>
 #include <memory>
+#include <cstdint>
+#include <functional>
+
+#include "GameObjectHandle.h"
+#include "MotorFisico/PhysicsConfig.h"
 
 class GameObject;
 class GraphicsEngine;
@@ -16,9 +22,24 @@ class ComponentsFactory;
 
 class EngineTime;
 class LuaParser;
+class JobSystem;
+class MemoryArena;
+class WorldSnapshot;
+namespace physx {
+	class PxRigidActor;
+}
+
+namespace EngineMode {
+	enum EngineMode : unsigned int {
+		Default = 0,
+		//No window, graphics, audio or input. Graphic and audio components are not created
+		Headless
+	};
+}
 
 class Engine
 {
+	friend class GameObject;
 public:
 	~Engine();
 
@@ -39,7 +60,20 @@ public:
 	/// Initialize everything related to the Graphics, Physics and Audio engines
 	/// </summary>
 	/// <param name = "resourcesPath">: Resources path</param>
-	bool init(std::string const& resourcesPath, std::string const& scenesPath);
+	/// <param name = "mode">: Headless only initializes the physics, the graphic and audio components of the scenes are skipped</param>
+	/// <param name = "physicsConfig">: Lua file of the scenes path with the PhysicsConfig table, if empty the physics use the config given by setPhysicsConfig</param>
+	bool init(std::string const& resourcesPath, std::string const& scenesPath, EngineMode::EngineMode mode = EngineMode::Default,
+		const std::string& physicsConfig = "");
+
+	/// <summary>
+	/// Returns the mode the engine was initialized with
+	/// </summary>
+	inline EngineMode::EngineMode getMode() const { return _mode; }
+
+	/// <summary>
+	/// Returns true if there is no window, graphics, audio nor input
+	/// </summary>
+	inline bool isHeadless() const { return _mode == EngineMode::Headless; }
 
 	/// <summary>
 	/// Starts the main loop of the engine
@@ -52,6 +86,35 @@ public:
 	/// </summary>
 	void changeScene(const std::string& scene);
 
+	/// <summary>
+	/// Reads the prefabs of a file of the scenes path, see PrefabManager
+	/// </summary>
+	/// <param name="file">: Lua file with the prefabs</param>
+	bool loadPrefabs(const std::string& file);
+
+	/// <summary>
+	/// Reads the physics materials of a file of the scenes path, they are used with the Material field of the RigidBody and the colliders
+	/// </summary>
+	/// <param name="file">: Lua file with the materials</param>
+	bool loadPhysicsMaterials(const std::string& file);
+
+	/// <summary>
+	/// Changes the settings of the physics scene. Before init they are used to create it, after init they are applied
+	/// in the next scene change, once the GameObjects of the current scene are destroyed
+	/// </summary>
+	void setPhysicsConfig(const PhysicsConfig& config);
+
+	/// <summary>
+	/// Reads the PhysicsConfig table of a file of the scenes path and applies it like setPhysicsConfig
+	/// </summary>
+	/// <param name="file">: Lua file with the physics config</param>
+	bool loadPhysicsConfig(const std::string& file);
+
+	/// <summary>
+	/// Returns the settings of the physics scene, or the ones that will be used in the next scene change
+	/// </summary>
+	inline const PhysicsConfig& getPhysicsConfig() const { return _physicsConfig; }
+
 	//WIP
 	/// <summary>
 	/// Stops the main loop
@@ -59,16 +122,24 @@ public:
 	void stopExecution();
 
 	/// <summary>
-	/// Adds a GameObject to the list
+	/// Creates a GameObject and gives it a slot
 	/// </summary>
-	GameObject* addGameObject();
+	/// <returns>Returns the handle of the new GameObject, see getGameObject</returns>
+	GameObjectHandle addGameObject();
 
 	/// <summary>
-	/// Removes the first appeareance of a GameObject
+	/// Marks a GameObject to be destroyed at the end of the frame
 	/// <param name="GO">: GameObject to remove</param>
 	/// </summary>
 	void remGameObject(GameObject* GO);
 
+	/// <summary>
+	/// Marks the GameObject of the handle to be destroyed at the end of the frame
+	/// <para> Stale handles and GameObjects removed twice are ignored </para>
+	/// <param name="handle">: handle of the GameObject to remove</param>
+	/// </summary>
+	void remGameObject(GameObjectHandle handle);
+
 	/// <summary>
 	/// Removes the first appearance of a GameObject based on its name
 	/// <param name="GOname">: name of the GameObject to remove</param>
@@ -76,11 +147,45 @@ public:
 	void remGameObjectString(const std::string& GOname);
 
 	/// <summary>
-	/// Searches a GameObject by its name and returns it if found, or null if not
-	///<param name="componentId">: id of component</param>
-	/// <returns>Returns the GameObject if it is found</returns>
+	/// Searches a GameObject by its name
+	///<param name="name">: name of the GameObject</param>
+	/// <returns>Returns the handle of the GameObject if it is found, or an invalid handle if not</returns>
+	/// </summary>
+	GameObjectHandle findGameObject(const std::string& name);
+
+	/// <summary>
+	/// Searches a GameObject by the id of its name, see internName. Doesn't hash the name, so it's faster to look up the same name many times.
+	/// With several GameObjects with the name any of them is returned
+	/// </summary>
+	/// <returns>Returns the handle of the GameObject if it is found, or an invalid handle if not</returns>
+	GameObjectHandle findGameObject(uint32_t nameId);
+
+	/// <summary>
+	/// Returns the id of a GameObject name, adding it to the table if it's new
+	/// <para> The id lasts while a GameObject has the name, or until the scene changes if none takes it. Then it's given to
+	/// another name, and the old id stops finding anything </para>
+	/// </summary>
+	uint32_t internName(const std::string& name);
+
+	/// <summary>
+	/// Returns the GameObject of the handle, or nullptr if it has been destroyed
+	/// </summary>
+	GameObject* getGameObject(GameObjectHandle handle) const;
+
+	/// <summary>
+	/// Returns true if the GameObject of the handle has not been destroyed
+	/// </summary>
+	bool isAlive(GameObjectHandle handle) const;
+
+	/// <summary>
+	/// Returns the arena of the current scene, where the objects loaded without Persist are allocated
+	/// </summary>
+	inline MemoryArena* getSceneArena() const { return _sceneArena; }
+
+	/// <summary>
+	/// Returns the number of GameObjects alive
 	/// </summary>
-	GameObject* findGameObject(const std::string& name);
+	inline size_t getGameObjectCount() const { return _GOs.size(); }
 
 	/// </sumary>
 	/// Gets the window size
@@ -121,6 +226,49 @@ public:
 	/// </summary>
 	void disableShadows();
 
+	/// <summary>
+	/// Enables or disables the asynchronous physics: the last physic step of each frame runs while update, lateUpdate and render
+	/// use the previous results, and its results are fetched after render
+	/// <para> Changes made to the physx actors meanwhile are queued until the results are fetched </para>
+	/// </summary>
+	/// <param name="async">True to overlap physics with the rest of the frame</param>
+	void setAsyncPhysics(bool async);
+
+	/// <summary>
+	/// Returns true if the physics are simulated asynchronously
+	/// </summary>
+	inline bool getAsyncPhysics() const { return _asyncPhysics; }
+
+	/// <summary>
+	/// Saves the physics of every GameObject to a binary collection. Saved next to a scene as its name followed by .physx,
+	/// the next loads of the scene take the actors from it instead of creating them. It must be saved again when the physics of the scene change
+	/// </summary>
+	/// <exception cref="EPhysxEngine">thrown when the collection can't be serialized or written</exception>
+	void savePhysicsCollection(const std::string& file);
+
+	/// <summary>
+	/// Returns the next actor of the loaded physics collection for that component of the GameObject, nullptr if there isn't any
+	/// </summary>
+	physx::PxRigidActor* takeLoadedActor(const GameObject* go, unsigned int componentId);
+
+	/// <summary>
+	/// Copies the transforms of the GameObjects and the dynamic bodies to the snapshot, the step left simulating is finished first
+	/// </summary>
+	void captureSnapshot(WorldSnapshot& snapshot);
+
+	/// <summary>
+	/// Puts the transforms and the dynamic bodies back in the state of the snapshot
+	/// </summary>
+	void restoreSnapshot(const WorldSnapshot& snapshot);
+
+	/// <summary>
+	/// Restores the snapshot and simulates again steps physic steps from it, running the FixedUpdate and PostFixedUpdate phases
+	/// and dispatching the contact events of each one. The clock is not advanced, it's meant to be called between frames.
+	/// <para> The results only match the original steps with the enhancedDeterminism of the PhysicsConfig </para>
+	/// </summary>
+	/// <param name="beforeStep">Called before each step with its index, to apply the inputs of that step</param>
+	void resimulate(const WorldSnapshot& snapshot, unsigned int steps, const std::function<void(unsigned int)>& beforeStep = nullptr);
+
 protected:
 
 	/// <summary>
@@ -134,17 +282,23 @@ protected:
 	void start();
 
 	/// <summary>
-	/// Calls the FixedUpdate method of each GameObject in the list
+	/// Runs the FixedUpdate phase of the UpdateScheduler for every physic step required, and dispatches the contact events of each step
+	/// <para> If the physics are asynchronous the last step is left simulating </para>
 	/// </summary>
 	void fixedUpdate();
 
 	/// <summary>
-	/// Calls the Update method of each GameObject in the list
+	/// Waits for the physic step left simulating, dispatches its contact events and runs the PostFixedUpdate phase
+	/// </summary>
+	void syncPhysics();
+
+	/// <summary>
+	/// Updates the world transforms and runs the Update phase of the UpdateScheduler
 	/// </summary>
 	void update();
 
 	/// <summary>
-	/// Calls the LateUpdate method of each GameObject in the list
+	/// Runs the LateUpdate phase of the UpdateScheduler
 	/// </summary>
 	void lateUpdate();
 
@@ -179,21 +333,77 @@ private:
 	/// </summary>
 	void processEvents();
 
+	/// <summary>
+	/// Deletes the GameObject of the handle and frees its slot, its handles stop resolving
+	/// </summary>
+	void destroyGameObject(GameObjectHandle handle);
+
+	/// <summary>
+	/// Renames a GameObject and moves it in the name index, called by GameObject::setName
+	/// </summary>
+	void renameGameObject(GameObject* go, const std::string& name);
+
+	/// <summary>
+	/// Removes a GameObject from the name index, releasing the name if it was the last one with it
+	/// </summary>
+	void unindexName(GameObject* go);
+
+	/// <summary>
+	/// Frees the id of the name so it can be reused, the ids given before stop being valid
+	/// </summary>
+	void releaseName(uint32_t index);
+
+	/// <summary>
+	/// Interned name and the GameObjects alive with it, unordered
+	/// </summary>
+	struct NameEntry {
+		std::string name;
+		std::vector<GameObjectHandle> objects;
+		//Changes every time the entry is released, it's in the high bits of the name ids
+		uint32_t generation = 0;
+	};
+
+	/// <summary>
+	/// Slot of the GameObjects store. The handles point to a slot and the slot to the position of its GameObject in _GOs
+	/// </summary>
+	struct GameObjectSlot {
+		uint32_t generation;
+		uint32_t denseIndex;
+	};
+
 	PhysxEngine* _physxEngine;
 	GraphicsEngine* _graphicsEngine;
 	AudioEngine* _audioEngine;
-	std::list<GameObject*> _GOs;
-	std::list<GameObject*> _deleteGOs;
+	//GameObjects alive, packed to iterate them without holes. Removing one moves the last to its place
+	std::vector<GameObject*> _GOs;
+	//Owner slot of each position of _GOs
+	std::vector<uint32_t> _GOSlots;
+	std::vector<GameObjectSlot> _slots;
+	std::vector<uint32_t> _freeSlots;
+	std::vector<GameObjectHandle> _deleteGOs;
+
+	//Interned GameObject names, the low bits of a name id are its position
+	std::vector<NameEntry> _names;
+	std::unordered_map<std::string, uint32_t> _nameIds;
+	std::vector<uint32_t> _freeNames;
 
 	static std::unique_ptr<Engine> instance;
 
 	InputManager* _inputManager;
 	EngineTime* _time;
 	LuaParser* _luaParser;
+	JobSystem* _jobSystem;
+	MemoryArena* _sceneArena;
 
 	bool _run;
 	bool alredyInitialized;
 	bool _changeScene;
+	EngineMode::EngineMode _mode;
+	bool _asyncPhysics;
+	bool _physicsPending;
+	PhysicsConfig _physicsConfig;
+	//The config has changed since the physics scene was created
+	bool _physicsConfigChanged;
 
 	std::string scenesPath;
 	std::string _currentScene;
@@ -1,45 +1,58 @@
 #include "EngineTime.h"
 
-#include "SDL.h"
-
+#include <chrono>
 #include <ctime>
 
 std::unique_ptr<EngineTime> EngineTime::instance = nullptr;
 
-EngineTime::EngineTime(): _msTimeLastTick(), _deltaTime(0.0f), _msTimeLastFixed(), _maxDeltaTimeRecorded(0.0f), _fps(60), _fixedDeltaTime(20)
+EngineTime::EngineTime(): _timeLastTick(0), _fixedDeltaTime(20000000), _accumulator(0), _deltaTime(0.0f), _maxDeltaTimeRecorded(0.0f),
+	_maxFixedSteps(4), _fixedStepCount(0), _fps(60), _simulatedStep(0), _simulatedTicks(0)
 {
-	_msTimeLastTick = SDL_GetTicks();
-	_msTimeLastFixed = SDL_GetTicks();
+	_timeLastTick = getTicks();
 }
 
 void EngineTime::update()
 {
-	Uint32 timeNow = SDL_GetTicks();
+	if (isSimulated())
+		_simulatedTicks += _simulatedStep;
+
+	uint64_t timeNow = getTicks();
+	uint64_t elapsed = timeNow - _timeLastTick;
+	_timeLastTick = timeNow;
 
-	_deltaTime = static_cast<float>((timeNow - _msTimeLastTick)) / 1000.0f;
+	_deltaTime = static_cast<float>(elapsed / 1e9);
+	_accumulator += elapsed;
 
 	if (_deltaTime > _maxDeltaTimeRecorded)
 		_maxDeltaTimeRecorded = _deltaTime;
 
-	_msTimeLastTick = timeNow;
-
 	//I take the median between last tick fps and now, so it's more stable
 	//Adding 1 so it rounds up (unless both are equal)
-	_fps = (_fps + static_cast<int>(1.0f / _deltaTime) + 1) / 2;
+	if (_deltaTime > 0.0f)
+		_fps = (_fps + static_cast<int>(1.0f / _deltaTime) + 1) / 2;
 }
 
-void EngineTime::fixedTimeUpdate()
+unsigned int EngineTime::fixedUpdateRequired()
 {
-	Uint32 timeNow = SDL_GetTicks();
-
-	_msTimeLastFixed = timeNow;
+	uint64_t steps = _accumulator / _fixedDeltaTime;
+	//The whole steps over the budget are dropped, the remainder is kept for the next frame
+	if (steps > _maxFixedSteps) {
+		_accumulator -= (steps - _maxFixedSteps) * _fixedDeltaTime;
+		steps = _maxFixedSteps;
+	}
+	return static_cast<unsigned int>(steps);
 }
 
-int EngineTime::fixedUpdateRequired()
+void EngineTime::consumeFixedStep()
 {
-	Uint32 timeNow = SDL_GetTicks();
+	_accumulator -= _fixedDeltaTime;
+}
 
-	return (timeNow - _msTimeLastFixed) / _fixedDeltaTime;
+void EngineTime::setFixedDeltaTime(float newFixedDeltaTime)
+{
+	//A step shorter than a microsecond would never catch up with the clock
+	uint64_t step = static_cast<uint64_t>(static_cast<double>(newFixedDeltaTime) * 1e9);
+	_fixedDeltaTime = step > 1000 ? step : 1000;
 }
 
 EngineTime::~EngineTime()
@@ -56,17 +69,37 @@ EngineTime* EngineTime::getInstance()
 
 void EngineTime::startTimeNow()
 {
-	_msTimeLastTick = SDL_GetTicks();
-	_msTimeLastFixed = SDL_GetTicks();
+	_timeLastTick = getTicks();
+	_accumulator = 0;
 	_deltaTime = 0.0f;
 }
 
+void EngineTime::setSimulatedDeltaTime(float simulatedDeltaTime)
+{
+	_simulatedTicks = getTicks();
+	_simulatedStep = static_cast<uint64_t>(static_cast<double>(simulatedDeltaTime) * 1e9);
+	//The simulated clock may be ahead of the real one, the next frame starts from the clock in use now
+	_timeLastTick = getTicks();
+	_accumulator = 0;
+}
+
+uint64_t EngineTime::getTicks() const
+{
+	if (isSimulated())
+		return _simulatedTicks;
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
 EngineTime::Date EngineTime::getDate() const
 {
 	// get time
 	struct tm newtime;
 	time_t now = time(0);
+#ifdef _WIN32
 	localtime_s(&newtime, &now);
+#else
+	localtime_r(&now, &newtime);
+#endif
 
 	return { newtime.tm_sec, newtime.tm_min, newtime.tm_hour, newtime.tm_mday, newtime.tm_mon, newtime.tm_year + 1900, newtime.tm_wday };
 }
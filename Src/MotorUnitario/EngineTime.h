@@ -4,6 +4,7 @@
 #define TIME_H
 
 #include <memory>
+#include <cstdint>
 
 class EngineTime
 {
@@ -37,10 +38,21 @@ public:
 	inline float deltaTime() const { return _deltaTime; }
 
 	/// <summary>
-	/// Returns fixed delta time
+	/// Time simulated by each physics step
 	/// </summary>
-	/// <returns></returns>
-	inline float fixedDeltaTime() { return _fixedDeltaTime; }
+	/// <returns>seconds</returns>
+	inline float fixedDeltaTime() const { return _fixedDeltaTime / 1e9f; }
+
+	/// <summary>
+	/// Fraction of a physics step that the clock is ahead of the last step, in [0, 1).
+	/// The render blends the poses of the last two steps with it, so the bodies move smoothly at any frame rate
+	/// </summary>
+	inline float getInterpolationAlpha() const { return (float)((double)_accumulator / (double)_fixedDeltaTime); }
+
+	/// <summary>
+	/// Number of physics steps whose results have been written to the transforms
+	/// </summary>
+	inline uint64_t getFixedStepCount() const { return _fixedStepCount; }
 
 	/// <summary>
 	/// Maximum deltaTime recorded
@@ -64,7 +76,28 @@ public:
 	/// Sets the time between two calls to the phisycs engine
 	/// </summary>
 	/// <param name="newFixedDeltaTime"> The new value of fixed delta time in seconds</param>
-	inline void setFixedDeltaTime(unsigned int newFixedDeltaTime) { _fixedDeltaTime = newFixedDeltaTime * 1000.0f; }
+	void setFixedDeltaTime(float newFixedDeltaTime);
+
+	/// <summary>
+	/// Sets the maximum number of physics steps of a frame. When the frame is longer than that,
+	/// the time left is dropped and the game slows down instead of needing more steps every frame
+	/// </summary>
+	inline void setMaxFixedSteps(unsigned int maxSteps) { _maxFixedSteps = maxSteps > 0 ? maxSteps : 1; }
+
+	inline unsigned int getMaxFixedSteps() const { return _maxFixedSteps; }
+
+	/// <summary>
+	/// Makes the time advance a fixed amount every frame instead of following the clock,
+	/// so the simulation doesn't depend on the speed of the machine (used in headless mode).
+	/// The fixed steps pending are dropped, like in startTimeNow
+	/// </summary>
+	/// <param name="simulatedDeltaTime"> Time of each frame in seconds, 0 to use the clock again</param>
+	void setSimulatedDeltaTime(float simulatedDeltaTime);
+
+	/// <summary>
+	/// Returns true if the time advances a fixed amount every frame
+	/// </summary>
+	inline bool isSimulated() const { return _simulatedStep > 0; }
 
 private:
 	/// <summary>
@@ -73,31 +106,50 @@ private:
 	EngineTime();
 
 	/// <summary>
-	/// When called, calculates deltaTime with the time value it obtained last time it was called
+	/// When called, calculates deltaTime with the time value it obtained last time it was called,
+	/// and adds it to the time the physics have to simulate
 	/// </summary>
 	void update();
 
 	/// <summary>
-	/// When called, calculates deltaTime with the time value it obtained last time it was called
+	/// Returns the number of physics steps of this frame, at most the maximum number of steps
 	/// </summary>
-	void fixedTimeUpdate();
+	unsigned int fixedUpdateRequired();
 
 	/// <summary>
-	/// Returns the number of calls to the phisycs engine in this frame
+	/// Takes the time of a physics step from the accumulated time
 	/// </summary>
-	int fixedUpdateRequired();
+	void consumeFixedStep();
+
+	/// <summary>
+	/// Counts a physics step, called before its results are written to the transforms
+	/// </summary>
+	inline void nextFixedStep() { ++_fixedStepCount; }
+
+	/// <summary>
+	/// Returns the current time in nanoseconds, from the clock or simulated
+	/// </summary>
+	uint64_t getTicks() const;
 
 	static std::unique_ptr<EngineTime> instance;
 
-	unsigned int _msTimeLastTick;
-	unsigned int _msTimeLastFixed;
+	//Nanoseconds
+	uint64_t _timeLastTick;
+	uint64_t _fixedDeltaTime;
+	//Time of the clock that the physics haven't simulated yet
+	uint64_t _accumulator;
 
 	float _deltaTime;
-	unsigned int _fixedDeltaTime;
 	float _maxDeltaTimeRecorded;
 
+	unsigned int _maxFixedSteps;
+	uint64_t _fixedStepCount;
+
 	int _fps;
 
+	uint64_t _simulatedStep;
+	uint64_t _simulatedTicks;
+
 	/// <summary>
 	/// Used so only Engine is able to update deltaTime
 	/// if this methods were in public, the user could call those
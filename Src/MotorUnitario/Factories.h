@@ -11,11 +11,14 @@
 #include "AudioSourceComponent.h"
 #include "RigidBodyComponent.h"
 #include "ColliderComponent.h"
+#include "StaticGeometryComponent.h"
 #include "CameraComponent.h"
 #include "AnimatorComponent.h"
 #include "ParticleSystemComponent.h"
 #include "ButtonComponent.h"
 #include "OverlayComponent.h"
+#include "ActivatorComponent.h"
+#include "ActivatableComponent.h"
 #include "Transform.h"
 
 #ifndef TRANSFORMFACTORY_H
@@ -89,6 +92,27 @@ CMP_FACTORY(CapsuleColliderComponent);
 
 #endif // !CAPSULECOLLIDERCOMPONENTFACTORY_H
 
+#ifndef STATICGEOMETRYCOMPONENTFACTORY_H
+#define STATICGEOMETRYCOMPONENTFACTORY_H
+
+CMP_FACTORY(StaticGeometryComponent);
+
+#endif // !STATICGEOMETRYCOMPONENTFACTORY_H
+
+#ifndef MESHCOLLIDERCOMPONENTFACTORY_H
+#define MESHCOLLIDERCOMPONENTFACTORY_H
+
+CMP_FACTORY(MeshColliderComponent);
+
+#endif // !MESHCOLLIDERCOMPONENTFACTORY_H
+
+#ifndef CONVEXCOLLIDERCOMPONENTFACTORY_H
+#define CONVEXCOLLIDERCOMPONENTFACTORY_H
+
+CMP_FACTORY(ConvexColliderComponent);
+
+#endif // !CONVEXCOLLIDERCOMPONENTFACTORY_H
+
 #ifndef CAMERACOMPONENTFACTORY_H
 #define CAMERACOMPONENTFACTORY_H
 
@@ -124,4 +148,18 @@ CMP_FACTORY(OverlayComponent);
 
 #endif // !OVERLAYCOMPONENTFACTORY_H
 
+#ifndef ACTIVATORCOMPONENTFACTORY_H
+#define ACTIVATORCOMPONENTFACTORY_H
+
+CMP_FACTORY(ActivatorComponent);
+
+#endif // !ACTIVATORCOMPONENTFACTORY_H
+
+#ifndef ACTIVATABLECOMPONENTFACTORY_H
+#define ACTIVATABLECOMPONENTFACTORY_H
+
+CMP_FACTORY(ActivatableComponent);
+
+#endif // !ACTIVATABLECOMPONENTFACTORY_H
+
 #endif // !_FACTORIES_H
@@ -3,23 +3,38 @@
 #include "Exceptions.h"
 #include "Transform.h"
 #include "Engine.h"
+#include "UpdateScheduler.h"
+#include "MemoryArena.h"
 #include "includeLUA.h"
+#include "MotorFisico/ContactEvents.h"
+#include "Logger.h"
 
 #define _COMPONENT_START_SIZE_ 15
 #define _COMPONENT_INCREASE_SIZE_ size_t(5)
 
-GameObject::GameObject() : _components(_COMPONENT_START_SIZE_, nullptr), _name(), _enable(true), _persist(false)
+GameObject::GameObject() : _components(_COMPONENT_START_SIZE_, nullptr), _name(), _nameId(UINT32_MAX), _nameSlot(0), _handle(), _enable(true), _persist(false), _dormant(false)
 {
 }
 
 GameObject::~GameObject()
 {
 	for (auto c : _activeComponents) {
+		UpdateScheduler::getInstance()->unregisterComponent(c.second);
 		delete c.second; c.second = nullptr;
 	}
 	_activeComponents.clear();
 }
 
+void* GameObject::operator new(size_t size)
+{
+	return MemoryArena::allocateObject(size);
+}
+
+void GameObject::operator delete(void* ptr)
+{
+	MemoryArena::deallocateObject(ptr);
+}
+
 void GameObject::start()
 {
 	for (auto& comp : _activeComponents)
@@ -27,46 +42,59 @@ void GameObject::start()
 			comp.second->start();
 }
 
-void GameObject::update()
+void GameObject::reset()
 {
 	for (auto& comp : _activeComponents)
-		if (comp.second->getEnabled())
-			comp.second->update();
+		comp.second->reset();
 }
 
-void GameObject::fixedUpdate()
+void GameObject::onCollision(GameObject* other)
 {
 	for (auto& comp : _activeComponents)
 		if (comp.second->getEnabled())
-			comp.second->fixedUpdate();
+			comp.second->onCollision(other);
 }
 
-void GameObject::postFixedUpdate()
+void GameObject::onTrigger(GameObject* other)
 {
 	for (auto& comp : _activeComponents)
 		if (comp.second->getEnabled())
-			comp.second->postFixedUpdate();
+			comp.second->onTrigger(other);
 }
 
-void GameObject::lateUpdate()
+void GameObject::onContact(GameObjectHandle other, const ContactEvent& event)
 {
-	for (auto& comp : _activeComponents)
-		if (comp.second->getEnabled())
-			comp.second->lateUpdate();
+	//onCollision is called with the Stay events too, and onTrigger once when the trigger is entered
+	GameObject* otherGO = Engine::getInstance()->getGameObject(other);
+	bool collision = otherGO != nullptr && !event.trigger && event.state != ContactState::Exit;
+	bool trigger = otherGO != nullptr && event.trigger && event.state == ContactState::Enter;
+	for (auto& comp : _activeComponents) {
+		if (!comp.second->getEnabled()) continue;
+		comp.second->onContact(other, event);
+		if (collision) comp.second->onCollision(otherGO);
+		else if (trigger) comp.second->onTrigger(otherGO);
+	}
 }
 
-void GameObject::onCollision(GameObject* other)
+void GameObject::setName(const std::string& name)
 {
-	for (auto& comp : _activeComponents)
-		if (comp.second->getEnabled())
-			comp.second->onCollision(other);
+	Engine* engine = Engine::getInstance();
+	if (engine != nullptr && _handle.isValid())
+		engine->renameGameObject(this, name);
+	else
+		_name = name;
 }
 
-void GameObject::onTrigger(GameObject* other)
+void GameObject::onCollision(GameObjectHandle other)
 {
-	for (auto& comp : _activeComponents)
-		if (comp.second->getEnabled())
-			comp.second->onTrigger(other);
+	GameObject* go = Engine::getInstance()->getGameObject(other);
+	if (go != nullptr) onCollision(go);
+}
+
+void GameObject::onTrigger(GameObjectHandle other)
+{
+	GameObject* go = Engine::getInstance()->getGameObject(other);
+	if (go != nullptr) onTrigger(go);
 }
 
 void GameObject::addComponent(Component* component)
@@ -82,9 +110,25 @@ void GameObject::addComponent(Component* component)
 	if (_components[id] != nullptr)
 		throw ComponentException("Component already exists");
 
+	//The arena of the scene is released while a persistent GameObject is still alive
+	if (_persist && MemoryArena::getOwner(component) != nullptr)
+		throw ComponentException("The components of the persistent GameObject " + _name + " can't be allocated in the arena of the scene");
+
 	_components[id] = component;
 
 	insertInOrder(id, component);
+	//A dormant GameObject registers its components when it wakes up
+	if (!_dormant)
+		UpdateScheduler::getInstance()->registerComponent(component);
+}
+
+void GameObject::setPersist(bool persist)
+{
+	if (persist && MemoryArena::getOwner(this) != nullptr) {
+		Logger::getInstance()->log("The GameObject " + _name + " was allocated in the arena of the scene, it can't persist", Logger::Level::ERROR);
+		return;
+	}
+	_persist = persist;
 }
 
 void GameObject::removeComponent(unsigned int componentId)
@@ -94,6 +138,8 @@ void GameObject::removeComponent(unsigned int componentId)
 
 	removeFromActiveComponents(componentId);
 
+	if (_components[componentId] != nullptr)
+		UpdateScheduler::getInstance()->unregisterComponent(_components[componentId]);
 	delete _components[componentId];
 	_components[componentId] = nullptr;
 }
@@ -122,6 +168,20 @@ void GameObject::setEnabled(bool enable)
 			comp.second->setEnabled(_enable);
 }
 
+void GameObject::setDormant(bool dormant)
+{
+	if (_dormant == dormant) return;
+
+	_dormant = dormant;
+	for (auto& comp : _activeComponents) {
+		if (_dormant)
+			UpdateScheduler::getInstance()->unregisterComponent(comp.second);
+		else
+			UpdateScheduler::getInstance()->registerComponent(comp.second);
+		comp.second->onDormant(_dormant);
+	}
+}
+
 void GameObject::insertInOrder(unsigned int componentId, Component* component)
 {
 	auto begin = _activeComponents.begin();
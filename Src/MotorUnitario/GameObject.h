@@ -6,8 +6,12 @@
 #include <list>
 #include <vector>
 #include <string>
+#include <cstdint>
+
+#include "GameObjectHandle.h"
 
 class Component;
+struct ContactEvent;
 
 class GameObject {
 
@@ -20,37 +24,43 @@ public:
 
 	~GameObject();
 
+	/// <summary>
+	/// Allocated in the current MemoryArena if there is one, as the objects of the scene being loaded, or in the heap otherwise
+	/// </summary>
+	static void* operator new(size_t size);
+	static void operator delete(void* ptr);
+
 	/// <summary>
 	/// Calls start method of every component 
 	/// </summary>
 	void start();
 
 	/// <summary>
-	/// Calls update method of every component
+	/// Calls reset method of every component, used when a pooled instance of a Prefab is reused
 	/// </summary>
-	void update();
+	void reset();
+
+	void onCollision(GameObject* other);
+
+	void onTrigger(GameObject* other);
 
 	/// <summary>
-	/// Calls fixedUpdate method of every component
+	/// Calls onCollision with the GameObject of the handle, nothing is done if it has been destroyed
 	/// </summary>
-	void fixedUpdate();
+	void onCollision(GameObjectHandle other);
 
 	/// <summary>
-	/// Called after complete the physic simulation (only to set Trabsform)
+	/// Calls onTrigger with the GameObject of the handle, nothing is done if it has been destroyed
 	/// </summary>
-	void postFixedUpdate();
+	void onTrigger(GameObjectHandle other);
 
 	/// <summary>
-	/// Calls lateUpdate method of every component 
+	/// Calls onContact of every enabled component, and onCollision or onTrigger as they expect if the other GameObject is alive
 	/// </summary>
-	void lateUpdate();
-
-	void onCollision(GameObject* other);
-
-	void onTrigger(GameObject* other);
+	void onContact(GameObjectHandle other, const ContactEvent& event);
 
 	/// <summary>
-	/// Adds component to the gameObject vector of components
+	/// Adds component to the gameObject vector of components and registers it in the UpdateScheduler
 	/// <para> If id its bigger than the actual size of the vector of components, it increases the vector size </para>
 	/// <exception cref="Component.Exception">Thrown when componentId is less than 0 or component already exists</exception>
 	/// </summary>
@@ -83,8 +93,16 @@ public:
 		return _name;
 	}
 
-	inline void setName(const std::string& name) {
-		_name = name;
+	/// <summary>
+	/// Sets the name and updates the name index of the Engine
+	/// </summary>
+	void setName(const std::string& name);
+
+	/// <summary>
+	/// Returns the id of the name given by Engine::internName, UINT32_MAX if it has no name
+	/// </summary>
+	inline uint32_t getNameId() const {
+		return _nameId;
 	}
 
 	inline const bool getEnabled() const {
@@ -97,11 +115,35 @@ public:
 		return _persist;
 	}
 
-	inline void setPersist(bool persist) {
-		_persist = persist;
+	/// <summary>
+	/// Makes the GameObject survive the changes of scene. A GameObject allocated in the arena of the scene can't persist,
+	/// its memory is released with the scene: create it with Persist in Lua or out of the load of a scene
+	/// </summary>
+	void setPersist(bool persist);
+
+	/// <summary>
+	/// Returns true while the GameObject is out of every activation region, see ActivationRegions
+	/// </summary>
+	inline bool isDormant() const {
+		return _dormant;
+	}
+
+	/// <summary>
+	/// A dormant GameObject keeps its enabled state, but its components leave the UpdateScheduler
+	/// and are told with onDormant, so the physics ones stop simulating
+	/// </summary>
+	void setDormant(bool dormant);
+
+	/// <summary>
+	/// Returns the handle given by the Engine, invalid if the GameObject wasn't created by Engine::addGameObject
+	/// </summary>
+	inline GameObjectHandle getHandle() const {
+		return _handle;
 	}
 
 private:
+	friend class Engine;
+
 	/// <summary>
 	/// Inserts into active components a component ordered using its id
 	/// </summary>
@@ -120,8 +162,13 @@ private:
 	std::list<std::pair<unsigned int, Component*>> _activeComponents;
 
 	std::string _name;
+	uint32_t _nameId;
+	//Position of the handle in the GameObjects of its name in the Engine
+	uint32_t _nameSlot;
+
+	GameObjectHandle _handle;
 
-	bool _enable, _persist;
+	bool _enable, _persist, _dormant;
 };
 
 #endif GAMEOBJECT_H /* GameObject.h */
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef GAMEOBJECTHANDLE_H
+#define GAMEOBJECTHANDLE_H
+
+#include <cstdint>
+
+/// <summary>
+/// Reference to a GameObject of the Engine that can be stored safely
+/// <para> The index points to a slot of the Engine and the generation tells which object of that slot it refers to,
+/// once the GameObject is destroyed the generation of the slot changes and the handle stops resolving </para>
+/// </summary>
+struct GameObjectHandle {
+	uint32_t index;
+	//Generation 0 is never used by a slot, so a handle with it is always invalid
+	uint32_t generation;
+
+	GameObjectHandle() : index(0), generation(0) {}
+	GameObjectHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+	/// <summary>
+	/// Returns false for the default handle. A valid handle can still point to a destroyed GameObject, use Engine::isAlive
+	/// </summary>
+	inline bool isValid() const { return generation != 0; }
+
+	/// <summary>
+	/// Packs the handle in a single integer, useful as a key or to pass it to scripts
+	/// </summary>
+	inline uint64_t toId() const { return ((uint64_t)generation << 32) | index; }
+
+	static inline GameObjectHandle fromId(uint64_t id) { return GameObjectHandle((uint32_t)(id & 0xFFFFFFFF), (uint32_t)(id >> 32)); }
+
+	inline bool operator==(const GameObjectHandle& other) const { return index == other.index && generation == other.generation; }
+	inline bool operator!=(const GameObjectHandle& other) const { return !(*this == other); }
+};
+
+#endif /*GameObjectHandle.h*/
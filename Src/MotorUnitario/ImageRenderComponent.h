@@ -28,6 +28,11 @@ public:
 	/// </summary>
 	virtual void update() override;
 
+	/// <summary>
+	/// The component is only called in Update
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update); }
+
 	/// <summary>
 	/// Sets the dimensions(width and height) of the sprite
 	/// </summary>
@@ -0,0 +1,233 @@
+#include "JobSystem.h"
+#include "Logger.h"
+
+#include <exception>
+
+std::unique_ptr<JobSystem> JobSystem::instance = nullptr;
+
+namespace {
+	// Queue used by the current thread, workers use their own one and the rest share the 0
+	thread_local unsigned int currentQueue = 0;
+}
+
+struct JobSystem::Job {
+	JobFunction function;
+	// Dependencies not finished yet (plus one while the job is being scheduled)
+	std::atomic<int> unfinished{ 1 };
+	std::atomic<bool> done{ false };
+	std::exception_ptr error;
+
+	std::mutex mutex;
+	std::vector<JobHandle> continuations;
+};
+
+JobSystem::JobSystem(unsigned int workers) : _workers(), _queues(), _running(true), _pendingJobs(0), _sleepMutex(), _wakeUp()
+{
+	for (unsigned int i = 0; i <= workers; ++i)
+		_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+
+	for (unsigned int i = 1; i <= workers; ++i)
+		_workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	shutdown();
+}
+
+JobSystem* JobSystem::getInstance()
+{
+	return instance.get();
+}
+
+void JobSystem::CreateInstance(unsigned int workers)
+{
+	if (instance.get() == nullptr) {
+		if (workers == 0) {
+			unsigned int cores = std::thread::hardware_concurrency();
+			workers = cores > 1 ? cores - 1 : 0;
+		}
+		instance.reset(new JobSystem(workers));
+	}
+	else {
+		Logger::getInstance()->log("Trying to create JobSystem instance and it already exist", Logger::Level::WARN);
+	}
+}
+
+JobSystem::JobHandle JobSystem::schedule(JobFunction function, const std::vector<JobHandle>& dependencies)
+{
+	JobHandle job = std::make_shared<Job>();
+	job->function = std::move(function);
+
+	for (const JobHandle& dependency : dependencies) {
+		if (dependency == nullptr) continue;
+
+		std::lock_guard<std::mutex> lock(dependency->mutex);
+		if (!dependency->done) {
+			job->unfinished++;
+			dependency->continuations.push_back(job);
+		}
+	}
+
+	if (--job->unfinished == 0)
+		enqueue(job);
+
+	return job;
+}
+
+void JobSystem::wait(const JobHandle& job)
+{
+	if (job == nullptr) return;
+
+	while (!job->done) {
+		JobHandle other = findJob(currentQueue);
+		if (other != nullptr) execute(other);
+		else std::this_thread::yield();
+	}
+
+	if (job->error)
+		std::rethrow_exception(job->error);
+}
+
+bool JobSystem::isDone(const JobHandle& job) const
+{
+	return job == nullptr || job->done;
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const RangeFunction& function)
+{
+	if (grain == 0) grain = 1;
+
+	if (_workers.empty() || count <= grain) {
+		if (count > 0) function(0, count);
+		return;
+	}
+
+	std::vector<JobHandle> jobs;
+	jobs.reserve(count / grain);
+
+	//The calling thread does the first range by itself
+	for (size_t begin = grain; begin < count; begin += grain) {
+		size_t end = begin + grain < count ? begin + grain : count;
+		jobs.push_back(schedule([&function, begin, end]() { function(begin, end); }));
+	}
+
+	std::exception_ptr error;
+	try {
+		function(0, grain);
+	}
+	catch (...) {
+		error = std::current_exception();
+	}
+
+	//Every job must finish before leaving, they reference function
+	for (const JobHandle& job : jobs) {
+		try {
+			wait(job);
+		}
+		catch (...) {
+			if (!error) error = std::current_exception();
+		}
+	}
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void JobSystem::shutdown()
+{
+	if (!_running) return;
+
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_running = false;
+	}
+	_wakeUp.notify_all();
+
+	for (std::thread& worker : _workers)
+		if (worker.joinable()) worker.join();
+	_workers.clear();
+}
+
+void JobSystem::workerLoop(unsigned int queue)
+{
+	currentQueue = queue;
+
+	while (_running) {
+		JobHandle job = findJob(queue);
+		if (job != nullptr) {
+			execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_wakeUp.wait(lock, [this]() { return !_running || _pendingJobs > 0; });
+	}
+}
+
+void JobSystem::enqueue(const JobHandle& job)
+{
+	//Without workers nobody else would run it
+	if (_workers.empty()) {
+		execute(job);
+		return;
+	}
+
+	WorkQueue& queue = *_queues[currentQueue];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(job);
+	}
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_pendingJobs++;
+	}
+	_wakeUp.notify_one();
+}
+
+JobSystem::JobHandle JobSystem::findJob(unsigned int queue)
+{
+	JobHandle job = nullptr;
+	{
+		WorkQueue& own = *_queues[queue];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			job = own.jobs.back();
+			own.jobs.pop_back();
+		}
+	}
+
+	for (size_t i = 1; job == nullptr && i < _queues.size(); ++i) {
+		WorkQueue& other = *_queues[(queue + i) % _queues.size()];
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if (!other.jobs.empty()) {
+			job = other.jobs.front();
+			other.jobs.pop_front();
+		}
+	}
+
+	if (job != nullptr) _pendingJobs--;
+	return job;
+}
+
+void JobSystem::execute(const JobHandle& job)
+{
+	try {
+		job->function();
+	}
+	catch (...) {
+		job->error = std::current_exception();
+	}
+	job->function = nullptr;
+
+	std::vector<JobHandle> continuations;
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		job->done = true;
+		continuations.swap(job->continuations);
+	}
+
+	for (const JobHandle& next : continuations)
+		if (--next->unfinished == 0)
+			enqueue(next);
+}
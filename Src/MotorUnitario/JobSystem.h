@@ -0,0 +1,127 @@
+#pragma once
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/*
+Work-stealing thread pool owned by the engine.
+
+Every worker has its own queue: it takes the newest jobs of its queue and, when it's empty,
+steals the oldest ones from the other queues. Threads that are not workers (the main thread)
+push into a shared queue, and help executing jobs while they wait for one.
+*/
+class JobSystem
+{
+public:
+	using JobFunction = std::function<void()>;
+	using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	struct Job;
+	using JobHandle = std::shared_ptr<Job>;
+
+	~JobSystem();
+
+	/// <summary>
+	/// Returns the instance of JobSystem, or nullptr if it doesnt exist yet
+	/// </summary>
+	static JobSystem* getInstance();
+
+	/// <summary>
+	/// Creates the JobSystem singleton instance if its not already created
+	/// </summary>
+	/// <param name="workers">: number of worker threads, 0 to use one per core except the main thread's one</param>
+	static void CreateInstance(unsigned int workers = 0);
+
+	JobSystem& operator=(const JobSystem&) = delete;
+	JobSystem(JobSystem& other) = delete;
+
+	/// <summary>
+	/// Schedules a job that will run after all its dependencies are finished
+	/// </summary>
+	/// <param name="function">: work of the job</param>
+	/// <param name="dependencies">: jobs that must finish before this one starts</param>
+	/// <returns>Handle to wait for the job</returns>
+	JobHandle schedule(JobFunction function, const std::vector<JobHandle>& dependencies = {});
+
+	/// <summary>
+	/// Blocks until the job is finished, executing other jobs meanwhile
+	/// </summary>
+	/// <exception>Rethrows the exception thrown by the job, if any</exception>
+	void wait(const JobHandle& job);
+
+	/// <summary>
+	/// Returns true if the job has finished
+	/// </summary>
+	bool isDone(const JobHandle& job) const;
+
+	/// <summary>
+	/// Splits [0, count) in ranges of grain elements and runs them in parallel, returns when all of them are finished
+	/// </summary>
+	/// <param name="count">: number of elements</param>
+	/// <param name="grain">: maximum number of elements of each job</param>
+	/// <param name="function">: called with every range [begin, end)</param>
+	/// <exception>Rethrows the first exception thrown by any range</exception>
+	void parallelFor(size_t count, size_t grain, const RangeFunction& function);
+
+	/// <summary>
+	/// Returns the number of worker threads (the calling thread is not included)
+	/// </summary>
+	inline unsigned int getWorkerCount() const { return (unsigned int)_workers.size(); }
+
+	/// <summary>
+	/// Stops and joins every worker, the jobs still in the queues are not executed
+	/// </summary>
+	void shutdown();
+
+private:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	JobSystem(unsigned int workers);
+
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<JobHandle> jobs;
+	};
+
+	/// <summary>
+	/// Main loop of each worker
+	/// </summary>
+	void workerLoop(unsigned int queue);
+
+	/// <summary>
+	/// Pushes a job whose dependencies are finished into the queue of the calling thread
+	/// </summary>
+	void enqueue(const JobHandle& job);
+
+	/// <summary>
+	/// Takes a job from the given queue or steals one from the others, nullptr if there are none
+	/// </summary>
+	JobHandle findJob(unsigned int queue);
+
+	/// <summary>
+	/// Runs the job and releases the jobs that depend on it
+	/// </summary>
+	void execute(const JobHandle& job);
+
+	static std::unique_ptr<JobSystem> instance;
+
+	std::vector<std::thread> _workers;
+	// Queue 0 is shared by every thread that is not a worker
+	std::vector<std::unique_ptr<WorkQueue>> _queues;
+
+	std::atomic<bool> _running;
+	std::atomic<int> _pendingJobs;
+	std::mutex _sleepMutex;
+	std::condition_variable _wakeUp;
+};
+
+#endif // !JOBSYSTEM_H
@@ -1,4 +1,4 @@
-#include "KeyBoardInput.h"
+#include "KeyboardInput.h"
 #include "SDL_events.h"
 
 std::unique_ptr<KeyBoardInput> KeyBoardInput::instance = nullptr;
@@ -5,7 +5,7 @@
 #include "Transform.h"
 #include "MotorGrafico/Light.h"
 
-LightComponent::LightComponent() :Component(ComponentId::LightComponent), _light(nullptr), _tr(nullptr)
+LightComponent::LightComponent() :Component(ComponentId::LightComponent), _light(nullptr), _tr(nullptr), _syncedVersion(0)
 {
 }
 
@@ -53,9 +53,13 @@ void LightComponent::start()
 
 void LightComponent::update()
 {
-	float x = static_cast<float>(_tr->getPosition().getX());
-	float y = static_cast<float>(_tr->getPosition().getY());
-	float z = static_cast<float>(_tr->getPosition().getZ());
+	if (_tr->getWorldVersion() == _syncedVersion) return;
+	_syncedVersion = _tr->getWorldVersion();
+
+	Vector3 position = _tr->getWorldPosition();
+	float x = static_cast<float>(position.getX());
+	float y = static_cast<float>(position.getY());
+	float z = static_cast<float>(position.getZ());
 	_light->setPosition(x, y, z);
 }
 
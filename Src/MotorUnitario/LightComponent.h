@@ -42,6 +42,11 @@ public:
 	/// </summary>
 	void update() override;
 
+	/// <summary>
+	/// The component is only called in Update
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update); }
+
 	/// <summary>
 	/// Changes light type to given type
 	/// </summary>
@@ -200,6 +205,8 @@ private:
 	Light* _light;
 
 	Transform* _tr;
+	//Version of the transform copied last time, see Transform::getWorldVersion
+	unsigned int _syncedVersion;
 };
 
 #endif LIGHT_COMPONENT_H
@@ -7,7 +7,7 @@
 #include "includeLUA.h"
 #include "Exceptions.h"
 
-ListenerComponent::ListenerComponent() :Component(ComponentId::ListenerComponent), _tr(nullptr), _listener(new Listener())
+ListenerComponent::ListenerComponent() :Component(ComponentId::ListenerComponent), _tr(nullptr), _syncedVersion(0), _listener(new Listener())
 {
 
 }
@@ -75,9 +75,13 @@ void ListenerComponent::start()
 
 void ListenerComponent::update()
 {
-	float x = static_cast<float>(_tr->getPosition().getX());
-	float y = static_cast<float>(_tr->getPosition().getY());
-	float z = static_cast<float>(_tr->getPosition().getZ());
+	if (_tr->getWorldVersion() == _syncedVersion) return;
+	_syncedVersion = _tr->getWorldVersion();
+
+	Vector3 position = _tr->getWorldPosition();
+	float x = static_cast<float>(position.getX());
+	float y = static_cast<float>(position.getY());
+	float z = static_cast<float>(position.getZ());
 	_listener->setPosition(x, y, z);
 
 	Vector3 forward = _tr->getForward();
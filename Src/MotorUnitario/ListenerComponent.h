@@ -40,10 +40,17 @@ public:
 	/// </summary>
 	virtual void lateUpdate() override;
 
+	/// <summary>
+	/// The component is only called in Update and LateUpdate
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update) | UpdatePhase::mask(UpdatePhase::LateUpdate); }
+
 	void setListenerNumber(int listenNumber);
 
 private:
 	Transform* _tr;
+	//Version of the transform copied last time, see Transform::getWorldVersion
+	unsigned int _syncedVersion;
 	Listener* _listener;
 };
 
@@ -7,10 +7,26 @@
 #include "Engine.h"
 #include "Exceptions.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "MemoryArena.h"
+#include "PrefabManager.h"
+#include "MotorFisico/PhysxEngine.h"
+#include "MotorFisico/PhysicsCache.h"
+#include "MotorFisico/PhysicsConfig.h"
 
 #include "ComponentsFactory.h"
 #include "Component.h"
 
+/// <summary>
+/// Reads a list of pairs of layer names, { { "LayerA", "LayerB" }, ... }
+/// </summary>
+static void readLayerPairs(luabridge::LuaRef pairs, std::vector<PhysicsConfig::LayerPair>& layerPairs)
+{
+	layerPairs.clear();
+	for (int i = 1; i <= pairs.length(); ++i)
+		layerPairs.push_back({ pairs[i][1].cast<std::string>(), pairs[i][2].cast<std::string>() });
+}
+
 LuaParser::LuaParser()
 {
 #if (defined _DEBUG)
@@ -29,6 +45,7 @@ LuaParser::~LuaParser()
 
 bool LuaParser::loadScene(std::string scene)
 {
+	PROFILE_SCOPE("LuaParser::loadScene");
 	if (checkLua(LuaVM, luaL_dofile(LuaVM, scene.c_str()))) {
 		luabridge::getGlobalNamespace(LuaVM);
 		std::string baseName = "go_";
@@ -49,9 +66,12 @@ bool LuaParser::loadScene(std::string scene)
 			//Persist in scene
 			bool persist = gameObjectData_Lua["Persist"].cast<bool>();
 
-			GameObject* go = Engine::getInstance()->addGameObject();
-			if (persist && Engine::getInstance()->findGameObject(GO_name) != nullptr)
+			//A persistent GameObject already loaded by a previous scene is not created again
+			if (persist && Engine::getInstance()->findGameObject(Engine::getInstance()->internName(GO_name)).isValid())
 				continue;
+			//The objects of the scene share its arena, the persistent ones outlive it so they go to the heap
+			MemoryArena::Scope arenaScope(persist ? nullptr : Engine::getInstance()->getSceneArena());
+			GameObject* go = Engine::getInstance()->getGameObject(Engine::getInstance()->addGameObject());
 			go->setName(GO_name);
 			go->setPersist(persist);
 
@@ -80,6 +100,121 @@ bool LuaParser::loadScene(std::string scene)
 	return false;
 }
 
+bool LuaParser::loadPrefabs(const std::string& file)
+{
+	PROFILE_SCOPE("LuaParser::loadPrefabs");
+	if (checkLua(LuaVM, luaL_dofile(LuaVM, file.c_str()))) {
+		int howManyPrefabs = luabridge::getGlobal(LuaVM, "HowManyPrefabs");
+
+		for (int i = 0; i < howManyPrefabs; ++i) {
+			std::string prefabName = "prefab_" + std::to_string(i);
+			luabridge::LuaRef prefab_Lua = luabridge::getGlobal(LuaVM, prefabName.c_str());
+			std::string name = prefab_Lua[0]["Name"].cast<std::string>();
+
+			try {
+				PrefabManager::getInstance()->addPrefab(name, prefab_Lua);
+			}
+			catch (...) {
+				throw LuaComponentException("Error while reading the prefab " + name + " with Lua");
+			}
+		}
+		Logger::getInstance()->log("Lua prefabs properly initialized");
+		return true;
+	}
+	throw ExcepcionTAD("Can not open Lua file " + file);
+	return false;
+}
+
+bool LuaParser::loadPhysicsMaterials(const std::string& file)
+{
+	PROFILE_SCOPE("LuaParser::loadPhysicsMaterials");
+	if (checkLua(LuaVM, luaL_dofile(LuaVM, file.c_str()))) {
+		int howManyMaterials = luabridge::getGlobal(LuaVM, "HowManyMaterials");
+
+		for (int i = 0; i < howManyMaterials; ++i) {
+			std::string materialName = "material_" + std::to_string(i);
+			luabridge::LuaRef material_Lua = luabridge::getGlobal(LuaVM, materialName.c_str());
+			std::string name = material_Lua["Name"].cast<std::string>();
+
+			try {
+				PhysxEngine::getPxInstance()->getCache()->addMaterial(name, material_Lua["StaticFriction"].cast<float>(),
+					material_Lua["DynamicFriction"].cast<float>(), material_Lua["Restitution"].cast<float>());
+			}
+			catch (...) {
+				throw LuaComponentException("Error while reading the physics material " + name + " with Lua");
+			}
+		}
+		Logger::getInstance()->log("Lua physics materials properly initialized");
+		return true;
+	}
+	throw ExcepcionTAD("Can not open Lua file " + file);
+	return false;
+}
+
+bool LuaParser::loadPhysicsConfig(const std::string& file, PhysicsConfig& config)
+{
+	if (checkLua(LuaVM, luaL_dofile(LuaVM, file.c_str()))) {
+		luabridge::LuaRef data = luabridge::getGlobal(LuaVM, "PhysicsConfig");
+		if (data.isNil())
+			throw LuaComponentException("There is no PhysicsConfig table in " + file);
+
+		try {
+			if (LUAFIELDEXIST(Gravity)) {
+				luabridge::LuaRef gravity = data["Gravity"];
+				config.gravity = Vec3(gravity["X"].cast<float>(), gravity["Y"].cast<float>(), gravity["Z"].cast<float>());
+			}
+
+			if (LUAFIELDEXIST(BroadPhase)) {
+				std::string broadPhase = GETLUASTRINGFIELD(BroadPhase);
+				if (broadPhase == "SAP") config.broadPhase = PhysicsConfig::BroadPhase::SAP;
+				else if (broadPhase == "MBP") config.broadPhase = PhysicsConfig::BroadPhase::MBP;
+				else if (broadPhase == "ABP") config.broadPhase = PhysicsConfig::BroadPhase::ABP;
+				else Logger::getInstance()->log("Unknown broad phase " + broadPhase + " in " + file, Logger::Level::WARN);
+			}
+			if (LUAFIELDEXIST(WorldBounds)) {
+				luabridge::LuaRef min = data["WorldBounds"]["Min"];
+				luabridge::LuaRef max = data["WorldBounds"]["Max"];
+				config.worldMin = Vec3(min["X"].cast<float>(), min["Y"].cast<float>(), min["Z"].cast<float>());
+				config.worldMax = Vec3(max["X"].cast<float>(), max["Y"].cast<float>(), max["Z"].cast<float>());
+			}
+			if (LUAFIELDEXIST(Subdivisions)) config.subdivisions = GETLUAFIELD(Subdivisions, unsigned int);
+
+			if (LUAFIELDEXIST(PCM)) config.pcm = GETLUAFIELD(PCM, bool);
+
+			if (LUAFIELDEXIST(Solver)) {
+				std::string solver = GETLUASTRINGFIELD(Solver);
+				if (solver == "PGS") config.solver = PhysicsConfig::Solver::PGS;
+				else if (solver == "TGS") config.solver = PhysicsConfig::Solver::TGS;
+				else Logger::getInstance()->log("Unknown solver " + solver + " in " + file, Logger::Level::WARN);
+			}
+			if (LUAFIELDEXIST(PositionIterations)) config.positionIterations = GETLUAFIELD(PositionIterations, unsigned int);
+			if (LUAFIELDEXIST(VelocityIterations)) config.velocityIterations = GETLUAFIELD(VelocityIterations, unsigned int);
+
+			if (LUAFIELDEXIST(EnhancedDeterminism)) config.enhancedDeterminism = GETLUAFIELD(EnhancedDeterminism, bool);
+			if (LUAFIELDEXIST(CCD)) config.ccd = GETLUAFIELD(CCD, bool);
+			if (LUAFIELDEXIST(Stabilization)) config.stabilization = GETLUAFIELD(Stabilization, bool);
+			if (LUAFIELDEXIST(Threads)) config.threads = GETLUAFIELD(Threads, unsigned int);
+
+			if (LUAFIELDEXIST(Layers)) {
+				config.layers.clear();
+				for (int i = 1; i <= data["Layers"].length(); ++i)
+					config.layers.push_back(data["Layers"][i].cast<std::string>());
+			}
+			if (LUAFIELDEXIST(IgnoredCollisions)) readLayerPairs(data["IgnoredCollisions"], config.ignoredCollisions);
+			if (LUAFIELDEXIST(IgnoredNotifications)) readLayerPairs(data["IgnoredNotifications"], config.ignoredNotifications);
+			if (LUAFIELDEXIST(PersistentNotifications)) readLayerPairs(data["PersistentNotifications"], config.persistentNotifications);
+			if (LUAFIELDEXIST(ContactPoints)) readLayerPairs(data["ContactPoints"], config.contactPoints);
+		}
+		catch (...) {
+			throw LuaComponentException("Error while reading the physics config of " + file + " with Lua");
+		}
+		Logger::getInstance()->log("Lua physics config properly read");
+		return true;
+	}
+	throw ExcepcionTAD("Can not open Lua file " + file);
+	return false;
+}
+
 void LuaParser::closeLuaVM()
 {
 	lua_close(LuaVM);
@@ -96,6 +231,8 @@ bool LuaParser::checkLua(lua_State * L, int r)
 
 void LuaParser::attachComponent(GameObject* go, std::string cmp, luabridge::LuaRef &data) {
 	Component* co = ComponentsFactory::getInstance()->getComponentByName(cmp);
+	//The component is disabled in this engine mode
+	if (co == nullptr) return;
 	co->setGameObject(go);
 	co->awake(data);
 	go->addComponent(co);
@@ -17,6 +17,7 @@ extern "C"
 }
 #include "LuaBridge/LuaBridge.h"
 class GameObject;
+struct PhysicsConfig;
 
 //enum class ComponentType{ AudioSource, Transform, RigidBody, Collider, Light };
 
@@ -34,6 +35,23 @@ public:
 	/// </summary>
 	bool loadScene(std::string scene);
 
+	/// <summary>
+	/// Reads the prefabs of a file and adds them to the PrefabManager
+	/// <para> The file has HowManyPrefabs and prefab_N tables with the same format as the GameObjects of a scene </para>
+	/// </summary>
+	bool loadPrefabs(const std::string& file);
+
+	/// <summary>
+	/// Reads the physics materials of a file and adds them to the PhysicsCache
+	/// <para> The file has HowManyMaterials and material_N tables with Name, StaticFriction, DynamicFriction and Restitution </para>
+	/// </summary>
+	bool loadPhysicsMaterials(const std::string& file);
+
+	/// <summary>
+	/// Reads the PhysicsConfig table of a file, the fields that are not in the table keep their values in config
+	/// </summary>
+	bool loadPhysicsConfig(const std::string& file, PhysicsConfig& config);
+
 	/// <summary>
 	/// Closes the Lua virtual machine, do this when you stop using Lua
 	/// </summary>
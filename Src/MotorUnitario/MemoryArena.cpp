@@ -0,0 +1,113 @@
+#include "MemoryArena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+	thread_local MemoryArena* currentArena = nullptr;
+}
+
+MemoryArena::MemoryArena(size_t chunkSize) : _chunks(), _currentChunk(0), _chunkSize(chunkSize), _live(0)
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+	for (Chunk& chunk : _chunks)
+		::operator delete(chunk.data);
+	_chunks.clear();
+}
+
+void* MemoryArena::allocate(size_t size, size_t alignment)
+{
+	while (_currentChunk < _chunks.size()) {
+		Chunk& chunk = _chunks[_currentChunk];
+		size_t offset = (chunk.used + alignment - 1) & ~(alignment - 1);
+		if (offset + size <= chunk.size) {
+			chunk.used = offset + size;
+			++_live;
+			return chunk.data + offset;
+		}
+		//Chunks kept from a previous reset are reused before asking for new ones
+		++_currentChunk;
+	}
+
+	//Allocations bigger than a chunk get a chunk of their own
+	size_t chunkSize = std::max(_chunkSize, size + alignment);
+	Chunk chunk = { static_cast<char*>(::operator new(chunkSize)), chunkSize, 0 };
+	_chunks.push_back(chunk);
+	_currentChunk = _chunks.size() - 1;
+	return allocate(size, alignment);
+}
+
+void MemoryArena::deallocate(void* ptr)
+{
+	if (ptr != nullptr && _live > 0) --_live;
+}
+
+bool MemoryArena::owns(const void* ptr) const
+{
+	const char* p = static_cast<const char*>(ptr);
+	for (const Chunk& chunk : _chunks)
+		if (p >= chunk.data && p < chunk.data + chunk.size)
+			return true;
+	return false;
+}
+
+bool MemoryArena::reset()
+{
+	if (_live > 0)
+		return false;
+
+	for (Chunk& chunk : _chunks)
+		chunk.used = 0;
+	_currentChunk = 0;
+	return true;
+}
+
+size_t MemoryArena::getUsed() const
+{
+	size_t used = 0;
+	for (const Chunk& chunk : _chunks)
+		used += chunk.used;
+	return used;
+}
+
+MemoryArena* MemoryArena::getCurrent()
+{
+	return currentArena;
+}
+
+void* MemoryArena::allocateObject(size_t size)
+{
+	char* block = static_cast<char*>(currentArena != nullptr ? currentArena->allocate(HEADER_SIZE + size) : ::operator new(HEADER_SIZE + size));
+	*reinterpret_cast<MemoryArena**>(block) = currentArena;
+	return block + HEADER_SIZE;
+}
+
+void MemoryArena::deallocateObject(void* ptr)
+{
+	if (ptr == nullptr) return;
+
+	char* block = static_cast<char*>(ptr) - HEADER_SIZE;
+	MemoryArena* owner = getOwner(ptr);
+	if (owner != nullptr)
+		owner->deallocate(block);
+	else
+		::operator delete(block);
+}
+
+MemoryArena* MemoryArena::getOwner(const void* ptr)
+{
+	return *reinterpret_cast<MemoryArena* const*>(static_cast<const char*>(ptr) - HEADER_SIZE);
+}
+
+MemoryArena::Scope::Scope(MemoryArena* arena) : _previous(currentArena)
+{
+	currentArena = arena;
+}
+
+MemoryArena::Scope::~Scope()
+{
+	currentArena = _previous;
+}
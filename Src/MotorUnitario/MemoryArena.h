@@ -0,0 +1,117 @@
+#pragma once
+#ifndef MEMORYARENA_H
+#define MEMORYARENA_H
+
+#include <vector>
+#include <cstddef>
+
+/*
+Bump allocator made of big chunks. Allocating is moving a pointer and freeing does nothing,
+the memory of every allocation is released at once with reset.
+
+GameObjects and components are allocated in the arena of the current Scope, if there is one,
+so the objects of a scene are contiguous and unloading it doesn't go through the heap object by object.
+Objects that outlive the scene can't live in its arena: the persistent GameObjects and their components
+are allocated in the heap, see GameObject::setPersist.
+*/
+
+class MemoryArena
+{
+public:
+	/// <summary>
+	/// Creates an empty arena, no memory is reserved until the first allocation
+	/// </summary>
+	/// <param name="chunkSize">: size of each block of memory requested to the heap</param>
+	MemoryArena(size_t chunkSize = 256 * 1024);
+
+	~MemoryArena();
+
+	MemoryArena& operator=(const MemoryArena&) = delete;
+	MemoryArena(MemoryArena& other) = delete;
+
+	/// <summary>
+	/// Returns size bytes of the current chunk, adding a new one if it doesn't fit
+	/// </summary>
+	void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	/// <summary>
+	/// Marks an allocation as freed, the memory is not reused until reset
+	/// </summary>
+	void deallocate(void* ptr);
+
+	/// <summary>
+	/// Returns true if the pointer is inside one of the chunks of the arena
+	/// </summary>
+	bool owns(const void* ptr) const;
+
+	/// <summary>
+	/// Makes all the memory available again, keeping the chunks for the next allocations
+	/// <para> Nothing is done if there are allocations not freed, their objects would be overwritten </para>
+	/// </summary>
+	/// <returns>False if the arena couldn't be reset</returns>
+	bool reset();
+
+	/// <summary>
+	/// Returns the number of allocations not freed yet
+	/// </summary>
+	inline size_t getLiveCount() const { return _live; }
+
+	/// <summary>
+	/// Returns the bytes given since the last reset
+	/// </summary>
+	size_t getUsed() const;
+
+	/// <summary>
+	/// Returns the arena of the innermost Scope of this thread, nullptr if there is none
+	/// </summary>
+	static MemoryArena* getCurrent();
+
+	/// <summary>
+	/// Allocates from the current arena, or from the heap if there is none. Used by the operator new of GameObject and Component
+	/// </summary>
+	static void* allocateObject(size_t size);
+
+	/// <summary>
+	/// Frees memory returned by allocateObject
+	/// </summary>
+	static void deallocateObject(void* ptr);
+
+	/// <summary>
+	/// Returns the arena of memory returned by allocateObject, nullptr if it was allocated in the heap
+	/// </summary>
+	static MemoryArena* getOwner(const void* ptr);
+
+	/// <summary>
+	/// Makes an arena the current one while it exists. With nullptr the objects go to the heap
+	/// </summary>
+	class Scope
+	{
+	public:
+		Scope(MemoryArena* arena);
+		~Scope();
+
+		Scope& operator=(const Scope&) = delete;
+		Scope(Scope& other) = delete;
+
+	private:
+		MemoryArena* _previous;
+	};
+
+private:
+	struct Chunk {
+		char* data;
+		size_t size;
+		size_t used;
+	};
+
+	//Every allocateObject is preceded by a header with its arena, keeping the alignment of the object
+	static const size_t HEADER_SIZE = alignof(std::max_align_t);
+
+	std::vector<Chunk> _chunks;
+	//Chunk where the allocations are being made, the previous ones are full
+	size_t _currentChunk;
+	size_t _chunkSize;
+	size_t _live;
+};
+
+#endif // !MEMORYARENA_H
@@ -24,6 +24,11 @@ public:
 	/// </summary>
 	virtual void awake(luabridge::LuaRef& data) override;
 
+	/// <summary>
+	/// The component isn't called in any update phase
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::None; }
+
 	/// <summary>
 	/// Called before the main loop starts
 	/// </summary>
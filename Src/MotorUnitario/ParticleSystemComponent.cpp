@@ -6,7 +6,7 @@
 #include "includeLUA.h"
 #include "Exceptions.h"
 
-ParticleSystemComponent::ParticleSystemComponent() : Component(ComponentId::ParticleSystem), _pSystem(nullptr), _tr(nullptr), _path()
+ParticleSystemComponent::ParticleSystemComponent() : Component(ComponentId::ParticleSystem), _pSystem(nullptr), _tr(nullptr), _syncedVersion(0), _path()
 {
 }
 
@@ -38,7 +38,11 @@ void ParticleSystemComponent::start()
 
 void ParticleSystemComponent::update()
 {
-	_pSystem->setPosition(_tr->getPosition().getX(), _tr->getPosition().getY(), _tr->getPosition().getZ());
+	if (_tr->getWorldVersion() == _syncedVersion) return;
+	_syncedVersion = _tr->getWorldVersion();
+
+	Vector3 position = _tr->getWorldPosition();
+	_pSystem->setPosition(position.getX(), position.getY(), position.getZ());
 }
 
 void ParticleSystemComponent::setPath(std::string const& path)
@@ -31,11 +31,18 @@ public:
 	/// </summary>
 	virtual void update() override;
 
+	/// <summary>
+	/// The component is only called in Update
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update); }
+
 	void setPath(std::string const& path);
 
 private:
 	ParticleSystem* _pSystem;
 	Transform* _tr;
+	//Version of the transform copied last time, see Transform::getWorldVersion
+	unsigned int _syncedVersion;
 	// .particle route
 	std::string _path;
 };
@@ -0,0 +1,161 @@
+#include "Prefab.h"
+#include "GameObject.h"
+#include "Component.h"
+#include "ComponentFactory.h"
+#include "ComponentsFactory.h"
+#include "Engine.h"
+#include "Exceptions.h"
+#include "Logger.h"
+#include "MemoryArena.h"
+#include "includeLUA.h"
+
+#include <algorithm>
+
+Prefab::Prefab(const std::string& name, luabridge::LuaRef& gameObject) : _name(name), _persist(false), _components(),
+_instanceCount(0), _instances(), _poolSize(0), _pool()
+{
+	luabridge::LuaRef gameObjectData = gameObject[0];
+	int howMany = gameObjectData["HowManyCmps"].cast<int>();
+	if (!gameObjectData["Persist"].isNil())
+		_persist = gameObjectData["Persist"].cast<bool>();
+
+	for (int x = 1; x <= howMany; x++) {
+		luabridge::LuaRef componentData = gameObject[x];
+		std::string type = componentData["Component"].cast<std::string>();
+		//The table is referenced, so it's not read again from the file for each instance
+		_components.push_back({ type, ComponentsFactory::getInstance()->getFactory(type), new luabridge::LuaRef(componentData), nullptr, false });
+	}
+}
+
+Prefab::~Prefab()
+{
+	for (ComponentData& component : _components) {
+		delete component.data; component.data = nullptr;
+		delete component.state; component.state = nullptr;
+	}
+	_components.clear();
+}
+
+GameObject* Prefab::instantiate()
+{
+	while (!_pool.empty()) {
+		GameObject* go = Engine::getInstance()->getGameObject(_pool.back());
+		_pool.pop_back();
+		//Pooled instances can be destroyed by someone else
+		if (go == nullptr) continue;
+
+		go->reset();
+		go->setEnabled(true);
+		return go;
+	}
+
+	GameObject* go = create();
+	go->start();
+	return go;
+}
+
+void Prefab::release(GameObject* go)
+{
+	if (go == nullptr) return;
+
+	if (!isInstance(go)) {
+		Logger::getInstance()->log("The game object " + go->getName() + " is not an instance of the prefab " + _name, Logger::Level::WARN);
+		Engine::getInstance()->remGameObject(go);
+		return;
+	}
+
+	if (std::find(_pool.begin(), _pool.end(), go->getHandle()) != _pool.end())
+		return;
+
+	if (_pool.size() >= _poolSize) {
+		_instances.erase(go->getHandle().toId());
+		Engine::getInstance()->remGameObject(go);
+		return;
+	}
+
+	go->setEnabled(false);
+	_pool.push_back(go->getHandle());
+}
+
+void Prefab::setPoolSize(size_t size)
+{
+	_poolSize = size;
+	while (_pool.size() > _poolSize) {
+		GameObjectHandle handle = _pool.back();
+		_pool.pop_back();
+		_instances.erase(handle.toId());
+		if (Engine::getInstance()->isAlive(handle))
+			Engine::getInstance()->remGameObject(handle);
+	}
+}
+
+void Prefab::prewarm(size_t count)
+{
+	count = std::min(count, _poolSize);
+	while (_pool.size() < count) {
+		GameObject* go = create();
+		go->start();
+		go->setEnabled(false);
+		_pool.push_back(go->getHandle());
+	}
+}
+
+void Prefab::clearPool()
+{
+	Engine* engine = Engine::getInstance();
+	_pool.erase(std::remove_if(_pool.begin(), _pool.end(), [engine](GameObjectHandle handle) { return !engine->isAlive(handle); }), _pool.end());
+
+	for (auto it = _instances.begin(); it != _instances.end();) {
+		if (!engine->isAlive(GameObjectHandle::fromId(*it)))
+			it = _instances.erase(it);
+		else
+			++it;
+	}
+}
+
+bool Prefab::isInstance(const GameObject* go) const
+{
+	return go != nullptr && _instances.count(go->getHandle().toId()) > 0;
+}
+
+GameObject* Prefab::create()
+{
+	//An instance created while a scene is loading would go to its arena, the persistent ones outlive it
+	MemoryArena::Scope arenaScope(_persist ? nullptr : MemoryArena::getCurrent());
+	Engine* engine = Engine::getInstance();
+	GameObject* go = engine->getGameObject(engine->addGameObject());
+	go->setName(_name + "_" + std::to_string(_instanceCount++));
+	go->setPersist(_persist);
+
+	try {
+		for (ComponentData& component : _components) {
+			Component* co = component.factory->create();
+			//The component is disabled in this engine mode
+			if (co == nullptr) continue;
+
+			co->setGameObject(go);
+			try {
+				if (!component.stateRead) {
+					component.state = co->readState(*component.data);
+					component.stateRead = true;
+				}
+				if (component.state != nullptr) co->awakeFromState(*component.state);
+				else co->awake(*component.data);
+				go->addComponent(co);
+			}
+			catch (...) {
+				delete co;
+				throw LuaComponentException("Error while initialising component " + component.type + " of the prefab " + _name);
+			}
+		}
+	}
+	catch (...) {
+		//The half-built instance doesn't stay in the scene
+		go->setEnabled(false);
+		Engine::getInstance()->remGameObject(go->getHandle());
+		throw;
+	}
+
+	_instances.insert(go->getHandle().toId());
+	return go;
+}
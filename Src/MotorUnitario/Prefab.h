@@ -0,0 +1,107 @@
+#pragma once
+#ifndef PREFAB_H
+#define PREFAB_H
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+#include "GameObjectHandle.h"
+
+class GameObject;
+class ComponentFactory;
+struct ComponentState;
+namespace luabridge {
+	class LuaRef;
+}
+
+/// <summary>
+/// GameObject template read once from Lua. Its instances are created with the factories and data of the
+/// components kept from that read, and can be recycled through a pool instead of being destroyed
+/// <para> The components that support Component::readState are read from Lua by the first instance only,
+/// the next ones are awaken from the state kept </para>
+/// </summary>
+class Prefab
+{
+public:
+	/// <summary>
+	/// Reads the template from a table with the format of the GameObjects of the scenes
+	/// </summary>
+	/// <param name="name">: name of the prefab, its instances are called name_N</param>
+	/// <param name="gameObject">: table with the GameObject data at [0] and the components after it</param>
+	/// <exception cref="ComponentException">Thrown when a component doesn't exist</exception>
+	Prefab(const std::string& name, luabridge::LuaRef& gameObject);
+
+	~Prefab();
+
+	Prefab& operator=(const Prefab&) = delete;
+	Prefab(Prefab& other) = delete;
+
+	/// <summary>
+	/// Returns an instance of the prefab. A pooled one is reset and enabled, otherwise a new one is created and started
+	/// </summary>
+	GameObject* instantiate();
+
+	/// <summary>
+	/// Disables the instance and keeps it in the pool, or destroys it if the pool is full
+	/// </summary>
+	/// <param name="go">: instance of this prefab</param>
+	void release(GameObject* go);
+
+	/// <summary>
+	/// Sets how many instances can be kept disabled for reuse, 0 destroys every instance released
+	/// </summary>
+	void setPoolSize(size_t size);
+
+	/// <summary>
+	/// Creates disabled instances until there are count in the pool, so spawning them later doesn't create anything
+	/// </summary>
+	void prewarm(size_t count);
+
+	/// <summary>
+	/// Forgets the instances that have been destroyed, called after a scene is unloaded
+	/// </summary>
+	void clearPool();
+
+	/// <summary>
+	/// Returns true if the GameObject is an instance of this prefab
+	/// </summary>
+	bool isInstance(const GameObject* go) const;
+
+	inline const std::string& getName() const { return _name; }
+
+	inline size_t getPoolSize() const { return _poolSize; }
+
+	inline size_t getPooledCount() const { return _pool.size(); }
+
+private:
+	struct ComponentData {
+		std::string type;
+		ComponentFactory* factory;
+		luabridge::LuaRef* data;
+		//Values read by the first instance, nullptr if the type of component doesn't support it
+		ComponentState* state;
+		bool stateRead;
+	};
+
+	/// <summary>
+	/// Creates a new instance with a unique name and awakes its components
+	/// </summary>
+	/// <exception cref="LuaComponentException">Thrown when a component fails, the instance is removed</exception>
+	GameObject* create();
+
+	std::string _name;
+	bool _persist;
+	std::vector<ComponentData> _components;
+
+	//Used to give a unique name to each instance
+	unsigned int _instanceCount;
+	//Handles of the instances created, as ids
+	std::unordered_set<uint64_t> _instances;
+
+	size_t _poolSize;
+	std::vector<GameObjectHandle> _pool;
+};
+
+#endif // !PREFAB_H
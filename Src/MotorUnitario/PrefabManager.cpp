@@ -0,0 +1,85 @@
+#include "PrefabManager.h"
+#include "Prefab.h"
+#include "GameObject.h"
+#include "Engine.h"
+#include "Logger.h"
+
+std::unique_ptr<PrefabManager> PrefabManager::instance = nullptr;
+
+PrefabManager::PrefabManager() : _prefabs()
+{
+}
+
+PrefabManager::~PrefabManager()
+{
+	clear();
+}
+
+PrefabManager* PrefabManager::getInstance()
+{
+	if (instance.get() == nullptr) {
+		instance.reset(new PrefabManager());
+	}
+	return instance.get();
+}
+
+Prefab* PrefabManager::addPrefab(const std::string& name, luabridge::LuaRef& gameObject)
+{
+	Prefab* prefab = new Prefab(name, gameObject);
+
+	auto it = _prefabs.find(name);
+	if (it != _prefabs.end()) {
+		Logger::getInstance()->log("The prefab " + name + " has been loaded again, the previous one is replaced", Logger::Level::WARN);
+		delete it->second;
+		it->second = prefab;
+	}
+	else
+		_prefabs.insert({ name, prefab });
+
+	return prefab;
+}
+
+Prefab* PrefabManager::getPrefab(const std::string& name) const
+{
+	auto it = _prefabs.find(name);
+	if (it == _prefabs.end())
+		return nullptr;
+	return it->second;
+}
+
+GameObject* PrefabManager::instantiate(const std::string& name)
+{
+	Prefab* prefab = getPrefab(name);
+	if (prefab == nullptr) {
+		Logger::getInstance()->log("The prefab " + name + " has not been loaded", Logger::Level::WARN);
+		return nullptr;
+	}
+	return prefab->instantiate();
+}
+
+void PrefabManager::release(GameObject* go)
+{
+	if (go == nullptr) return;
+
+	for (auto& prefab : _prefabs) {
+		if (prefab.second->isInstance(go)) {
+			prefab.second->release(go);
+			return;
+		}
+	}
+	Engine::getInstance()->remGameObject(go);
+}
+
+void PrefabManager::clearPools()
+{
+	for (auto& prefab : _prefabs)
+		prefab.second->clearPool();
+}
+
+void PrefabManager::clear()
+{
+	for (auto& prefab : _prefabs) {
+		delete prefab.second; prefab.second = nullptr;
+	}
+	_prefabs.clear();
+}
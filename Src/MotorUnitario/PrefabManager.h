@@ -0,0 +1,71 @@
+#pragma once
+#ifndef PREFABMANAGER_H
+#define PREFABMANAGER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class Prefab;
+class GameObject;
+namespace luabridge {
+	class LuaRef;
+}
+
+/// <summary>
+/// Keeps the prefabs loaded by name. They are read with Engine::loadPrefabs
+/// </summary>
+class PrefabManager
+{
+public:
+	~PrefabManager();
+
+	/// <summary>
+	/// Returns the instance of PrefabManager, in case there is no such instance, it creates one and returns that one
+	/// </summary>
+	static PrefabManager* getInstance();
+	PrefabManager& operator=(const PrefabManager&) = delete;
+	PrefabManager(PrefabManager& other) = delete;
+
+	/// <summary>
+	/// Reads a prefab from its Lua table, replacing the one with the same name
+	/// </summary>
+	Prefab* addPrefab(const std::string& name, luabridge::LuaRef& gameObject);
+
+	/// <summary>
+	/// Returns the prefab with that name, or nullptr if it has not been loaded
+	/// </summary>
+	Prefab* getPrefab(const std::string& name) const;
+
+	/// <summary>
+	/// Returns an instance of the prefab with that name, nullptr if it doesn't exist
+	/// </summary>
+	GameObject* instantiate(const std::string& name);
+
+	/// <summary>
+	/// Returns an instance to the pool of its prefab, or removes it if it doesn't belong to any
+	/// </summary>
+	void release(GameObject* go);
+
+	/// <summary>
+	/// Forgets the pooled instances destroyed with the last scene
+	/// </summary>
+	void clearPools();
+
+	/// <summary>
+	/// Deletes every prefab, it must be done before closing the Lua virtual machine
+	/// </summary>
+	void clear();
+
+private:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	PrefabManager();
+
+	static std::unique_ptr<PrefabManager> instance;
+
+	std::unordered_map<std::string, Prefab*> _prefabs;
+};
+
+#endif // !PREFABMANAGER_H
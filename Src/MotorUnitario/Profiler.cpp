@@ -0,0 +1,212 @@
+#include "Profiler.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+
+std::unique_ptr<Profiler> Profiler::instance = nullptr;
+
+#define _PROFILER_DEFAULT_FRAMES_ 300
+#define _PROFILER_DEFAULT_TRACE_ "Assets/Logs/trace.json"
+
+namespace {
+	std::string escapeJson(const std::string& text)
+	{
+		std::string escaped;
+		for (char c : text) {
+			if (c == '"' || c == '\\') escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+}
+
+Profiler::Profiler() : _origin(std::chrono::steady_clock::now()), _mainThread(std::this_thread::get_id()),
+_names(), _nameIds(), _frames(_PROFILER_DEFAULT_FRAMES_), _currentFrame(0), _frameNumber(0), _finishedFrames(0), _depth(0),
+_tracePath(_PROFILER_DEFAULT_TRACE_)
+{
+	_frames[_currentFrame].number = _frameNumber;
+	_frames[_currentFrame].start = now();
+	_frames[_currentFrame].end = -1;
+}
+
+Profiler::~Profiler()
+{
+}
+
+Profiler* Profiler::getInstance()
+{
+	if (instance.get() == nullptr) {
+		instance.reset(new Profiler());
+	}
+	return instance.get();
+}
+
+unsigned int Profiler::internName(const std::string& name)
+{
+	auto it = _nameIds.find(name);
+	if (it != _nameIds.end())
+		return it->second;
+
+	unsigned int id = (unsigned int)_names.size();
+	_names.push_back(name);
+	_nameIds.insert({ name, id });
+	return id;
+}
+
+const std::string& Profiler::getName(unsigned int nameId) const
+{
+	return _names.at(nameId);
+}
+
+int Profiler::beginZone(unsigned int nameId)
+{
+	if (std::this_thread::get_id() != _mainThread)
+		return -1;
+
+	std::vector<Zone>& zones = _frames[_currentFrame].zones;
+	zones.push_back({ nameId, _depth++, now(), -1 });
+	return (int)zones.size() - 1;
+}
+
+void Profiler::endZone(int zone)
+{
+	if (zone < 0) return;
+
+	std::vector<Zone>& zones = _frames[_currentFrame].zones;
+	//The frame changed while the zone was open
+	if (zone >= (int)zones.size()) return;
+
+	zones[zone].end = now();
+	--_depth;
+}
+
+void Profiler::newFrame()
+{
+	long long time = now();
+	_frames[_currentFrame].end = time;
+	if (_finishedFrames + 1 < _frames.size()) ++_finishedFrames;
+
+	_currentFrame = (_currentFrame + 1) % _frames.size();
+	Frame& frame = _frames[_currentFrame];
+	frame.number = ++_frameNumber;
+	frame.start = time;
+	frame.end = -1;
+	//Keeps the memory of the vector, so recording doesn't allocate once the buffer is warm
+	frame.zones.clear();
+	_depth = 0;
+}
+
+void Profiler::setFrameCount(size_t frames)
+{
+	if (frames < 2) frames = 2;
+
+	_frames.clear();
+	_frames.resize(frames);
+	_currentFrame = 0;
+	_finishedFrames = 0;
+	_frames[_currentFrame].number = _frameNumber;
+	_frames[_currentFrame].start = now();
+	_frames[_currentFrame].end = -1;
+	_depth = 0;
+}
+
+bool Profiler::dumpChromeTrace(const std::string& file) const
+{
+	std::ofstream out(file, std::fstream::out);
+	if (!out.is_open())
+		return false;
+
+	out << "{\"traceEvents\":[";
+	out << std::fixed << std::setprecision(3);
+
+	bool first = true;
+	for (size_t i = _frames.size(); i-- > 0;) {
+		const Frame* frame = getFrame(i);
+		if (frame == nullptr) continue;
+
+		if (!first) out << ",";
+		first = false;
+		out << "\n{\"name\":\"Frame " << frame->number << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":"
+			<< frame->start / 1000.0 << ",\"dur\":" << (frame->end - frame->start) / 1000.0 << "}";
+
+		for (const Zone& zone : frame->zones) {
+			long long end = zone.end < 0 ? frame->end : zone.end;
+			out << ",\n{\"name\":\"" << escapeJson(_names[zone.name]) << "\",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":"
+				<< zone.start / 1000.0 << ",\"dur\":" << (end - zone.start) / 1000.0 << "}";
+		}
+	}
+
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return true;
+}
+
+std::string Profiler::getFrameSummary(size_t framesAgo) const
+{
+	const Frame* frame = getFrame(framesAgo);
+	if (frame == nullptr)
+		return "";
+
+	//Zones with the same name and parent are added up, keeping the order of their first appearance
+	struct Entry { unsigned int depth; unsigned int name; double ms; int calls; };
+	std::vector<Entry> entries;
+	std::map<std::pair<size_t, unsigned int>, size_t> index;
+	//Entry of the last zone opened at each depth
+	std::vector<size_t> parents;
+
+	for (const Zone& zone : frame->zones) {
+		long long end = zone.end < 0 ? frame->end : zone.end;
+		double ms = (end - zone.start) / 1000000.0;
+
+		parents.resize(zone.depth);
+		size_t parent = zone.depth == 0 ? entries.max_size() : parents[zone.depth - 1];
+
+		auto key = std::make_pair(parent, zone.name);
+		auto it = index.find(key);
+		size_t entry;
+		if (it == index.end()) {
+			entry = entries.size();
+			index.insert({ key, entry });
+			entries.push_back({ zone.depth, zone.name, ms, 1 });
+		}
+		else {
+			entry = it->second;
+			entries[entry].ms += ms;
+			entries[entry].calls++;
+		}
+		parents.push_back(entry);
+	}
+
+	std::ostringstream summary;
+	summary << std::fixed << std::setprecision(3);
+	summary << "Frame " << frame->number << ": " << (frame->end - frame->start) / 1000000.0 << " ms\n";
+	for (const Entry& entry : entries) {
+		summary << std::string((entry.depth + 1) * 2, ' ') << _names[entry.name] << ": " << entry.ms << " ms";
+		if (entry.calls > 1) summary << " (" << entry.calls << " calls)";
+		summary << '\n';
+	}
+	return summary.str();
+}
+
+double Profiler::getFrameTime(size_t framesAgo) const
+{
+	const Frame* frame = getFrame(framesAgo);
+	if (frame == nullptr)
+		return 0.0;
+	return (frame->end - frame->start) / 1000000.0;
+}
+
+long long Profiler::now() const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _origin).count();
+}
+
+const Profiler::Frame* Profiler::getFrame(size_t framesAgo) const
+{
+	if (framesAgo >= _finishedFrames)
+		return nullptr;
+
+	size_t i = (_currentFrame + _frames.size() - 1 - framesAgo) % _frames.size();
+	return &_frames[i];
+}
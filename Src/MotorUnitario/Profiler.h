@@ -0,0 +1,170 @@
+#pragma once
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+
+/*
+Hierarchical frame profiler. The zones are only recorded when MOTOR_PROFILE is defined, as in the Debug
+configurations, otherwise every PROFILE_ macro is empty and nothing is measured.
+
+Only the main thread records zones. The last frames are kept in a ring buffer that can be
+dumped as a Chrome trace (chrome://tracing or Perfetto) or as a summary per frame.
+*/
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef MOTOR_PROFILE
+//Measures the rest of the current scope, name must be constant
+#define PROFILE_SCOPE(name)																				\
+	static const unsigned int PROFILE_CONCAT(_profileName, __LINE__) = Profiler::getInstance()->internName(name);	\
+	ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(PROFILE_CONCAT(_profileName, __LINE__))
+//Measures the rest of the current scope, with a name returned by Profiler::internName
+#define PROFILE_SCOPE_ID(nameId) ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(nameId)
+//Closes the current frame and starts a new one
+#define PROFILE_FRAME() Profiler::getInstance()->newFrame()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_SCOPE_ID(nameId)
+#define PROFILE_FRAME()
+#endif
+
+class Profiler
+{
+public:
+	~Profiler();
+
+	/// <summary>
+	/// Returns the instance of Profiler, in case there is no such instance, it creates one and returns that one
+	/// </summary>
+	static Profiler* getInstance();
+	Profiler& operator=(const Profiler&) = delete;
+	Profiler(Profiler& other) = delete;
+
+	/// <summary>
+	/// Returns the id of the name, adding it to the table if it's new
+	/// </summary>
+	/// <param name="name">: name of a zone</param>
+	unsigned int internName(const std::string& name);
+
+	/// <summary>
+	/// Returns the name of an id returned by internName
+	/// </summary>
+	const std::string& getName(unsigned int nameId) const;
+
+	/// <summary>
+	/// Opens a zone in the current frame, returns its index or -1 if it's not recorded
+	/// </summary>
+	int beginZone(unsigned int nameId);
+
+	/// <summary>
+	/// Closes the zone opened by beginZone
+	/// </summary>
+	void endZone(int zone);
+
+	/// <summary>
+	/// Closes the current frame and starts recording the next one, overwriting the oldest
+	/// </summary>
+	void newFrame();
+
+	/// <summary>
+	/// Sets how many frames are kept, the frames recorded are cleared
+	/// </summary>
+	void setFrameCount(size_t frames);
+
+	/// <summary>
+	/// Writes the frames recorded in Chrome trace_event format
+	/// </summary>
+	/// <param name="file">: path of the json file</param>
+	/// <returns>False if the file couldn't be opened</returns>
+	bool dumpChromeTrace(const std::string& file) const;
+
+	/// <summary>
+	/// Sets the file where the Engine writes the Chrome trace when it shuts down, an empty path doesn't write it
+	/// </summary>
+	inline void setTracePath(const std::string& file) { _tracePath = file; }
+	inline const std::string& getTracePath() const { return _tracePath; }
+
+	/// <summary>
+	/// Returns the time of every zone of a finished frame, added up by name and indented by depth
+	/// </summary>
+	/// <param name="framesAgo">: 0 for the last finished frame</param>
+	std::string getFrameSummary(size_t framesAgo = 0) const;
+
+	/// <summary>
+	/// Duration of a finished frame in milliseconds, 0 if it doesn't exist
+	/// </summary>
+	/// <param name="framesAgo">: 0 for the last finished frame</param>
+	double getFrameTime(size_t framesAgo = 0) const;
+
+private:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	Profiler();
+
+	struct Zone {
+		unsigned int name;
+		unsigned int depth;
+		long long start;
+		long long end;
+	};
+
+	struct Frame {
+		unsigned long long number;
+		long long start;
+		long long end;
+		std::vector<Zone> zones;
+	};
+
+	/// <summary>
+	/// Nanoseconds since the profiler was created
+	/// </summary>
+	long long now() const;
+
+	/// <summary>
+	/// Returns the finished frame framesAgo frames before the current one, nullptr if it doesn't exist
+	/// </summary>
+	const Frame* getFrame(size_t framesAgo) const;
+
+	static std::unique_ptr<Profiler> instance;
+
+	std::chrono::steady_clock::time_point _origin;
+	std::thread::id _mainThread;
+
+	std::vector<std::string> _names;
+	std::unordered_map<std::string, unsigned int> _nameIds;
+
+	std::vector<Frame> _frames;
+	size_t _currentFrame;
+	unsigned long long _frameNumber;
+	// Frames in the buffer that are finished, the current one is still open
+	size_t _finishedFrames;
+	unsigned int _depth;
+
+	std::string _tracePath;
+};
+
+/// <summary>
+/// Opens a zone when created and closes it when destroyed
+/// </summary>
+class ProfileScope
+{
+public:
+	ProfileScope(unsigned int nameId) : _zone(Profiler::getInstance()->beginZone(nameId)) {}
+	~ProfileScope() { Profiler::getInstance()->endZone(_zone); }
+
+	ProfileScope& operator=(const ProfileScope&) = delete;
+	ProfileScope(ProfileScope& other) = delete;
+
+private:
+	int _zone;
+};
+
+#endif // !PROFILER_H
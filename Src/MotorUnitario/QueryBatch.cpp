@@ -0,0 +1,89 @@
+#include "QueryBatch.h"
+#include "MotorFisico/CollisionLayers.h"
+#include "JobSystem.h"
+#include "GameObject.h"
+#include "Logger.h"
+
+QueryBatch::QueryBatch(size_t queryCapacity, size_t hitCapacity) : _batch(queryCapacity, hitCapacity), _hits(), _firstHits()
+{
+	_hits.reserve(hitCapacity);
+	_firstHits.reserve(queryCapacity);
+}
+
+uint32_t QueryBatch::getLayerMask(const std::vector<std::string>& layers)
+{
+	uint32_t mask = 0;
+	for (const std::string& name : layers) {
+		int layer = CollisionLayers::getInstance()->getLayer(name);
+		if (layer < 0)
+			Logger::getInstance()->log("There is no collision layer " + name + ", the queries won't hit it", Logger::Level::WARN);
+		else
+			mask |= CollisionLayers::getMask(layer);
+	}
+	return mask;
+}
+
+size_t QueryBatch::addRaycast(const Vector3& source, const Vector3& directionVector, float distance, uint32_t layers, unsigned int maxHits, RayCast::Type collidesWith)
+{
+	return _batch.addRaycast(source.toVec3(), directionVector.toVec3(), distance, layers, maxHits, (PxRayCast::Type)collidesWith);
+}
+
+size_t QueryBatch::addSphereSweep(const Vector3& center, float radius, const Vector3& directionVector, float distance, uint32_t layers, unsigned int maxHits, RayCast::Type collidesWith)
+{
+	return _batch.addSphereSweep(center.toVec3(), radius, directionVector.toVec3(), distance, layers, maxHits, (PxRayCast::Type)collidesWith);
+}
+
+size_t QueryBatch::addBoxSweep(const Vector3& center, const Vector3& halfExtents, const Quat& orientation, const Vector3& directionVector, float distance,
+	uint32_t layers, unsigned int maxHits, RayCast::Type collidesWith)
+{
+	return _batch.addBoxSweep(center.toVec3(), halfExtents.toVec3(), orientation, directionVector.toVec3(), distance, layers, maxHits, (PxRayCast::Type)collidesWith);
+}
+
+size_t QueryBatch::addCapsuleSweep(const Vector3& center, float radius, float halfHeight, const Quat& orientation, const Vector3& directionVector, float distance,
+	uint32_t layers, unsigned int maxHits, RayCast::Type collidesWith)
+{
+	return _batch.addCapsuleSweep(center.toVec3(), radius, halfHeight, orientation, directionVector.toVec3(), distance, layers, maxHits, (PxRayCast::Type)collidesWith);
+}
+
+size_t QueryBatch::addSphereOverlap(const Vector3& center, float radius, uint32_t layers, unsigned int maxHits, RayCast::Type collidesWith)
+{
+	return _batch.addSphereOverlap(center.toVec3(), radius, layers, maxHits, (PxRayCast::Type)collidesWith);
+}
+
+size_t QueryBatch::addBoxOverlap(const Vector3& center, const Vector3& halfExtents, const Quat& orientation, uint32_t layers, unsigned int maxHits, RayCast::Type collidesWith)
+{
+	return _batch.addBoxOverlap(center.toVec3(), halfExtents.toVec3(), orientation, layers, maxHits, (PxRayCast::Type)collidesWith);
+}
+
+size_t QueryBatch::addCapsuleOverlap(const Vector3& center, float radius, float halfHeight, const Quat& orientation, uint32_t layers, unsigned int maxHits, RayCast::Type collidesWith)
+{
+	return _batch.addCapsuleOverlap(center.toVec3(), radius, halfHeight, orientation, layers, maxHits, (PxRayCast::Type)collidesWith);
+}
+
+void QueryBatch::execute()
+{
+	JobSystem* jobs = JobSystem::getInstance();
+	if (jobs == nullptr)
+		_batch.execute();
+	else
+		_batch.execute([jobs](size_t count, size_t grain, const PxQueryBatch::RangeFunction& function) {
+			jobs->parallelFor(count, grain, function);
+		});
+
+	//The GameObjects of the hits are alive until the frame goes on, their handles are what can be kept
+	_hits.clear();
+	_firstHits.resize(_batch.size());
+	for (size_t query = 0; query < _batch.size(); ++query) {
+		_firstHits[query] = _hits.size();
+		const PxQueryBatch::Hit* hits = _batch.getHits(query);
+		for (unsigned int i = 0; i < _batch.getHitCount(query); ++i)
+			_hits.push_back({ hits[i].gameObject->getHandle(), hits[i].position, hits[i].normal, hits[i].distance });
+	}
+}
+
+void QueryBatch::clear()
+{
+	_batch.clear();
+	_hits.clear();
+	_firstHits.clear();
+}
@@ -0,0 +1,140 @@
+#pragma once
+#ifndef QUERYBATCH_H
+#define QUERYBATCH_H
+
+#include "Vector3.h"
+#include "RayCast.h"
+#include "GameObjectHandle.h"
+#include "MotorFisico/QueryBatch.h"
+#include <vector>
+#include <string>
+
+/*
+Batch of raycasts, sweeps and overlaps that run together in the workers of the JobSystem.
+
+Meant to be kept and refilled every frame: clear keeps the memory of the queries and the hits.
+The hits keep the handle of the GameObject of the body, and are valid until the batch changes.
+
+	batch.clear();
+	size_t ray = batch.addRaycast(eye, forward, 50, QueryBatch::getLayerMask({ "Player", "Walls" }));
+	batch.execute();
+	if (batch.getHitCount(ray) > 0) target = batch.getHits(ray)[0].gameObject;
+*/
+class QueryBatch {
+public:
+	struct Hit {
+		GameObjectHandle gameObject;
+		//Position and normal of the hit, zero for overlaps
+		Vec3 position;
+		Vec3 normal;
+		//Distance along the ray or sweep, zero for overlaps
+		float distance;
+	};
+
+	/// <summary>
+	/// Layer mask of the queries that hit every layer
+	/// </summary>
+	static const uint32_t ALL_LAYERS = PxQueryBatch::ALL_LAYERS;
+
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	/// <param name="queryCapacity">: number of queries the memory is reserved for</param>
+	/// <param name="hitCapacity">: number of hits the memory is reserved for</param>
+	QueryBatch(size_t queryCapacity = 64, size_t hitCapacity = 64);
+
+	/// <summary>
+	/// Returns the mask of the collision layers with those names, the unknown names are logged and ignored.
+	/// The queries with an empty mask don't hit anything
+	/// </summary>
+	static uint32_t getLayerMask(const std::vector<std::string>& layers);
+
+	/// <summary>
+	/// Adds a ray from source in the directionVector a distance units
+	/// </summary>
+	/// <param name="layers">: mask of the layers the ray hits</param>
+	/// <param name="maxHits">: maximum number of hits, the closest ones are kept</param>
+	/// <param name="collidesWith">: the ray only collides with this types of colliders</param>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative, direction vector is all zeroes or maxHits is zero</exception>
+	size_t addRaycast(const Vector3& source, const Vector3& directionVector, float distance, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, RayCast::Type collidesWith = RayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a sphere that moves from center in the directionVector a distance units
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative, direction vector is all zeroes or maxHits is zero</exception>
+	size_t addSphereSweep(const Vector3& center, float radius, const Vector3& directionVector, float distance, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, RayCast::Type collidesWith = RayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a box that moves from center in the directionVector a distance units
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative, direction vector is all zeroes or maxHits is zero</exception>
+	size_t addBoxSweep(const Vector3& center, const Vector3& halfExtents, const Quat& orientation, const Vector3& directionVector, float distance,
+		uint32_t layers = ALL_LAYERS, unsigned int maxHits = 1, RayCast::Type collidesWith = RayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a capsule that moves from center in the directionVector a distance units. The axis of the capsule is its local X axis
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when distance is negative, direction vector is all zeroes or maxHits is zero</exception>
+	size_t addCapsuleSweep(const Vector3& center, float radius, float halfHeight, const Quat& orientation, const Vector3& directionVector, float distance,
+		uint32_t layers = ALL_LAYERS, unsigned int maxHits = 1, RayCast::Type collidesWith = RayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a query of the GameObjects that overlap a sphere
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when maxHits is zero</exception>
+	size_t addSphereOverlap(const Vector3& center, float radius, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, RayCast::Type collidesWith = RayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a query of the GameObjects that overlap a box
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when maxHits is zero</exception>
+	size_t addBoxOverlap(const Vector3& center, const Vector3& halfExtents, const Quat& orientation, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, RayCast::Type collidesWith = RayCast::Type::Both);
+
+	/// <summary>
+	/// Adds a query of the GameObjects that overlap a capsule. The axis of the capsule is its local X axis
+	/// </summary>
+	/// <returns>Index of the query</returns>
+	/// <exception cref="ERayCast">thrown when maxHits is zero</exception>
+	size_t addCapsuleOverlap(const Vector3& center, float radius, float halfHeight, const Quat& orientation, uint32_t layers = ALL_LAYERS,
+		unsigned int maxHits = 1, RayCast::Type collidesWith = RayCast::Type::Both);
+
+	/// <summary>
+	/// Runs every query in the workers of the JobSystem and waits for them
+	/// </summary>
+	void execute();
+
+	/// <summary>
+	/// Removes every query and its hits, keeping the memory
+	/// </summary>
+	void clear();
+
+	inline size_t size() const { return _batch.size(); }
+
+	/// <summary>
+	/// Returns the number of hits of the query in the last execution
+	/// </summary>
+	inline unsigned int getHitCount(size_t query) const { return _batch.getHitCount(query); }
+
+	/// <summary>
+	/// Returns the hits of the query in the last execution, sorted by distance. A query added after it has none
+	/// </summary>
+	inline const Hit* getHits(size_t query) const { return query < _firstHits.size() ? _hits.data() + _firstHits[query] : nullptr; }
+
+private:
+	PxQueryBatch _batch;
+	//Hits of the last execution with the handles of their GameObjects, packed one query after another
+	std::vector<Hit> _hits;
+	std::vector<size_t> _firstHits;
+};
+
+#endif // !QUERYBATCH_H
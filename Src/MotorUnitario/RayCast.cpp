@@ -1,13 +1,13 @@
 #include "RayCast.h"
 #include "MotorFisico/RayCast.h"
 #include "MotorFisico/Exceptions.h"
-#include "Engine.h"
+#include "GameObject.h"
 #include "Logger.h"
 
 RayCast::RayCast(const Vector3& source, const Vector3& directionVector, float distance, RayCast::Type collidesWith) : _raycast()
 {
 	try {
-		PxRayCast ray = PxRayCast(source.toTuple(), directionVector.toTuple(), distance, (PxRayCast::Type)collidesWith);
+		PxRayCast ray = PxRayCast(source.toVec3(), directionVector.toVec3(), distance, (PxRayCast::Type)collidesWith);
 		getInformation(ray);
 	}
 	catch (const ExcepcionTAD& e) {
@@ -21,7 +21,7 @@ RayCast::RayCast(const Vector3& source, const Vector3& target, RayCast::Type col
 		throw ERayCast("Raycast source position cannot be the same as target position");
 
 	try {
-		PxRayCast ray = PxRayCast(source.toTuple(), ((target - source).normalize()).toTuple(), (target - source).magnitude(), (PxRayCast::Type)collidesWith);
+		PxRayCast ray = PxRayCast(source.toVec3(), ((target - source).normalize()).toVec3(), (target - source).magnitude(), (PxRayCast::Type)collidesWith);
 		getInformation(ray);
 	}
 	catch (const ExcepcionTAD& e) {
@@ -31,12 +31,14 @@ RayCast::RayCast(const Vector3& source, const Vector3& target, RayCast::Type col
 
 void RayCast::getInformation(const PxRayCast& ray)
 {
-	PxRayCast::RayCastHit info = ray.getRayCastInformation();
+	const PxRayCast::RayCastHit& info = ray.getRayCastInformation();
 
 	_raycast.hit = info.hit;
 	if (_raycast.hit) {
 		_raycast.distance = info.distance;
 		_raycast.hitPosition = info.hitPosition;
-		_raycast.gameObjectHitted = Engine::getInstance()->findGameObject(info.actorName);
+		_raycast.gameObjectHitted = info.gameObject;
+		if (_raycast.gameObjectHitted != nullptr)
+			_raycast.gameObjectHandle = _raycast.gameObjectHitted->getHandle();
 	}
 }
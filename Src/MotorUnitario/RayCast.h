@@ -6,6 +6,7 @@ class GameObject;
 class PxRayCast;
 
 #include "Vector3.h"
+#include "GameObjectHandle.h"
 
 class RayCast {
 public:
@@ -19,6 +20,8 @@ public:
 	struct RayCastHit {
 		bool hit = false;
 		GameObject* gameObjectHitted = nullptr;
+		//Safe to keep after this frame, resolve it with Engine::getGameObject
+		GameObjectHandle gameObjectHandle;
 		Vector3 hitPosition = { 0, 0, 0 };
 		float distance = -1.0f;
 	};
@@ -6,9 +6,10 @@
 #include "MotorGrafico/RenderObject.h"
 #include "Exceptions.h"
 #include <algorithm>
+#include <memory>
 
 RenderObjectComponent::RenderObjectComponent() :Component(ComponentId::RenderObject, nullptr), _renderObject(nullptr),
-_transform(nullptr), _meshName("")
+_transform(nullptr), _syncedVersion(0), _interpolating(false), _meshName("")
 {
 }
 
@@ -19,10 +20,49 @@ RenderObjectComponent::~RenderObjectComponent()
 
 void RenderObjectComponent::awake(luabridge::LuaRef& data)
 {
+	std::unique_ptr<ComponentState> state(readState(data));
+	awakeFromState(*state);
+}
+
+ComponentState* RenderObjectComponent::readState(luabridge::LuaRef& data) const
+{
+	State* state = new State();
+
 	if (LUAFIELDEXIST(MeshName))
-		_meshName = GETLUASTRINGFIELD(MeshName);
-	else _meshName = "cube.mesh";
+		state->meshName = GETLUASTRINGFIELD(MeshName);
+
+	if (LUAFIELDEXIST(Material)) {
+		state->material = GETLUASTRINGFIELD(Material);
+	}
+	else {
+		Logger::getInstance()->log("Material doesn't exist: default material has been used", Logger::Level::WARN);
+	}
+
+	state->hasVisible = LUAFIELDEXIST(Visible);
+	if (state->hasVisible) state->visible = GETLUAFIELD(Visible, bool);
+
+	state->hasShadows = LUAFIELDEXIST(Shadows);
+	if (state->hasShadows) state->shadows = GETLUAFIELD(Shadows, bool);
 
+	state->hasRenderingDistance = LUAFIELDEXIST(RenderingDistance);
+	if (state->hasRenderingDistance) state->renderingDistance = GETLUAFIELD(RenderingDistance, float);
+
+	state->hasRotation = LUAFIELDEXIST(RotateAngle) && LUAFIELDEXIST(Rotate);
+	if (state->hasRotation)
+	{
+		state->rotateAngle = GETLUAFIELD(RotateAngle, float);
+		if (!data["Rotate"]["X"].isNil()) state->rotateX = data["Rotate"]["X"].cast<float>();
+		if (!data["Rotate"]["Y"].isNil()) state->rotateY = data["Rotate"]["Y"].cast<float>();
+		if (!data["Rotate"]["Z"].isNil()) state->rotateZ = data["Rotate"]["Z"].cast<float>();
+	}
+	return state;
+}
+
+void RenderObjectComponent::awakeFromState(const ComponentState& state)
+{
+	const State& values = static_cast<const State&>(state);
+
+	_meshName = values.meshName;
 	_renderObject = new RenderObject(_meshName, _gameObject->getName());
 	_renderObject->init();
 
@@ -33,33 +73,19 @@ void RenderObjectComponent::awake(luabridge::LuaRef& data)
 	float _maxSize = std::max({ size.getX(), size.getY(), size.getZ() });
 	_transform->setProportions(size / _maxSize);
 
-	std::string material = "Practica1/Red";
-	if (LUAFIELDEXIST(Material)) {
-		material = GETLUASTRINGFIELD(Material);
-	}
-	else {
-		Logger::getInstance()->log("Material doesn't exist: default material has been used", Logger::Level::WARN);
-	}
-	setMaterial(GETLUASTRINGFIELD(Material));
+	setMaterial(values.material);
 
-	if (LUAFIELDEXIST(Visible))
-		setVisible(GETLUAFIELD(Visible, bool));
+	if (values.hasVisible)
+		setVisible(values.visible);
 
-	if (LUAFIELDEXIST(Shadows))
-		setCastShadows(GETLUAFIELD(Shadows, bool));
-	float renderDist = 999;
-	if (LUAFIELDEXIST(RenderingDistance))
-		setRenderingDistance(GETLUAFIELD(RenderingDistance, float));
+	if (values.hasShadows)
+		setCastShadows(values.shadows);
 
-	if (LUAFIELDEXIST(RotateAngle) && LUAFIELDEXIST(Rotate))
-	{
-		float x, y, z;
-		x = y = z = 0;
-		if (!data["Rotate"]["X"].isNil()) x = data["Rotate"]["X"].cast<float>();
-		if (!data["Rotate"]["Y"].isNil()) y = data["Rotate"]["Y"].cast<float>();
-		if (!data["Rotate"]["Z"].isNil()) z = data["Rotate"]["Z"].cast<float>();
-		rotate(GETLUAFIELD(RotateAngle, float), x, y, z);
-	}
+	if (values.hasRenderingDistance)
+		setRenderingDistance(values.renderingDistance);
+
+	if (values.hasRotation)
+		rotate(values.rotateAngle, values.rotateX, values.rotateY, values.rotateZ);
 }
 
 void RenderObjectComponent::start()
@@ -72,20 +98,27 @@ void RenderObjectComponent::start()
 
 void RenderObjectComponent::update()
 {
-	float x = static_cast<float>(_transform->getPosition().getX());
-	float y = static_cast<float>(_transform->getPosition().getY());
-	float z = static_cast<float>(_transform->getPosition().getZ());
-	_renderObject->setPosition(x, y, z);
-
-	Vector3 dir = _transform->getRotation();
-	Quaternion q = _transform->ToQuaternion(dir.getX(), dir.getY(), dir.getZ());
-	_renderObject->setRotation(q.x, q.y, q.z, q.w);
+	//Setting the node invalidates the cached transforms of Ogre, so it's only done when the transform changes,
+	//or every frame while the pose is blended between two physics steps
+	bool interpolated = _transform->isInterpolated();
+	if (!interpolated && !_interpolating && _transform->getWorldVersion() == _syncedVersion) return;
+	_syncedVersion = _transform->getWorldVersion();
+	_interpolating = interpolated;
+
+	//The nodes are children of the root of the scene, so they take the world pose
+	if (interpolated) {
+		_renderObject->setPosition(_transform->getInterpolatedPosition());
+		_renderObject->setRotation(_transform->getInterpolatedOrientation());
+	}
+	else {
+		_renderObject->setPosition(_transform->getWorldMatrix().getTranslation());
+		_renderObject->setRotation(_transform->getWorldOrientation());
+	}
 
 	/*
 		start size: 50  200  50  -> scale 1 1 1 -> end size: 0.25  1  0.25
 	*/
-	Vector3 size = _transform->getSize();
-	_renderObject->setScale(size.getX(), size.getY(), size.getZ());
+	_renderObject->setScale(_transform->getWorldSize().toVec3());
 }
 
 void RenderObjectComponent::setMaterial(std::string const& materialName)
@@ -18,6 +18,10 @@ public:
 	/// Method to initialize required attributes for the component
 	/// </summary>
 	virtual void awake(luabridge::LuaRef& data) override;
+
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
 	/// <summary>
 	/// Initialize the component
 	/// </summary>
@@ -26,6 +30,11 @@ public:
 	/// Updates the position with Transform Component
 	/// </summary>
 	virtual void update() override;
+
+	/// <summary>
+	/// The component is only called in Update
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::mask(UpdatePhase::Update); }
 	/// <summary>
 	/// Set the object material
 	/// </summary>
@@ -93,6 +102,17 @@ public:
 
 protected:
 private:
+	struct State : public ComponentState {
+		std::string meshName = "cube.mesh";
+		std::string material = "Practica1/Red";
+		bool hasVisible = false, visible = true;
+		bool hasShadows = false, shadows = false;
+		bool hasRenderingDistance = false;
+		float renderingDistance = 0;
+		bool hasRotation = false;
+		float rotateAngle = 0, rotateX = 0, rotateY = 0, rotateZ = 0;
+	};
+
 	/// <summary>
 	/// Redefined by child classes called when component is enabled
 	/// </summary>
@@ -105,6 +125,10 @@ private:
 
 	RenderObject* _renderObject;
 	Transform* _transform;
+	//Version of the transform copied last time, see Transform::getWorldVersion
+	unsigned int _syncedVersion;
+	//The node was blended between two physics steps last frame
+	bool _interpolating;
 	std::string _meshName;
 };
 
@@ -1,13 +1,18 @@
 #include "RigidBodyComponent.h"
 #include "Transform.h"
 #include "MotorFisico/RigidBody.h"
+#include "MotorFisico/CollisionLayers.h"
+#include "MotorFisico/PhysxEngine.h"
+#include "MotorFisico/PhysicsCache.h"
 #include "GameObject.h"
 #include "ComponentIDs.h"
 #include "Logger.h"
 #include "Vector3.h"
+#include "Engine.h"
 #include "includeLUA.h"
 #include <MotorUnitario/KeyboardInput.h>
 #include <algorithm>
+#include <memory>
 
 RigidBodyComponent::RigidBodyComponent() : Component(ComponentId::Rigidbody, nullptr), _rb(nullptr), _tr(nullptr), _log(nullptr), _constrainRotation(false)
 {
@@ -21,60 +26,106 @@ RigidBodyComponent::~RigidBodyComponent()
 
 void RigidBodyComponent::awake(luabridge::LuaRef& data)
 {
-	bool isStatic = false;
-	Vector3 position = Vector3();
-	bool isKinematic = false;
-	float linearDamping = 0.99f;
-	float angularDamping = 0.99f;
-	float staticFriction = .5;
-	float dynamicFriction = .5;
-	float bounciness = .6;
-	float mass = 1;
+	std::unique_ptr<ComponentState> state(readState(data));
+	awakeFromState(*state);
+}
+
+ComponentState* RigidBodyComponent::readState(luabridge::LuaRef& data) const
+{
+	State* state = new State();
+
+	if (LUAFIELDEXIST(Type)) state->type = GETLUASTRINGFIELD(Type);
+	if (LUAFIELDEXIST(Diameter)) state->diameter = GETLUAFIELD(Diameter, float);
+	if (LUAFIELDEXIST(Radius)) state->radius = GETLUAFIELD(Radius, float);
+	if (LUAFIELDEXIST(Width)) state->width = GETLUAFIELD(Width, float);
+	if (LUAFIELDEXIST(Height)) state->height = GETLUAFIELD(Height, float);
+	if (LUAFIELDEXIST(Depth)) state->depth = GETLUAFIELD(Depth, float);
 
 	if (LUAFIELDEXIST(Mass))
-		mass = GETLUAFIELD(Mass, float);
+		state->mass = GETLUAFIELD(Mass, float);
 
 	if (LUAFIELDEXIST(Bounciness))
-		bounciness = GETLUAFIELD(Bounciness, float);
+		state->bounciness = GETLUAFIELD(Bounciness, float);
 
 	if (LUAFIELDEXIST(DynamicFriction))
-		dynamicFriction = GETLUAFIELD(DynamicFriction, float);
+		state->dynamicFriction = GETLUAFIELD(DynamicFriction, float);
 
 	if (LUAFIELDEXIST(StaticFriction))
-		staticFriction = GETLUAFIELD(StaticFriction, float);
+		state->staticFriction = GETLUAFIELD(StaticFriction, float);
 
 	if (LUAFIELDEXIST(AngularDamping))
-		angularDamping = GETLUAFIELD(AngularDamping, float);
+		state->angularDamping = GETLUAFIELD(AngularDamping, float);
 
 	if (LUAFIELDEXIST(LinearDamping))
-		linearDamping = GETLUAFIELD(LinearDamping, float);
+		state->linearDamping = GETLUAFIELD(LinearDamping, float);
 
 	if (LUAFIELDEXIST(Kinematic))
-		isKinematic = GETLUAFIELD(Kinematic, bool);
+		state->isKinematic = GETLUAFIELD(Kinematic, bool);
 
 	if (LUAFIELDEXIST(Static))
-		isStatic = GETLUAFIELD(Static, bool);
+		state->isStatic = GETLUAFIELD(Static, bool);
+
+	if (LUAFIELDEXIST(Material))
+		state->material = GETLUASTRINGFIELD(Material);
+
+	if (LUAFIELDEXIST(Layer))
+		state->layer = GETLUASTRINGFIELD(Layer);
+
+	state->constrainRotation = LUAFIELDEXIST(ConstrainAngle) && GETLUAFIELD(ConstrainAngle, bool);
+	return state;
+}
+
+void RigidBodyComponent::awakeFromState(const ComponentState& state)
+{
+	const State& values = static_cast<const State&>(state);
+
+	//The actor loaded from the physics collection of the level already has its shape, material and settings
+	physx::PxRigidActor* loaded = Engine::getInstance()->takeLoadedActor(_gameObject, getId());
+	if (loaded != nullptr) {
+		_rb = new RigidBody(loaded, _gameObject, gameObjectsCollision);
+		_constrainRotation = values.constrainRotation;
+		_tr = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
+		_rb->setPoseCallback(_constrainRotation ? physicsMovedPosition : physicsMoved, _tr);
+		return;
+	}
+
+	bool isStatic = values.isStatic;
+	bool isKinematic = values.isKinematic;
+	float linearDamping = values.linearDamping;
+	float angularDamping = values.angularDamping;
+	float staticFriction = values.staticFriction;
+	float dynamicFriction = values.dynamicFriction;
+	float bounciness = values.bounciness;
+	float mass = values.mass;
+
+	//A named material replaces the frictions and the bounciness
+	if (!values.material.empty()) {
+		const MaterialDesc* material = PhysxEngine::getPxInstance()->getCache()->findMaterial(values.material);
+		if (material == nullptr)
+			_log->log("There is no physics material " + values.material + ", " + _gameObject->getName() + " uses its own values", Logger::Level::WARN);
+		else {
+			staticFriction = material->staticFriction;
+			dynamicFriction = material->dynamicFriction;
+			bounciness = material->restitution;
+		}
+	}
 
 	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
-	std::tuple<float, float, float> pos = t->getPosition().toTuple();
-	std::tuple<float, float, float> rot = t->getRotation().toTuple();
+	Vec3 pos = t->getPosition().toVec3();
+	Quat orientation = t->getOrientation();
 	Vector3 scale = t->getSize();
 
-	if (LUAFIELDEXIST(Type)) { //Sphere
-		std::string t = GETLUASTRINGFIELD(Type);
+	if (!values.type.empty()) { //Sphere
+		const std::string& t = values.type;
 		if (t == "Sphere") {
-			float r = 1.0f;
-			if (LUAFIELDEXIST(Diameter)) r = GETLUAFIELD(Diameter, float);
+			float r = values.diameter;
 			r /= 2.0f;
 
 			_rb = new RigidBody(r, _gameObject, _gameObject->getName(), gameObjectsCollision, isStatic, pos, isKinematic, linearDamping,
 				angularDamping, staticFriction, dynamicFriction, bounciness, mass);
 		}
 		else if (t == "Box") { //Box
-			float w = 1.0f, h = 1.0f, d = 1.0f;
-			if (LUAFIELDEXIST(Width)) w = GETLUAFIELD(Width, float);
-			if (LUAFIELDEXIST(Height)) h = GETLUAFIELD(Height, float);
-			if (LUAFIELDEXIST(Depth)) d = GETLUAFIELD(Depth, float);
+			float w = values.width, h = values.height, d = values.depth;
 
 			w *= scale.getX();
 			h *= scale.getY();
@@ -84,9 +135,7 @@ void RigidBodyComponent::awake(luabridge::LuaRef& data)
 				angularDamping, staticFriction, dynamicFriction, bounciness, mass);
 		}
 		else if (t == "Capsule") { //Capsule
-			float r = 1.0f, h = 1.0f;
-			if (LUAFIELDEXIST(Radius)) r = GETLUAFIELD(Radius, float);
-			if (LUAFIELDEXIST(Height)) h = GETLUAFIELD(Height, float);
+			float r = values.radius, h = values.height;
 
 			r *= std::max({ scale.getX(), scale.getZ() });
 			r /= 2;
@@ -96,66 +145,105 @@ void RigidBodyComponent::awake(luabridge::LuaRef& data)
 			_rb = new RigidBody(r, h, _gameObject, _gameObject->getName(), gameObjectsCollision, isStatic, pos, isKinematic, linearDamping,
 				angularDamping, staticFriction, dynamicFriction, bounciness, mass);
 		}
-		_rb->setRotation(rot);
+		_rb->setOrientation(orientation);
 	}
 
-	if (LUAFIELDEXIST(ConstrainAngle) && GETLUAFIELD(ConstrainAngle, bool)) {
+	if (!values.layer.empty())
+		setLayer(values.layer);
+
+	if (values.constrainRotation) {
 		constrainX(true, false);
 		constrainY(true, false);
 		constrainZ(true, false);
 		_constrainRotation = true;
 	}
 
+	//The physics writes the pose straight to the Transform, and only for the bodies that moved
+	_tr = t;
+	_rb->setPoseCallback(_constrainRotation ? physicsMovedPosition : physicsMoved, _tr);
+
 }
 
-void RigidBodyComponent::onEnable()
+CollisionBody* RigidBodyComponent::getCollisionBody() const
 {
-	_rb->enable();
+	return _rb;
 }
 
-void RigidBodyComponent::onDisable()
+bool RigidBodyComponent::setLayer(const std::string& name)
 {
-	_rb->disable();
+	int layer = CollisionLayers::getInstance()->getLayer(name);
+	if (layer < 0) {
+		_log->log("There is no collision layer " + name + ", " + _gameObject->getName() + " stays in its layer", Logger::Level::WARN);
+		return false;
+	}
+	_rb->setLayer(layer);
+	return true;
 }
 
-void RigidBodyComponent::fixedUpdate()
+void RigidBodyComponent::reset()
 {
+	if (_rb->isStatic()) return;
 
+	setLinearVelocity(Vector3(0, 0, 0));
+	setAngularVelocity(Vector3(0, 0, 0));
 }
 
-void RigidBodyComponent::postFixedUpdate()
+void RigidBodyComponent::onEnable()
 {
-	if (_rb->isStatic()) return;
+	//A dormant body starts simulating when its GameObject wakes up
+	if (!_gameObject->isDormant())
+		_rb->enable();
+}
 
-	Vector3 position = _rb->getPosition();
-	Vector3 rotation = _rb->getRotation();
-	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
+void RigidBodyComponent::onDormant(bool dormant)
+{
+	//A disabled body stays out of the simulation
+	if (!getEnabled()) return;
+	if (dormant) _rb->suspend();
+	else _rb->resume();
+}
+
+void RigidBodyComponent::onDisable()
+{
+	_rb->disable();
+}
+
+void RigidBodyComponent::physicsMoved(void* transform, const Vec3& position, const Quat& orientation)
+{
+	static_cast<Transform*>(transform)->updateFromPhysics(position, orientation);
+}
 
-	if (!_constrainRotation)
-		t->updateFromPhysics(position, rotation);
-	else t->updateFromPhysics(position);
+void RigidBodyComponent::physicsMovedPosition(void* transform, const Vec3& position, const Quat& orientation)
+{
+	static_cast<Transform*>(transform)->updateFromPhysics(position);
 }
 
 void RigidBodyComponent::setPosition(Vector3 pos)
 {
-	_rb->setPosition(pos.toTuple());
+	_rb->setPosition(pos.toVec3());
 }
 
 void RigidBodyComponent::rotate(Vector3 rot)
 {
-	if (!_rb->rotate(rot.toTuple()))
+	if (!_rb->rotate(rot.toVec3()))
 		_log->log("trying to rotate a static rigidBody will result in nothig", Logger::Level::WARN);
 }
 
 void RigidBodyComponent::setRotation(Vector3 rot)
 {
-	if (!_rb->setRotation(rot.toTuple()))
+	if (!_rb->setRotation(rot.toVec3()))
+		_log->log("trying to rotate a static rigidBody will result in nothing", Logger::Level::WARN);
+}
+
+void RigidBodyComponent::setOrientation(const Quat& orientation)
+{
+	if (!_rb->setOrientation(orientation))
 		_log->log("trying to rotate a static rigidBody will result in nothing", Logger::Level::WARN);
 }
 
 void RigidBodyComponent::setScale(Vector3 scale)
 {
-	if (!_rb->setScale(scale.toTuple()))
+	if (!_rb->setScale(scale.toVec3()))
 		_log->log("trying to scale a static rigidBody will result in nothing", Logger::Level::WARN);
 }
 
@@ -185,13 +273,13 @@ void RigidBodyComponent::setMass(float m)
 
 void RigidBodyComponent::setLinearVelocity(const Vector3& vel)
 {
-	if (!_rb->setLinearVelocity(vel.toTuple()))
+	if (!_rb->setLinearVelocity(vel.toVec3()))
 		_log->log("trying to set the linear velocity of a static rigidBody will result in nothig", Logger::Level::WARN);
 }
 
 void RigidBodyComponent::setAngularVelocity(const Vector3& vel)
 {
-	if (!_rb->setAngularVelocity(vel.toTuple()))
+	if (!_rb->setAngularVelocity(vel.toVec3()))
 		_log->log("trying to set the angular velocity of a static rigidBody will result in nothig", Logger::Level::WARN);
 }
 
@@ -218,29 +306,25 @@ float RigidBodyComponent::getMass()
 
 void RigidBodyComponent::addForce(Vector3& force)
 {
-	auto tupleForce = force.toTuple();
-	if (!_rb->addForce(tupleForce))
+	if (!_rb->addForce(force.toVec3()))
 		_log->log("trying to move a static rigidBody will result in nothig", Logger::Level::WARN);
 }
 
 void RigidBodyComponent::addImpulse(Vector3& impulse)
 {
-	auto tupleImpulse = impulse.toTuple();
-	if (!_rb->addImpulse(tupleImpulse))
+	if (!_rb->addImpulse(impulse.toVec3()))
 		_log->log("trying to move a static rigidBody will result in nothig", Logger::Level::WARN);
 }
 
 void RigidBodyComponent::addTorque(Vector3& torque)
 {
-	auto tupleTorque = torque.toTuple();
-	if (!_rb->addTorque(tupleTorque))
+	if (!_rb->addTorque(torque.toVec3()))
 		_log->log("trying to rotate a static rigidBody will result in nothig", Logger::Level::WARN);
 }
 
 void RigidBodyComponent::moveTo(Vector3& dest)
 {
-	auto tupleDest = dest.toTuple();
-	if (!_rb->moveTo(tupleDest))
+	if (!_rb->moveTo(dest.toVec3()))
 		_log->log("trying to move a static/not kinematic rigidBody will result in nothig", Logger::Level::WARN);
 }
 
@@ -261,8 +345,11 @@ void RigidBodyComponent::constrainZ(bool constrain, bool linear)
 	if (!_rb->constrainZ(constrain, linear))
 		_log->log("trying to move a constrain rigidBody will result in nothig", Logger::Level::WARN);
 }
-void RigidBodyComponent::gameObjectsCollision(GameObject* thisGO, GameObject* otherGO)
+void RigidBodyComponent::gameObjectsCollision(GameObjectHandle thisGO, GameObjectHandle otherGO, const ContactEvent& event)
 {
-	thisGO->onCollision(otherGO);
-	otherGO->onCollision(thisGO);
+	Engine* engine = Engine::getInstance();
+	GameObject* go = engine->getGameObject(thisGO);
+	if (go != nullptr) go->onContact(otherGO, event);
+	go = engine->getGameObject(otherGO);
+	if (go != nullptr) go->onContact(thisGO, event);
 }
\ No newline at end of file
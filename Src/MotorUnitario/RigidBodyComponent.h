@@ -4,13 +4,16 @@
 
 #include "Component.h"
 #include "Vector3.h"
+#include "MotorMath/Quat.h"
 #include <string>
 
 class Logger;
 class RigidBody;
+class CollisionBody;
 class Vector3;
 class Transform;
 class GameObject;
+struct ContactEvent;
 
 class RigidBodyComponent :	public Component
 {
@@ -25,15 +28,30 @@ public:
 	virtual ~RigidBodyComponent();
 
 	void awake(luabridge::LuaRef& data) override;
+
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
+
+	/// <summary>
+	/// The component isn't called in any update phase
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::None; }
+
 	/// <summary>
-	/// Called each pshyical step to update physiscal information
+	/// Returns the body of the physics, used to save the collection of the level
 	/// </summary>
-	virtual void fixedUpdate() override;
+	CollisionBody* getCollisionBody() const;
 
 	/// <summary>
-	/// Called after every physic simulation (only sets the Transform)
+	/// Stops the body, the Transform takes it back to its initial pose
 	/// </summary>
-	virtual void postFixedUpdate() override;
+	virtual void reset() override;
+
+	/// <summary>
+	/// Suspends the body keeping its velocities, it moves again as it was when the GameObject wakes up
+	/// </summary>
+	void onDormant(bool dormant) override;
 
 	/// <summary>
 	/// Sets the position of the transform to a specified one
@@ -53,6 +71,18 @@ public:
 	/// <param name="axis">the axis to rotate</param>
 	void setRotation(Vector3 rot);
 
+	/// <summary>
+	/// Sets the orientation of the rigidbody to a specified one
+	/// </summary>
+	/// <param name="orientation">The new orientation, normalized</param>
+	void setOrientation(const Quat& orientation);
+
+	/// <summary>
+	/// Moves the rigidbody to the collision layer with that name, the layers are registered in CollisionLayers
+	/// </summary>
+	/// <returns>False if there is no such layer, then the layer doesn't change</returns>
+	bool setLayer(const std::string& name);
+
 	/// <summary>
 	/// Sets the scale of the transform to a specified one
 	/// </summary>
@@ -171,9 +201,32 @@ public:
 	/// </summary>
 	/// <param name="thisGO"></param>
 	/// <param name="otherGO"></param>
-	static void gameObjectsCollision(GameObject* thisGO, GameObject* otherGO);
+	static void gameObjectsCollision(GameObjectHandle thisGO, GameObjectHandle otherGO, const ContactEvent& event);
 
 private:
+	struct State : public ComponentState {
+		std::string type;
+		//Sizes of the shape, before the scale of the Transform
+		float diameter = 1.0f, radius = 1.0f, width = 1.0f, height = 1.0f, depth = 1.0f;
+		bool isStatic = false;
+		bool isKinematic = false;
+		float linearDamping = 0.99f;
+		float angularDamping = 0.99f;
+		float staticFriction = .5f;
+		float dynamicFriction = .5f;
+		float bounciness = .6f;
+		float mass = 1;
+		std::string material;
+		std::string layer;
+		bool constrainRotation = false;
+	};
+
+	/// <summary>
+	/// Pose callbacks of the body, called by the physics after every step in which the body moved
+	/// </summary>
+	/// <param name="transform">The Transform of the GameObject</param>
+	static void physicsMoved(void* transform, const Vec3& position, const Quat& orientation);
+	static void physicsMovedPosition(void* transform, const Vec3& position, const Quat& orientation);
 
 	void onEnable() override;
 
@@ -0,0 +1,125 @@
+#include "StaticGeometryComponent.h"
+#include "ColliderComponent.h"
+#include "MotorFisico/StaticGeometry.h"
+#include "MotorFisico/CollisionLayers.h"
+#include "MotorFisico/PhysxEngine.h"
+#include "MotorFisico/PhysicsCache.h"
+#include "GameObject.h"
+#include "ComponentIDs.h"
+#include "Transform.h"
+#include "Logger.h"
+#include "Engine.h"
+#include "includeLUA.h"
+
+StaticGeometryComponent::StaticGeometryComponent() : Component(ComponentId::StaticGeometry, nullptr), _geometry(nullptr)
+{
+}
+
+StaticGeometryComponent::~StaticGeometryComponent()
+{
+	delete _geometry; _geometry = nullptr;
+}
+
+void StaticGeometryComponent::awake(luabridge::LuaRef& data)
+{
+	//The actor loaded from the physics collection of the level already has every shape
+	physx::PxRigidActor* loaded = Engine::getInstance()->takeLoadedActor(_gameObject, getId());
+	if (loaded != nullptr) {
+		_geometry = new StaticGeometry(loaded, _gameObject, ColliderComponent::gameObjectsCollision);
+		return;
+	}
+
+	Transform* t = static_cast<Transform*>(_gameObject->getComponent(ComponentId::Transform));
+	_geometry = new StaticGeometry(_gameObject, _gameObject->getName(), ColliderComponent::gameObjectsCollision,
+		t->getPosition().toVec3(), t->getOrientation());
+
+	if (LUAFIELDEXIST(Shapes)) {
+		luabridge::LuaRef shapes = data["Shapes"];
+		for (int i = 1; i <= shapes.length(); ++i) {
+			luabridge::LuaRef shape = shapes[i];
+			addShape(shape);
+		}
+	}
+	if (_geometry->getShapeCount() == 0)
+		Logger::getInstance()->log("The static geometry of " + _gameObject->getName() + " has no shapes", Logger::Level::WARN);
+
+	_geometry->build();
+}
+
+CollisionBody* StaticGeometryComponent::getCollisionBody() const
+{
+	return _geometry;
+}
+
+unsigned int StaticGeometryComponent::getShapeCount() const
+{
+	return _geometry->getShapeCount();
+}
+
+void StaticGeometryComponent::addShape(luabridge::LuaRef& data)
+{
+	ShapeDesc::Type type = ShapeDesc::Box;
+	if (LUAFIELDEXIST(Type)) {
+		std::string name = GETLUASTRINGFIELD(Type);
+		if (name == "Sphere") type = ShapeDesc::Sphere;
+		else if (name == "Capsule") type = ShapeDesc::Capsule;
+		else if (name != "Box")
+			Logger::getInstance()->log("Unknown shape type " + name + " in the static geometry of " + _gameObject->getName() + ", a box is used", Logger::Level::WARN);
+	}
+
+	//The sizes are read like the ones of the colliders
+	float x = 0, y = 0, z = 0;
+	if (type == ShapeDesc::Box) {
+		x = (LUAFIELDEXIST(Width) ? GETLUAFIELD(Width, float) : 1) / 2;
+		y = (LUAFIELDEXIST(Height) ? GETLUAFIELD(Height, float) : 1) / 2;
+		z = (LUAFIELDEXIST(Depth) ? GETLUAFIELD(Depth, float) : 1) / 2;
+	}
+	else if (type == ShapeDesc::Sphere)
+		x = LUAFIELDEXIST(Radius) ? GETLUAFIELD(Radius, float) : 2;
+	else {
+		x = LUAFIELDEXIST(Radius) ? GETLUAFIELD(Radius, float) : 1;
+		y = (LUAFIELDEXIST(Length) ? GETLUAFIELD(Length, float) : 3) / 2;
+	}
+
+	Vec3 position;
+	if (LUAFIELDEXIST(Coord)) {
+		luabridge::LuaRef coord = data["Coord"];
+		position = Vec3(coord["X"].cast<float>(), coord["Y"].cast<float>(), coord["Z"].cast<float>());
+	}
+	Quat orientation;
+	if (LUAFIELDEXIST(Rotation)) {
+		luabridge::LuaRef rotation = data["Rotation"];
+		orientation = Quat::fromEuler((float)(rotation["X"].cast<double>() * PI / 180), (float)(rotation["Y"].cast<double>() * PI / 180),
+			(float)(rotation["Z"].cast<double>() * PI / 180));
+	}
+
+	float staticFriction = 0.5f;
+	if (LUAFIELDEXIST(StaticFriction)) staticFriction = GETLUAFIELD(StaticFriction, float);
+	float dynamicFriction = 0.5f;
+	if (LUAFIELDEXIST(DynamicFriction)) dynamicFriction = GETLUAFIELD(DynamicFriction, float);
+	float restitution = 0.5f;
+	if (LUAFIELDEXIST(Restitution)) restitution = GETLUAFIELD(Restitution, float);
+	if (LUAFIELDEXIST(Material)) {
+		std::string name = GETLUASTRINGFIELD(Material);
+		const MaterialDesc* material = PhysxEngine::getPxInstance()->getCache()->findMaterial(name);
+		if (material != nullptr) {
+			staticFriction = material->staticFriction;
+			dynamicFriction = material->dynamicFriction;
+			restitution = material->restitution;
+		}
+		else
+			Logger::getInstance()->log("There is no physics material " + name + ", a shape of " + _gameObject->getName() + " uses its own values", Logger::Level::WARN);
+	}
+
+	int layer = CollisionLayers::DEFAULT_LAYER;
+	if (LUAFIELDEXIST(Layer)) {
+		std::string name = GETLUASTRINGFIELD(Layer);
+		layer = CollisionLayers::getInstance()->getLayer(name);
+		if (layer < 0) {
+			Logger::getInstance()->log("There is no collision layer " + name + ", a shape of " + _gameObject->getName() + " uses the default one", Logger::Level::WARN);
+			layer = CollisionLayers::DEFAULT_LAYER;
+		}
+	}
+
+	_geometry->addShape(type, x, y, z, position, orientation, staticFriction, dynamicFriction, restitution, layer);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef STATICGEOMETRYCOMPONENT_H
+#define STATICGEOMETRYCOMPONENT_H
+
+#include "Component.h"
+
+class StaticGeometry;
+class CollisionBody;
+
+/*
+Scenery made of many shapes that never move, all of them in one static actor placed at the Transform.
+
+	StaticGeometry = {
+		Shapes = {
+			{ Type = "Box", Coord = { X = 0, Y = -1, Z = 0 }, Width = 100, Height = 2, Depth = 100, Material = "Wood" },
+			{ Type = "Sphere", Coord = { X = 10, Y = 2, Z = 0 }, Radius = 2, Layer = "Props" },
+			{ Type = "Capsule", Coord = { X = -10, Y = 2, Z = 0 }, Rotation = { X = 0, Y = 0, Z = 90 }, Radius = 1, Length = 4 }
+		}
+	}
+
+The Coord and Rotation of each shape are relative to the Transform, the rotation in degrees.
+*/
+class StaticGeometryComponent : public Component {
+public:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	StaticGeometryComponent();
+
+	/// <summary>
+	/// Destructor of the class
+	/// </summary>
+	virtual ~StaticGeometryComponent();
+
+	void awake(luabridge::LuaRef& data) override;
+
+	/// <summary>
+	/// The component isn't called in any update phase
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::None; }
+
+	/// <summary>
+	/// Returns the number of shapes of the geometry
+	/// </summary>
+	unsigned int getShapeCount() const;
+
+	/// <summary>
+	/// Returns the body of the physics, used to save the collection of the level
+	/// </summary>
+	CollisionBody* getCollisionBody() const;
+
+private:
+	/// <summary>
+	/// Adds the shape described by one of the entries of the Shapes list
+	/// </summary>
+	void addShape(luabridge::LuaRef& data);
+
+	StaticGeometry* _geometry;
+};
+
+#endif // !STATICGEOMETRYCOMPONENT_H
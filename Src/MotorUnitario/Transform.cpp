@@ -3,124 +3,355 @@
 #include "ComponentIDs.h"
 #include "RigidBodyComponent.h"
 #include "ColliderComponent.h"
+#include "TransformHierarchy.h"
+#include "Engine.h"
+#include "EngineTime.h"
+#include "Logger.h"
 #include "MotorGrafico/GraphicsEngine.h"
 #include "includeLUA.h"
 
 #include <math.h>
+#include <algorithm>
+#include <memory>
 #define PI 3.14159265
 
 
 Transform::Transform() : Component(ComponentId::Transform), 
-	_position(0, 0, 0), _rotation(0, 0, 0), _scale(1, 1, 1), _dir(0, 0, -1), _proportions(1, 1, 1)
+	_position(0, 0, 0), _orientation(), _scale(1, 1, 1), _dir(0, 0, -1), _proportions(1, 1, 1),
+	_initialPosition(0, 0, 0), _initialOrientation(), _initialScale(1, 1, 1), _version(1),
+	_parent(nullptr), _children(), _parentName(), _hierarchyIndex(-1), _worldVersion(0), _physicsWrite(false),
+	_previousPosition(), _previousOrientation(), _interpolationStep(0)
 {
+	TransformHierarchy::getInstance()->registerTransform(this);
 }
 
 void Transform::setPosition(const Vector3& position)
 {
 	_position = position;
+	_interpolationStep = 0;
+	markDirty();
+
+	//The world pose of a child is written to the physics by the TransformHierarchy
+	if (_parent != nullptr) return;
 
 	if (_gameObject->hasComponent(ComponentId::Rigidbody))			GETCOMPONENT(RigidBodyComponent, ComponentId::Rigidbody)->setPosition(_position);
 	if (_gameObject->hasComponent(ComponentId::BoxCollider))		GETCOMPONENT(BoxColliderComponent, ComponentId::BoxCollider)->setPosition(_position); 
 	if (_gameObject->hasComponent(ComponentId::SphereCollider))		GETCOMPONENT(SphereColliderComponent, ComponentId::SphereCollider)->setPosition(_position);
 	if (_gameObject->hasComponent(ComponentId::CapsuleCollider))	GETCOMPONENT(CapsuleColliderComponent, ComponentId::CapsuleCollider)->setPosition(_position);
+	if (_gameObject->hasComponent(ComponentId::MeshCollider))		GETCOMPONENT(MeshColliderComponent, ComponentId::MeshCollider)->setPosition(_position);
+	if (_gameObject->hasComponent(ComponentId::ConvexCollider))		GETCOMPONENT(ConvexColliderComponent, ComponentId::ConvexCollider)->setPosition(_position);
 }
 
 void Transform::updateFromPhysics(const Vector3& position)
 {
-	_position = position;
+	keepPreviousPose();
+	Vector3 local = position;
+	if (_parent != nullptr) {
+		Vector3 parentScale = _parent->getWorldScale();
+		Vector3 offset = _parent->getWorldOrientation().conjugate().rotate((position - _parent->getWorldPosition()).toVec3());
+		local = Vector3(offset.getX() / parentScale.getX(), offset.getY() / parentScale.getY(), offset.getZ() / parentScale.getZ());
+	}
+
+	//Sleeping bodies report the same pose every step
+	if (local == _position) return;
+	_position = local;
+	_physicsWrite = true;
+	markDirty();
 }
 
 void Transform::awake(luabridge::LuaRef& data)
 {
-	GraphicsEngine::getInstance()->addNode(_gameObject->getName());
+	std::unique_ptr<ComponentState> state(readState(data));
+	awakeFromState(*state);
+}
+
+ComponentState* Transform::readState(luabridge::LuaRef& data) const
+{
+	State* state = new State();
 
 	if (LUAFIELDEXIST(Coord)) {
 		luabridge::LuaRef lua_coord = data["Coord"];
-		_position = { lua_coord["X"].cast<double>(),lua_coord["Y"].cast<double>(), lua_coord["Z"].cast<double>() };
-		//std::cout << "Tr: X=" << _position.getX() << ", Y=" << _position.getY() << ", Z=" << _position.getZ() << std::endl;
+		state->position = { lua_coord["X"].cast<double>(),lua_coord["Y"].cast<double>(), lua_coord["Z"].cast<double>() };
 	}
 
 	if (LUAFIELDEXIST(Rotation)) {
 		luabridge::LuaRef lua_coord = data["Rotation"];
-		_rotation = { lua_coord["X"].cast<double>() * PI / 180, lua_coord["Y"].cast<double>() * PI / 180, lua_coord["Z"].cast<double>() * PI / 180 };
+		state->orientation = Quat::fromEuler((float)(lua_coord["X"].cast<double>() * PI / 180), (float)(lua_coord["Y"].cast<double>() * PI / 180), (float)(lua_coord["Z"].cast<double>() * PI / 180));
 	}
 
 	if (LUAFIELDEXIST(Scale)) {
 		luabridge::LuaRef lua_coord = data["Scale"];
-		_scale = { lua_coord["X"].cast<double>(),lua_coord["Y"].cast<double>(), lua_coord["Z"].cast<double>() };
+		state->scale = { lua_coord["X"].cast<double>(),lua_coord["Y"].cast<double>(), lua_coord["Z"].cast<double>() };
 	}
+
+	//The parent may be created after this GameObject, so it's looked up in start
+	if (LUAFIELDEXIST(Parent))
+		state->parent = GETLUASTRINGFIELD(Parent);
+
+	return state;
 }
 
-void Transform::updateFromPhysics(const Vector3& position, const Vector3& rotation)
+void Transform::awakeFromState(const ComponentState& state)
 {
-	_position = position;
-	_rotation = rotation;
+	const State& values = static_cast<const State&>(state);
+
+	if (GraphicsEngine::getInstance() != nullptr)
+		GraphicsEngine::getInstance()->addNode(_gameObject->getName());
+
+	_position = values.position;
+	_orientation = values.orientation;
+	_scale = values.scale;
+	_parentName = values.parent;
+
+	markDirty();
+	_initialPosition = _position;
+	_initialOrientation = _orientation;
+	_initialScale = _scale;
+}
+
+void Transform::start()
+{
+	if (_parentName.empty()) return;
+
+	Engine* engine = Engine::getInstance();
+	GameObject* parent = engine->getGameObject(engine->findGameObject(_parentName));
+	if (parent == nullptr || !parent->hasComponent(ComponentId::Transform) || !setParent(static_cast<Transform*>(parent->getComponent(ComponentId::Transform))))
+		Logger::getInstance()->log("The transform of " + _gameObject->getName() + " can't be attached to " + _parentName, Logger::Level::WARN);
+	_parentName.clear();
+}
+
+void Transform::reset()
+{
+	setPosition(_initialPosition);
+	setOrientation(_initialOrientation);
+	setScale(_initialScale);
 }
 
-void Transform::setRotation(const Vector3& rotation)
+void Transform::updateFromPhysics(const Vector3& position, const Quat& orientation)
 {
-	_rotation = rotation;
+	keepPreviousPose();
+	Quat localOrientation = orientation;
+	if (_parent != nullptr)
+		localOrientation = _parent->getWorldOrientation().conjugate() * orientation;
 
-	if (_gameObject->hasComponent(ComponentId::Rigidbody))			GETCOMPONENT(RigidBodyComponent, ComponentId::Rigidbody)->setRotation(_rotation);
-	if (_gameObject->hasComponent(ComponentId::BoxCollider))		GETCOMPONENT(BoxColliderComponent, ComponentId::BoxCollider)->setRotation(_rotation);
-	if (_gameObject->hasComponent(ComponentId::SphereCollider))		GETCOMPONENT(SphereColliderComponent, ComponentId::SphereCollider)->setRotation(_rotation);
-	if (_gameObject->hasComponent(ComponentId::CapsuleCollider))	GETCOMPONENT(CapsuleColliderComponent, ComponentId::CapsuleCollider)->setRotation(_rotation);
+	//Sleeping bodies report the same pose every step
+	if (localOrientation != _orientation) {
+		_orientation = localOrientation;
+		_physicsWrite = true;
+		markDirty();
+	}
+	updateFromPhysics(position);
 }
 
+void Transform::restore(const Vector3& position, const Quat& orientation, const Vector3& scale)
+{
+	_position = position;
+	_orientation = orientation;
+	_scale = scale;
+	_interpolationStep = 0;
+	_physicsWrite = true;
+	markDirty();
+}
 
-EulerAngles Transform::ToEulerAngles(Quaternion q)
+void Transform::setOrientation(const Quat& orientation)
 {
-	EulerAngles angles;
+	_orientation = orientation;
+	_interpolationStep = 0;
+	markDirty();
+
+	//The world pose of a child is written to the physics by the TransformHierarchy
+	if (_parent != nullptr) return;
 
-	// pitch (x-axis rotation)
-	double sinr_cosp = 2 * (q.w * q.x + q.y * q.z);
-	double cosr_cosp = 1 - 2 * (q.x * q.x + q.y * q.y);
-	angles.pitch = std::atan2(sinr_cosp, cosr_cosp);
+	if (_gameObject->hasComponent(ComponentId::Rigidbody))			GETCOMPONENT(RigidBodyComponent, ComponentId::Rigidbody)->setOrientation(_orientation);
+	if (_gameObject->hasComponent(ComponentId::BoxCollider))		GETCOMPONENT(BoxColliderComponent, ComponentId::BoxCollider)->setOrientation(_orientation);
+	if (_gameObject->hasComponent(ComponentId::SphereCollider))		GETCOMPONENT(SphereColliderComponent, ComponentId::SphereCollider)->setOrientation(_orientation);
+	if (_gameObject->hasComponent(ComponentId::CapsuleCollider))	GETCOMPONENT(CapsuleColliderComponent, ComponentId::CapsuleCollider)->setOrientation(_orientation);
+	if (_gameObject->hasComponent(ComponentId::MeshCollider))		GETCOMPONENT(MeshColliderComponent, ComponentId::MeshCollider)->setOrientation(_orientation);
+	if (_gameObject->hasComponent(ComponentId::ConvexCollider))		GETCOMPONENT(ConvexColliderComponent, ComponentId::ConvexCollider)->setOrientation(_orientation);
+}
 
-	// yaw (y-axis rotation)
-	double sinp = 2 * (q.w * q.y - q.z * q.x);
-	if (std::abs(sinp) >= 1)
-		angles.yaw = std::copysign(PI / 2, sinp); // use 90 degrees if out of range
-	else
-		angles.yaw = std::asin(sinp);
+void Transform::keepPreviousPose()
+{
+	uint64_t step = EngineTime::getInstance()->getFixedStepCount();
+	if (_interpolationStep == step) return;
+	_interpolationStep = step;
+	_previousPosition = _position.toVec3();
+	_previousOrientation = _orientation;
+}
 
-	// roll (z-axis rotation)
-	double siny_cosp = 2 * (q.w * q.z + q.x * q.y);
-	double cosy_cosp = 1 - 2 * (q.y * q.y + q.z * q.z);
-	angles.roll = std::atan2(siny_cosp, cosy_cosp);
+bool Transform::hasPreviousPose() const
+{
+	return _interpolationStep != 0 && _interpolationStep == EngineTime::getInstance()->getFixedStepCount();
+}
 
-	return angles;
+bool Transform::isInterpolated() const
+{
+	return hasPreviousPose() || (_parent != nullptr && _parent->isInterpolated());
 }
 
-Quaternion Transform::ToQuaternion(double pitch, double yaw, double roll)
+Vec3 Transform::getInterpolatedPosition() const
 {
-	// Abbreviations for the various angular functions
-	double cy = cos(pitch * 0.5);
-	double sy = sin(pitch * 0.5);
-	double cp = cos(yaw * 0.5);
-	double sp = sin(yaw * 0.5);
-	double cr = cos(roll * 0.5);
-	double sr = sin(roll * 0.5);
+	if (!isInterpolated()) return getWorldPosition().toVec3();
+
+	Vec3 local = _position.toVec3();
+	if (hasPreviousPose())
+		local = Vec3::lerp(_previousPosition, local, EngineTime::getInstance()->getInterpolationAlpha());
+	if (_parent == nullptr) return local;
 
-	Quaternion q;
-	q.w = cr * cp * cy + sr * sp * sy;
-	q.z = sr * cp * cy - cr * sp * sy;
-	q.y = cr * sp * cy + sr * cp * sy;
-	q.x = cr * cp * sy - sr * sp * cy;
+	//Same composition as the TransformHierarchy, with the blended pose of the parent
+	Vec3 scaled = _parent->getWorldScale().toVec3() * local;
+	return _parent->getInterpolatedPosition() + _parent->getInterpolatedOrientation().rotate(scaled);
+}
+
+Quat Transform::getInterpolatedOrientation() const
+{
+	if (!isInterpolated()) return getWorldOrientation();
 
-	return q;
+	Quat local = _orientation;
+	if (hasPreviousPose())
+		local = Quat::nlerp(_previousOrientation, local, EngineTime::getInstance()->getInterpolationAlpha());
+	if (_parent == nullptr) return local;
+	return _parent->getInterpolatedOrientation() * local;
 }
 
 Transform::~Transform()
 {
-	GraphicsEngine::getInstance()->removeNode(_gameObject->getName());
+	//The children keep their world pose
+	while (!_children.empty()) {
+		Transform* child = _children.back();
+		Vector3 position = child->getWorldPosition(), scale = child->getWorldScale();
+		Quat orientation = child->getWorldOrientation();
+		child->setParent(nullptr);
+		child->_position = position;
+		child->_orientation = orientation;
+		child->_scale = scale;
+		child->markDirty();
+	}
+	setParent(nullptr);
+	TransformHierarchy::getInstance()->unregisterTransform(this);
+
+	if (GraphicsEngine::getInstance() != nullptr)
+		GraphicsEngine::getInstance()->removeNode(_gameObject->getName());
 }
 
-Vector3 Transform::getForward() const
+bool Transform::setParent(Transform* parent)
 {
-	double X = sin(_rotation.getY() * PI / 180.0) * cos(_rotation.getX() * PI / 180.0);
-	double Y = sin(-_rotation.getX() * PI / 180.0);
-	double Z = cos(_rotation.getX() * PI / 180.0) * cos(_rotation.getY() * PI / 180.0);
+	if (parent == _parent) return true;
+
+	for (Transform* ancestor = parent; ancestor != nullptr; ancestor = ancestor->_parent)
+		if (ancestor == this) return false;
+
+	if (_parent != nullptr)
+		_parent->_children.erase(std::find(_parent->_children.begin(), _parent->_children.end(), this));
+	_parent = parent;
+	if (_parent != nullptr)
+		_parent->_children.push_back(this);
 
-	return Vector3(X, Y, -Z);
+	TransformHierarchy* hierarchy = TransformHierarchy::getInstance();
+	hierarchy->markStructureDirty();
+	hierarchy->clearWorld(_hierarchyIndex);
+	markDirty();
+	return true;
+}
+
+bool Transform::hasWorld() const
+{
+	TransformHierarchy* hierarchy = TransformHierarchy::getInstance();
+	for (const Transform* t = this; t != nullptr; t = t->_parent)
+		if (!hierarchy->hasWorld(t->_hierarchyIndex)) return false;
+	return true;
+}
+
+Vector3 Transform::getWorldPosition() const
+{
+	if (_parent == nullptr)
+		return _position;
+	if (!hasWorld()) {
+		//Same composition as the TransformHierarchy, until its next pass
+		Vec3 scaled = _parent->getWorldScale().toVec3() * _position.toVec3();
+		return _parent->getWorldPosition().toVec3() + _parent->getWorldOrientation().rotate(scaled);
+	}
+	return TransformHierarchy::getInstance()->getWorldMatrix(_hierarchyIndex).getTranslation();
+}
+
+Quat Transform::getWorldOrientation() const
+{
+	if (_parent == nullptr)
+		return _orientation;
+	if (!hasWorld())
+		return _parent->getWorldOrientation() * _orientation;
+	return TransformHierarchy::getInstance()->getWorldRotation(_hierarchyIndex);
+}
+
+Vector3 Transform::getWorldRotation() const
+{
+	return getWorldOrientation().toEuler();
+}
+
+Vector3 Transform::getWorldScale() const
+{
+	if (_parent == nullptr)
+		return _scale;
+	if (!hasWorld())
+		return _parent->getWorldScale().toVec3() * _scale.toVec3();
+	return TransformHierarchy::getInstance()->getWorldScale(_hierarchyIndex);
+}
+
+const Mat4& Transform::getWorldMatrix() const
+{
+	static const Mat4 identity = Mat4::identity();
+	TransformHierarchy* hierarchy = TransformHierarchy::getInstance();
+	if (!hierarchy->hasWorld(_hierarchyIndex))
+		return identity;
+	return hierarchy->getWorldMatrix(_hierarchyIndex);
+}
+
+void Transform::markDirty()
+{
+	++_version;
+	TransformHierarchy::getInstance()->markDirty(_hierarchyIndex);
+}
+
+void Transform::onWorldChanged(bool ancestorsMoved)
+{
+	++_worldVersion;
+
+	//The roots write their pose when it's set, and a body moved by the physics is already there
+	if (_parent != nullptr && (ancestorsMoved || !_physicsWrite))
+		syncPhysics(getWorldPosition(), getWorldOrientation());
+	_physicsWrite = false;
+}
+
+void Transform::syncPhysics(const Vector3& position, const Quat& orientation)
+{
+	if (_gameObject->hasComponent(ComponentId::Rigidbody)) {
+		GETCOMPONENT(RigidBodyComponent, ComponentId::Rigidbody)->setPosition(position);
+		GETCOMPONENT(RigidBodyComponent, ComponentId::Rigidbody)->setOrientation(orientation);
+	}
+	if (_gameObject->hasComponent(ComponentId::BoxCollider)) {
+		GETCOMPONENT(BoxColliderComponent, ComponentId::BoxCollider)->setPosition(position);
+		GETCOMPONENT(BoxColliderComponent, ComponentId::BoxCollider)->setOrientation(orientation);
+	}
+	if (_gameObject->hasComponent(ComponentId::SphereCollider)) {
+		GETCOMPONENT(SphereColliderComponent, ComponentId::SphereCollider)->setPosition(position);
+		GETCOMPONENT(SphereColliderComponent, ComponentId::SphereCollider)->setOrientation(orientation);
+	}
+	if (_gameObject->hasComponent(ComponentId::CapsuleCollider)) {
+		GETCOMPONENT(CapsuleColliderComponent, ComponentId::CapsuleCollider)->setPosition(position);
+		GETCOMPONENT(CapsuleColliderComponent, ComponentId::CapsuleCollider)->setOrientation(orientation);
+	}
+	if (_gameObject->hasComponent(ComponentId::MeshCollider)) {
+		GETCOMPONENT(MeshColliderComponent, ComponentId::MeshCollider)->setPosition(position);
+		GETCOMPONENT(MeshColliderComponent, ComponentId::MeshCollider)->setOrientation(orientation);
+	}
+	if (_gameObject->hasComponent(ComponentId::ConvexCollider)) {
+		GETCOMPONENT(ConvexColliderComponent, ComponentId::ConvexCollider)->setPosition(position);
+		GETCOMPONENT(ConvexColliderComponent, ComponentId::ConvexCollider)->setOrientation(orientation);
+	}
+}
+
+Vector3 Transform::getForward() const
+{
+	//-Z is the front of the objects when they aren't rotated
+	return _orientation.rotate(Vec3(0, 0, -1));
 }
\ No newline at end of file
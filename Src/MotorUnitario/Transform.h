@@ -4,18 +4,15 @@
 
 #include "Vector3.h"  
 #include "Component.h"
+#include "MotorMath/Mat4.h"
+#include "MotorMath/Quat.h"
 #include <cmath>
+#include <string>
+#include <vector>
+#include <cstdint>
 
 class GameObject;
 
-struct Quaternion {
-	double w, x, y, z;
-};
-
-struct EulerAngles {
-	double roll, pitch, yaw;
-};
-
 
 class Transform : public Component {
 public:
@@ -29,34 +26,70 @@ public:
 	/// </summary>
 	virtual void awake(luabridge::LuaRef& data) override;
 
+	ComponentState* readState(luabridge::LuaRef& data) const override;
+
+	void awakeFromState(const ComponentState& state) override;
+
+	/// <summary>
+	/// The component isn't called in any update phase
+	/// </summary>
+	inline unsigned int getUpdatePhases() const override { return UpdatePhase::None; }
+
+	/// <summary>
+	/// Attaches the transform to the GameObject named in the Parent field of Lua, if there is one
+	/// </summary>
+	virtual void start() override;
+
+	/// <summary>
+	/// Goes back to the position, rotation and scale read in awake
+	/// </summary>
+	virtual void reset() override;
+
 	/// <summary>
-	/// Returns the current position of the transform
+	/// Returns the current position of the transform, relative to its parent
 	/// </summary>
 	inline const Vector3& getPosition() const { return _position; }
 
 	/// <summary>
-	/// Sets a new transform position
+	/// Sets a new transform position, relative to its parent
 	/// </summary>
 	/// <param name="position">New position</param>
 	void setPosition(const Vector3& position);
 
 	/// <summary>
-	/// Called to update transform's position when object has a rigidbody
+	/// Called to update transform's position when object has a rigidbody, the position is in world space
 	/// </summary>
 	/// <param name="position">physx's rigidbody position</param>
 	void updateFromPhysics(const Vector3& position);
 
 	/// <summary>
-	/// Called to update transform's position and rotation when object has a rigidbody
+	/// Called to update transform's position and orientation when object has a rigidbody, both are in world space
 	/// </summary>
 	/// <param name="position">Physx's rigidbody position</param>
-	/// <param name="rotation">Physx's rigidbody rotation</param>
-	void updateFromPhysics(const Vector3& position, const Vector3& rotation);
+	/// <param name="orientation">Physx's rigidbody orientation</param>
+	void updateFromPhysics(const Vector3& position, const Quat& orientation);
 
 	/// <summary>
-	/// Returns the current rotation of the transform
+	/// Puts back the local values of a snapshot. The physics are not told, they are restored from their own snapshot
 	/// </summary>
-	inline const Vector3& getRotation() const { return _rotation; }
+	void restore(const Vector3& position, const Quat& orientation, const Vector3& scale);
+
+	/// <summary>
+	/// Returns the current orientation of the transform, relative to its parent
+	/// </summary>
+	inline const Quat& getOrientation() const { return _orientation; }
+
+	/// <summary>
+	/// Sets a new transform orientation, relative to its parent
+	/// </summary>
+	/// <param name="orientation">New orientation, normalized</param>
+	void setOrientation(const Quat& orientation);
+
+	/// <summary>
+	/// Returns the current rotation of the transform as Euler angles in radians, relative to its parent.
+	/// It's computed from the orientation
+	/// </summary>
+	inline Vector3 getRotation() const { return _orientation.toEuler(); }
 
 	/// <summary>
 	/// Returns the direccion where the object is looking at
@@ -64,13 +97,13 @@ public:
 	Vector3 getForward() const;
 
 	/// <summary>
-	/// Sets a new transform rotation
+	/// Sets a new transform rotation as Euler angles in radians, relative to its parent
 	/// </summary>
 	/// <param name="position">New rotation</param>
-	void setRotation(const Vector3& rotation);
+	inline void setRotation(const Vector3& rotation) { setOrientation(Quat::fromEuler(rotation.toVec3())); }
 
 	/// <summary>
-	/// Returns the current scale of the transform
+	/// Returns the current scale of the transform, relative to its parent
 	/// </summary>
 	inline Vector3 getScale() const { return _scale; }
 
@@ -79,6 +112,11 @@ public:
 	/// </summary>
 	inline Vector3 getSize() const { return _scale * _proportions; }
 
+	/// <summary>
+	/// Returns the size of the transform in world space, the proportions are not inherited
+	/// </summary>
+	inline Vector3 getWorldSize() const { return getWorldScale() * _proportions; }
+
 	/// <summary>
 	/// Returns the current scale of the transform
 	/// </summary>
@@ -88,32 +126,136 @@ public:
 	/// Sets a new transform scale
 	/// </summary>
 	/// <param name="position">New scale</param>
-	inline void setScale(const Vector3& scale) { _scale = scale; }
+	inline void setScale(const Vector3& scale) { _scale = scale; markDirty(); }
 
 	/// <summary>
-	/// Conversion to Euler by Quaternion
+	/// Setted by RenderObject to be in accordance to the mesh proportions
 	/// </summary>
-	/// <param name="position">New scale</param>
-	EulerAngles ToEulerAngles(Quaternion q);
+	/// <param name="proportions"></param>
+	inline void setProportions(const Vector3& proportions) { _proportions = proportions; markDirty(); }
 
 	/// <summary>
-	/// Conversion to Quaternion by Euler angle
+	/// Changes every time the local position, orientation, scale or proportions change
+	/// <para> The components that copy the transform keep the last version they synced and skip the copy while it's the same </para>
 	/// </summary>
-	/// <param name="position">New scale</param>
-	Quaternion ToQuaternion(double pitch, double yaw, double roll); // pitch (X), yaw (Y), roll (Z)
+	inline unsigned int getVersion() const { return _version; }
 
 	/// <summary>
-	/// Setted by RenderObject to be in accordance to the mesh proportions
+	/// Sets the parent of the transform, nullptr to make it a root. The local values are kept
 	/// </summary>
-	/// <param name="proportions"></param>
-	inline void setProportions(const Vector3& proportions) { _proportions = proportions; }
+	/// <returns>False if the parent is this transform or one of its descendants</returns>
+	bool setParent(Transform* parent);
+
+	inline Transform* getParent() const { return _parent; }
+
+	inline const std::vector<Transform*>& getChildren() const { return _children; }
+
+	/// <summary>
+	/// World values of the transform. For a root they are the local ones,
+	/// for a child they are the ones computed by the last pass of the TransformHierarchy, or composed with its parent
+	/// if it was added or reparented after that pass
+	/// </summary>
+	Vector3 getWorldPosition() const;
+	Quat getWorldOrientation() const;
+	Vector3 getWorldRotation() const;
+	Vector3 getWorldScale() const;
+
+	/// <summary>
+	/// World matrix computed by the last pass of the TransformHierarchy
+	/// </summary>
+	const Mat4& getWorldMatrix() const;
+
+	/// <summary>
+	/// Returns true if the pose of the transform comes from the last physics step, so the render can blend it with the pose
+	/// before that step. A child is also interpolated if its parent is, so it follows the blended pose of the parent
+	/// </summary>
+	bool isInterpolated() const;
+
+	/// <summary>
+	/// World pose between the one before the last physics step and the current one, by the interpolation alpha of EngineTime.
+	/// If the transform isn't interpolated they are the world pose. The local pose of a child is composed with the
+	/// interpolated pose of its parent
+	/// </summary>
+	Vec3 getInterpolatedPosition() const;
+	Quat getInterpolatedOrientation() const;
+
+	/// <summary>
+	/// Changes every time a pass of the TransformHierarchy changes the world values, because of this transform or of its ancestors
+	/// </summary>
+	inline unsigned int getWorldVersion() const { return _worldVersion; }
 
 private:
+	struct State : public ComponentState {
+		Vector3 position = Vector3(0, 0, 0);
+		Quat orientation;
+		Vector3 scale = Vector3(1, 1, 1);
+		std::string parent;
+	};
+
 	Vector3 _position;
-	Vector3 _rotation;
+	Quat _orientation;
 	Vector3 _scale;
 	Vector3 _proportions;
 	Vector3 _dir;
+
+	//Values read in awake, restored by reset
+	Vector3 _initialPosition;
+	Quat _initialOrientation;
+	Vector3 _initialScale;
+
+	//Starts at 1, so a consumer that has synced version 0 always syncs the first time
+	unsigned int _version;
+
+private:
+	friend class TransformHierarchy;
+
+	/// <summary>
+	/// Increments the version and tells the TransformHierarchy
+	/// </summary>
+	void markDirty();
+
+	/// <summary>
+	/// Called by the TransformHierarchy when the world values change
+	/// </summary>
+	/// <param name="ancestorsMoved">: true if the change comes from a parent</param>
+	void onWorldChanged(bool ancestorsMoved);
+
+	/// <summary>
+	/// Sets the position and orientation of the physic components
+	/// </summary>
+	void syncPhysics(const Vector3& position, const Quat& orientation);
+
+	Transform* _parent;
+	std::vector<Transform*> _children;
+	//Name of the parent GameObject read in awake, it's looked up in start
+	std::string _parentName;
+
+	//Position in the TransformHierarchy, -1 while it isn't registered. Its world values are valid after the next pass
+	int _hierarchyIndex;
+	unsigned int _worldVersion;
+	//The last change came from the physics, so it doesn't need to be written back
+	bool _physicsWrite;
+
+	/// <summary>
+	/// Keeps the pose before the physics step that is being written, once per step
+	/// </summary>
+	void keepPreviousPose();
+
+	/// <summary>
+	/// Returns true if the local pose of the transform was written by the last physics step
+	/// </summary>
+	bool hasPreviousPose() const;
+
+	/// <summary>
+	/// Returns true if a pass of the TransformHierarchy has computed this transform and its ancestors since they were added
+	/// or reparented. Otherwise the world values are composed with the ones of the parent
+	/// </summary>
+	bool hasWorld() const;
+
+	Vec3 _previousPosition;
+	Quat _previousOrientation;
+	//Physics step of the previous pose, 0 when the transform has been moved by other means since
+	uint64_t _interpolationStep;
 };
 
 
@@ -0,0 +1,163 @@
+#include "TransformHierarchy.h"
+#include "Transform.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::unique_ptr<TransformHierarchy> TransformHierarchy::instance = nullptr;
+
+TransformHierarchy::TransformHierarchy() : _transforms(), _parents(), _world(), _worldRotations(), _worldScales(),
+_dirty(), _computed(), _changed(), _dirtyCount(0), _holes(0), _structureDirty(false)
+{
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+}
+
+TransformHierarchy* TransformHierarchy::getInstance()
+{
+	if (instance.get() == nullptr) {
+		instance.reset(new TransformHierarchy());
+	}
+	return instance.get();
+}
+
+void TransformHierarchy::registerTransform(Transform* transform)
+{
+	//A new transform has no parent, and a root can go anywhere in the order
+	transform->_hierarchyIndex = (int)_transforms.size();
+	_transforms.push_back(transform);
+	_parents.push_back(-1);
+	_world.push_back(Mat4::identity());
+	_worldRotations.push_back(Quat());
+	_worldScales.push_back(Vec3(1, 1, 1));
+	_dirty.push_back(1);
+	_computed.push_back(0);
+	_changed.push_back(0);
+	++_dirtyCount;
+}
+
+void TransformHierarchy::unregisterTransform(Transform* transform)
+{
+	int index = transform->_hierarchyIndex;
+	if (index < 0) return;
+
+	//The hole is removed in a later rebuild, so the indices of the rest are still valid
+	_transforms[index] = nullptr;
+	if (_dirty[index]) --_dirtyCount;
+	_dirty[index] = 0;
+	transform->_hierarchyIndex = -1;
+	++_holes;
+}
+
+void TransformHierarchy::markDirty(int index)
+{
+	if (index < 0 || _dirty[index]) return;
+	_dirty[index] = 1;
+	++_dirtyCount;
+}
+
+void TransformHierarchy::markStructureDirty()
+{
+	_structureDirty = true;
+}
+
+void TransformHierarchy::clearWorld(int index)
+{
+	if (index >= 0) _computed[index] = 0;
+}
+
+void TransformHierarchy::update()
+{
+	if (_structureDirty || _holes > _transforms.size() / 4)
+		rebuild();
+	if (_dirtyCount == 0)
+		return;
+
+	size_t count = _transforms.size();
+	std::memset(_changed.data(), 0, count);
+
+	for (size_t i = 0; i < count; ++i) {
+		Transform* transform = _transforms[i];
+		int parent = _parents[i];
+		bool ancestorsMoved = parent >= 0 && _changed[parent];
+		if (transform == nullptr || (!_dirty[i] && !ancestorsMoved))
+			continue;
+
+		const Quat& q = transform->_orientation;
+		Vec3 scale = transform->_scale.toVec3();
+		Mat4 local = Mat4::fromTRS(transform->_position.toVec3(), q, scale);
+
+		if (parent < 0) {
+			_world[i] = local;
+			_worldRotations[i] = q;
+			_worldScales[i] = scale;
+		}
+		else {
+			Mat4::multiply(_world[parent], local, _world[i]);
+			_worldRotations[i] = _worldRotations[parent] * q;
+			_worldScales[i] = _worldScales[parent] * scale;
+		}
+
+		_dirty[i] = 0;
+		_computed[i] = 1;
+		_changed[i] = 1;
+		transform->onWorldChanged(ancestorsMoved);
+	}
+	_dirtyCount = 0;
+}
+
+void TransformHierarchy::rebuild()
+{
+	_structureDirty = false;
+	_holes = 0;
+
+	struct Entry { Transform* transform; int depth; int oldIndex; };
+	std::vector<Entry> entries;
+	entries.reserve(_transforms.size());
+	for (size_t i = 0; i < _transforms.size(); ++i) {
+		Transform* transform = _transforms[i];
+		if (transform == nullptr) continue;
+
+		int depth = 0;
+		for (Transform* t = transform->_parent; t != nullptr; t = t->_parent) ++depth;
+		entries.push_back({ transform, depth, (int)i });
+	}
+	//Stable, so the transforms at the same depth keep their order
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.depth < b.depth; });
+
+	size_t count = entries.size();
+	std::vector<Transform*> transforms(count);
+	std::vector<Mat4> world(count);
+	std::vector<Quat> worldRotations(count);
+	std::vector<Vec3> worldScales(count);
+	std::vector<unsigned char> dirty(count);
+	std::vector<unsigned char> computed(count);
+
+	_dirtyCount = 0;
+	for (size_t i = 0; i < count; ++i) {
+		const Entry& entry = entries[i];
+		transforms[i] = entry.transform;
+		world[i] = _world[entry.oldIndex];
+		worldRotations[i] = _worldRotations[entry.oldIndex];
+		worldScales[i] = _worldScales[entry.oldIndex];
+		dirty[i] = _dirty[entry.oldIndex];
+		computed[i] = _computed[entry.oldIndex];
+		if (dirty[i]) ++_dirtyCount;
+		entry.transform->_hierarchyIndex = (int)i;
+	}
+
+	_parents.assign(count, -1);
+	for (size_t i = 0; i < count; ++i)
+		if (transforms[i]->_parent != nullptr)
+			_parents[i] = transforms[i]->_parent->_hierarchyIndex;
+
+	_transforms.swap(transforms);
+	_world.swap(world);
+	_worldRotations.swap(worldRotations);
+	_worldScales.swap(worldScales);
+	_dirty.swap(dirty);
+	_computed.swap(computed);
+	_changed.assign(count, 0);
+}
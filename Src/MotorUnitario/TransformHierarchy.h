@@ -0,0 +1,109 @@
+#pragma once
+#ifndef TRANSFORMHIERARCHY_H
+#define TRANSFORMHIERARCHY_H
+
+#include <memory>
+#include <vector>
+
+#include "MotorMath/Mat4.h"
+#include "MotorMath/Quat.h"
+#include "MotorMath/Vec3.h"
+
+class Transform;
+
+/*
+World transforms of every Transform. They are kept in contiguous arrays sorted by depth, so the parent of
+each transform is always before it and the world matrices are computed in a single pass.
+
+Only the transforms marked dirty since the last pass and their descendants are recomputed.
+*/
+
+class TransformHierarchy
+{
+public:
+	~TransformHierarchy();
+
+	/// <summary>
+	/// Returns the instance of TransformHierarchy, in case there is no such instance, it creates one and returns that one
+	/// </summary>
+	static TransformHierarchy* getInstance();
+	TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+	TransformHierarchy(TransformHierarchy& other) = delete;
+
+	/// <summary>
+	/// Adds a transform, it gets its index now and its world values in the next pass
+	/// </summary>
+	void registerTransform(Transform* transform);
+
+	/// <summary>
+	/// Removes a transform, its index stops being valid
+	/// </summary>
+	void unregisterTransform(Transform* transform);
+
+	/// <summary>
+	/// Marks the local values of the transform with that index as changed
+	/// </summary>
+	void markDirty(int index);
+
+	/// <summary>
+	/// The parents have changed, the order is rebuilt in the next pass
+	/// </summary>
+	void markStructureDirty();
+
+	/// <summary>
+	/// The world values of the transform with that index stop being valid until the next pass, used when its parent changes
+	/// </summary>
+	void clearWorld(int index);
+
+	/// <summary>
+	/// Computes the world transforms that changed, and notifies their Transforms. Called once per frame by the Engine
+	/// </summary>
+	void update();
+
+	/// <summary>
+	/// World values of a transform, as of the last pass
+	/// </summary>
+	inline const Mat4& getWorldMatrix(int index) const { return _world[index]; }
+	inline const Quat& getWorldRotation(int index) const { return _worldRotations[index]; }
+	inline const Vec3& getWorldScale(int index) const { return _worldScales[index]; }
+
+	/// <summary>
+	/// Returns true if the transform with that index has been computed in a pass since it was added or its parent changed.
+	/// The world values of its ancestors may still be missing
+	/// </summary>
+	inline bool hasWorld(int index) const { return index >= 0 && (size_t)index < _computed.size() && _computed[index]; }
+
+	inline size_t getCount() const { return _transforms.size(); }
+
+private:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	TransformHierarchy();
+
+	/// <summary>
+	/// Sorts the transforms by depth and gives them their indices, they keep their world values and dirty flags
+	/// </summary>
+	void rebuild();
+
+	static std::unique_ptr<TransformHierarchy> instance;
+
+	//Sorted by depth, the removed ones are nullptr until the next rebuild
+	std::vector<Transform*> _transforms;
+	//Index of the parent of each transform, -1 for the roots
+	std::vector<int> _parents;
+	std::vector<Mat4> _world;
+	std::vector<Quat> _worldRotations;
+	std::vector<Vec3> _worldScales;
+	std::vector<unsigned char> _dirty;
+	//World values computed by a pass since the transform was added or its parent changed
+	std::vector<unsigned char> _computed;
+	//World transforms recomputed in the current pass, so the children are recomputed too
+	std::vector<unsigned char> _changed;
+	size_t _dirtyCount;
+	//Transforms removed since the last rebuild
+	size_t _holes;
+	bool _structureDirty;
+};
+
+#endif // !TRANSFORMHIERARCHY_H
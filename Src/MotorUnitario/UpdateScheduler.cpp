@@ -0,0 +1,167 @@
+#include "UpdateScheduler.h"
+#include "Component.h"
+#include "GameObject.h"
+#include "Exceptions.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#ifdef MOTOR_PROFILE
+#include <typeinfo>
+#endif
+
+//Minimum number of components of each job when a phase runs in parallel
+#define _PARALLEL_GRAIN_ 64
+
+std::unique_ptr<UpdateScheduler> UpdateScheduler::instance = nullptr;
+
+namespace {
+	const char* phaseNames[UpdatePhase::__Count__] = { "FixedUpdate", "PostFixedUpdate", "Update", "LateUpdate" };
+
+	void callPhase(Component* component, UpdatePhase::UpdatePhase phase)
+	{
+		switch (phase) {
+		case UpdatePhase::FixedUpdate: component->fixedUpdate(); break;
+		case UpdatePhase::PostFixedUpdate: component->postFixedUpdate(); break;
+		case UpdatePhase::Update: component->update(); break;
+		case UpdatePhase::LateUpdate: component->lateUpdate(); break;
+		default: break;
+		}
+	}
+}
+
+UpdateScheduler::UpdateScheduler() : _buckets()
+{
+	for (auto& phase : _buckets)
+		phase.resize(ComponentId::__StartPointUser__);
+}
+
+UpdateScheduler::~UpdateScheduler()
+{
+}
+
+UpdateScheduler* UpdateScheduler::getInstance()
+{
+	if (instance.get() == nullptr) {
+		instance.reset(new UpdateScheduler());
+	}
+	return instance.get();
+}
+
+void UpdateScheduler::registerComponent(Component* component)
+{
+	unsigned int id = component->getId();
+	unsigned int phases = component->getUpdatePhases();
+
+	for (unsigned int phase = 0; phase < UpdatePhase::__Count__; ++phase) {
+		if (component->_phaseSlots[phase] >= 0 || !(phases & UpdatePhase::mask((UpdatePhase::UpdatePhase)phase)))
+			continue;
+
+		std::vector<Bucket>& buckets = _buckets[phase];
+		if (id >= buckets.size())
+			buckets.resize(id + 1);
+
+		std::vector<Component*>& components = buckets[id].components;
+		buckets[id].parallel = component->isParallelSafe((UpdatePhase::UpdatePhase)phase);
+#ifdef MOTOR_PROFILE
+		if (buckets[id].profileName < 0)
+			buckets[id].profileName = Profiler::getInstance()->internName(std::string(phaseNames[phase]) + " " + typeid(*component).name());
+#endif
+		component->_phaseSlots[phase] = (int)components.size();
+		components.push_back(component);
+	}
+}
+
+void UpdateScheduler::unregisterComponent(Component* component)
+{
+	for (unsigned int phase = 0; phase < UpdatePhase::__Count__; ++phase)
+		unregisterFromPhase(component, (UpdatePhase::UpdatePhase)phase);
+}
+
+void UpdateScheduler::run(UpdatePhase::UpdatePhase phase)
+{
+	std::vector<Bucket>& buckets = _buckets[phase];
+	JobSystem* jobSystem = JobSystem::getInstance();
+	bool canRunParallel = jobSystem != nullptr && jobSystem->getWorkerCount() > 0;
+
+	//New components may be added while running, so sizes are read every iteration
+	for (size_t id = 0; id < buckets.size(); ++id) {
+#ifdef MOTOR_PROFILE
+		if (buckets[id].components.empty()) continue;
+		PROFILE_SCOPE_ID(buckets[id].profileName);
+#endif
+		if (canRunParallel && buckets[id].parallel && buckets[id].components.size() > _PARALLEL_GRAIN_) {
+			runParallel(buckets[id], phase);
+			continue;
+		}
+
+		for (size_t i = 0; i < buckets[id].components.size(); ++i) {
+			Component* comp = buckets[id].components[i];
+			if (comp == nullptr || !comp->getEnabled() || comp->getGameObject() == nullptr || !comp->getGameObject()->getEnabled())
+				continue;
+
+			try {
+				callPhase(comp, phase);
+			}
+			catch (...) {
+				throw ExcepcionTAD(std::string("Error in ") + phaseNames[phase] + " at gameObject " + comp->getGameObject()->getName());
+			}
+		}
+	}
+
+	for (auto& bucket : buckets)
+		if (bucket.dirty) compact(bucket, phase);
+}
+
+void UpdateScheduler::runParallel(Bucket& bucket, UpdatePhase::UpdatePhase phase)
+{
+	std::vector<Component*>& components = bucket.components;
+
+	JobSystem::getInstance()->parallelFor(components.size(), _PARALLEL_GRAIN_, [&components, phase](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			Component* comp = components[i];
+			if (comp == nullptr || !comp->getEnabled() || comp->getGameObject() == nullptr || !comp->getGameObject()->getEnabled())
+				continue;
+
+			try {
+				callPhase(comp, phase);
+			}
+			catch (...) {
+				throw ExcepcionTAD(std::string("Error in ") + phaseNames[phase] + " at gameObject " + comp->getGameObject()->getName());
+			}
+		}
+	});
+}
+
+size_t UpdateScheduler::getRegisteredCount(UpdatePhase::UpdatePhase phase) const
+{
+	size_t count = 0;
+	for (auto& bucket : _buckets[phase])
+		for (Component* c : bucket.components)
+			if (c != nullptr) ++count;
+	return count;
+}
+
+void UpdateScheduler::unregisterFromPhase(Component* component, UpdatePhase::UpdatePhase phase)
+{
+	int slot = component->_phaseSlots[phase];
+	if (slot < 0) return;
+
+	Bucket& bucket = _buckets[phase][component->getId()];
+	bucket.components[slot] = nullptr;
+	bucket.dirty = true;
+	component->_phaseSlots[phase] = -1;
+}
+
+void UpdateScheduler::compact(Bucket& bucket, UpdatePhase::UpdatePhase phase)
+{
+	size_t last = 0;
+	for (size_t i = 0; i < bucket.components.size(); ++i) {
+		Component* comp = bucket.components[i];
+		if (comp == nullptr) continue;
+
+		comp->_phaseSlots[phase] = (int)last;
+		bucket.components[last++] = comp;
+	}
+	bucket.components.resize(last);
+	bucket.dirty = false;
+}
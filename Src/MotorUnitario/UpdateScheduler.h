@@ -0,0 +1,111 @@
+#pragma once
+#ifndef UPDATESCHEDULER_H
+#define UPDATESCHEDULER_H
+
+#include <vector>
+#include <memory>
+
+class Component;
+
+namespace UpdatePhase {
+	enum UpdatePhase : unsigned int {
+		FixedUpdate = 0,
+		PostFixedUpdate,
+		Update,
+		LateUpdate,
+
+		__Count__
+	};
+
+	/// <summary>
+	/// Returns the bit of the phase in the masks of Component::getUpdatePhases
+	/// </summary>
+	inline unsigned int mask(UpdatePhase phase) { return 1u << phase; }
+
+	const unsigned int None = 0;
+	const unsigned int All = (1u << __Count__) - 1;
+}
+
+/*
+Keeps one contiguous array of components per ComponentId and per phase, and runs every
+phase in ComponentId order (every Transform, then every ImageRender... and the user components last).
+
+Components are registered when added to a GameObject in the phases of their Component::getUpdatePhases,
+so the types that declare the phases they override are only visited in those ones each frame.
+
+When a type of component is parallel safe in a phase, its array is split between the workers of the JobSystem.
+*/
+class UpdateScheduler
+{
+public:
+	~UpdateScheduler();
+
+	/// <summary>
+	/// Returns the instance of UpdateScheduler, in case there is no such instance, it creates one and returns that one
+	/// </summary>
+	static UpdateScheduler* getInstance();
+	UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+	UpdateScheduler(UpdateScheduler& other) = delete;
+
+	/// <summary>
+	/// Registers the component in the update phases it overrides
+	/// </summary>
+	/// <param name="component">: component to register, it must have a GameObject</param>
+	void registerComponent(Component* component);
+
+	/// <summary>
+	/// Removes the component from every phase it was registered in
+	/// </summary>
+	/// <param name="component">: component to remove</param>
+	void unregisterComponent(Component* component);
+
+	/// <summary>
+	/// Calls the method of the phase of every enabled component, in ComponentId order
+	/// </summary>
+	/// <param name="phase">: phase to run</param>
+	/// <exception cref="ExcepcionTAD">Thrown when a component fails, with the name of its GameObject</exception>
+	void run(UpdatePhase::UpdatePhase phase);
+
+	/// <summary>
+	/// Returns the number of components visited by the phase
+	/// </summary>
+	size_t getRegisteredCount(UpdatePhase::UpdatePhase phase) const;
+
+private:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	UpdateScheduler();
+
+	struct Bucket {
+		std::vector<Component*> components;
+		bool dirty = false;
+		bool parallel = false;
+#ifdef MOTOR_PROFILE
+		// Zone of the profiler, named after the phase and the type of the components
+		int profileName = -1;
+#endif
+	};
+
+	/// <summary>
+	/// Calls the phase of the components of the bucket using the JobSystem
+	/// </summary>
+	void runParallel(Bucket& bucket, UpdatePhase::UpdatePhase phase);
+
+	/// <summary>
+	/// Removes the component from one phase leaving a hole that will be removed by compact
+	/// </summary>
+	void unregisterFromPhase(Component* component, UpdatePhase::UpdatePhase phase);
+
+	/// <summary>
+	/// Removes the holes of the bucket keeping the order of the components
+	/// </summary>
+	void compact(Bucket& bucket, UpdatePhase::UpdatePhase phase);
+
+	static std::unique_ptr<UpdateScheduler> instance;
+
+	// One bucket per ComponentId for each phase
+	std::vector<Bucket> _buckets[UpdatePhase::__Count__];
+};
+
+#endif // !UPDATESCHEDULER_H
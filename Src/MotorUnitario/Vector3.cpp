@@ -16,6 +16,10 @@ Vector3::Vector3(const std::tuple<float, float, float>& tuple): _x(std::get<0>(t
 {
 }
 
+Vector3::Vector3(const Vec3& v) : _x(v.x), _y(v.y), _z(v.z)
+{
+}
+
 Vector3::~Vector3()
 {
 }
@@ -5,6 +5,7 @@
 #include <math.h>
 #include <tuple>
 #include <cmath>
+#include "MotorMath/Vec3.h"
 
 #define PI 3.14159265 
 
@@ -15,6 +16,7 @@ public:
 	Vector3(const Vector3& v);
 	Vector3(double x, double y, double z);
 	Vector3(const std::tuple<float, float, float>& tuple);
+	Vector3(const Vec3& v);
 
 	~Vector3();
 		
@@ -81,6 +83,11 @@ public:
 	/// <returns></returns>
 	inline std::tuple<float, float, float> toTuple() const { return { _x, _y, _z }; }
 
+	/// <summary>
+	/// Returns the vector in the float format shared with the physics and graphics engines
+	/// </summary>
+	inline Vec3 toVec3() const { return Vec3((float)_x, (float)_y, (float)_z); }
+
 	/// <summary>
 	/// Returns the inverse vector
 	/// </summary>
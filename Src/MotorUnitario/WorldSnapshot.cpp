@@ -0,0 +1,6 @@
+#include "WorldSnapshot.h"
+
+WorldSnapshot::WorldSnapshot(size_t capacity) : _transforms(), _physics(capacity)
+{
+	_transforms.reserve(capacity);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef WORLDSNAPSHOT_H
+#define WORLDSNAPSHOT_H
+
+#include "MotorFisico/PhysicsSnapshot.h"
+#include "GameObjectHandle.h"
+#include "Vector3.h"
+#include <vector>
+
+/*
+State of the scene at one physic step: the transforms of the GameObjects and the dynamic bodies of the physics.
+Taken by Engine::captureSnapshot and put back by Engine::restoreSnapshot or Engine::resimulate, for rollback netcode:
+
+	snapshots[step % HISTORY].clear();
+	Engine::getInstance()->captureSnapshot(snapshots[step % HISTORY]);
+	...
+	//A late input of the step "from" arrived
+	Engine::getInstance()->resimulate(snapshots[from % HISTORY], step - from, [&](unsigned int i) { applyInputs(from + i); });
+
+The memory is reserved once, capturing doesn't allocate while the scene fits. The GameObjects created after
+the capture keep their state and the destroyed ones are ignored. The state of the other components is not kept
+*/
+class WorldSnapshot
+{
+public:
+	/// <summary>
+	/// Contructor of the class
+	/// </summary>
+	/// <param name="capacity">Number of GameObjects and bodies the memory is reserved for</param>
+	WorldSnapshot(size_t capacity = 256);
+
+	/// <summary>
+	/// Number of transforms in the snapshot
+	/// </summary>
+	inline size_t size() const { return _transforms.size(); }
+
+	/// <summary>
+	/// Removes the states, keeping the memory
+	/// </summary>
+	inline void clear() { _transforms.clear(); _physics.clear(); }
+
+private:
+	friend class Engine;
+
+	struct TransformState {
+		GameObjectHandle handle;
+		Vector3 position;
+		Quat orientation;
+		Vector3 scale;
+	};
+
+	std::vector<TransformState> _transforms;
+	PhysicsSnapshot _physics;
+};
+
+#endif // !WORLDSNAPSHOT_H
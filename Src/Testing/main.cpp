@@ -12,7 +12,8 @@ WinMain(HINSTANCE zhInstance, HINSTANCE prevInstance, LPSTR lpCmdLine, int nCmdS
 
 	Engine::CreateInstance();
 	Engine* prueba = Engine::getInstance();
-	prueba->init("Assets/prueba.cfg", "Assets/Levels");
+	//The collision layers of physicsConfig.lua are set before the first scene is loaded
+	prueba->init("Assets/prueba.cfg", "Assets/Levels", EngineMode::Default, "physicsConfig.lua");
 	prueba->changeScene("pruebaPhysx.lua");
 	prueba->run();
 
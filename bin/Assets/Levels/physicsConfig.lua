@@ -0,0 +1,35 @@
+-- Settings of the physics scene, they are read with Engine::init(resources, scenes, mode, "physicsConfig.lua")
+-- or Engine::loadPhysicsConfig("physicsConfig.lua"), which applies them in the next scene change
+-- Every field is optional, the missing ones keep their value:
+--  Gravity = { X = 0, Y = -9.81, Z = 0 }
+--  BroadPhase = "SAP", "MBP" or "ABP". MBP needs the bounds of the world, divided in Subdivisions x Subdivisions regions:
+--   WorldBounds = { Min = { X = -500, Y = -500, Z = -500 }, Max = { X = 500, Y = 500, Z = 500 } }, Subdivisions = 4
+--  PCM = true/false: persistent contact manifolds
+--  Solver = "PGS" or "TGS", PositionIterations = 4, VelocityIterations = 1: iterations of every dynamic body
+--  EnhancedDeterminism = true/false, CCD = true/false, Stabilization = true/false
+--   EnhancedDeterminism must be true for the rollback of Engine::resimulate to repeat the original steps
+--  Threads = 0 to run the simulation in the workers of the JobSystem, or the number of threads of its own it uses
+--  Layers = { "Player", "Enemy" }: collision layers besides "Default", the bodies choose theirs with their Layer field
+--   By default every pair of layers collides and reports its contacts when they start and end, the lists of pairs change it:
+--   IgnoredCollisions = { { "Enemy", "Enemy" } }: they don't collide, nor report
+--   IgnoredNotifications = { { "Player", "Default" } }: they collide without reporting
+--   PersistentNotifications = { { "Player", "Enemy" } }: they also report every step while they keep touching
+--   ContactPoints = { { "Player", "Enemy" } }: the reports have the contact points
+
+PhysicsConfig = {
+	Gravity = { X = 0, Y = -9.81, Z = 0 },
+	BroadPhase = "ABP",
+	PCM = true,
+	Solver = "PGS",
+	PositionIterations = 4,
+	VelocityIterations = 1,
+	EnhancedDeterminism = false,
+	CCD = false,
+	Stabilization = false,
+	Threads = 0,
+	Layers = {},
+	IgnoredCollisions = {},
+	IgnoredNotifications = {},
+	PersistentNotifications = {},
+	ContactPoints = {}
+}
@@ -0,0 +1,13 @@
+-- How to define physics materials, they are loaded with Engine::loadPhysicsMaterials("physicsMaterials.lua")
+-- HowManyMaterials must contain one more number than the last material_X declared, like HowManyGameObjects in the scenes
+-- Each material_X has its name and its values:
+--  material_Number = { Name = "", StaticFriction = X, DynamicFriction = X, Restitution = X }
+
+-- The RigidBody and the colliders use them with Material = "Name", instead of their own friction and restitution fields.
+-- The bodies with the same values share the same material, whether it's named or not
+
+HowManyMaterials = 3
+
+material_0 = { Name = "Ice", StaticFriction = 0.05, DynamicFriction = 0.02, Restitution = 0.1 }
+material_1 = { Name = "Rubber", StaticFriction = 0.9, DynamicFriction = 0.8, Restitution = 0.8 }
+material_2 = { Name = "Wood", StaticFriction = 0.5, DynamicFriction = 0.4, Restitution = 0.3 }
@@ -0,0 +1,16 @@
+-- How to define prefabs, they are loaded with Engine::loadPrefabs("prefabs.lua")
+-- HowManyPrefabs must contain one more number than the last prefab_X declared, like HowManyGameObjects in the scenes
+-- Each prefab_X has the same structure as a go_X of a scene:
+--  prefab_Number[0] = { Name = "", HowManyCmps = X, Persist = false} -> Name is the name of the prefab, its instances are called Name_N
+--  prefab_Number[1] = { Component = " ", General Data}               -> components, as in the scenes
+
+-- The file is only read once, every instance is created from the tables kept by the prefab
+
+HowManyPrefabs = 1
+
+prefab_0 = {}
+prefab_0[0] = { Name = "Bala", HowManyCmps = 3, Persist = false}
+prefab_0[1] = { Component = "Transform", Coord = {X = 0, Y = 0, Z = 0}, Rotation={X=0, Y=0, Z=0}, Scale = {X=0.2, Y=0.2, Z=0.2}}
+prefab_0[2] = {	Component = "RenderObject", MeshName="cube.mesh", Material="Practica1/Yellow",
+ 			Visible=true, Shadows=true, RenderingDistance = 1000}
+prefab_0[3] = { Component = "RigidBody", Static = false, Type = "Box",  Kinematic = false, Mass = 1}
@@ -19,7 +19,7 @@ go_3[0] = { Name = "Suelo", HowManyCmps = 3, Persist = false}
 go_3[1] = { Component = "Transform", Coord = {X = 0, Y = -1, Z = 0}, Rotation={X=0, Y=0, Z=0}, Scale = { X=10, Y=0.1, Z=10}}
 go_3[2] = {	Component = "RenderObject", MeshName="cube.mesh", Material="Practica1/Yellow",
   			Visible=true, Shadows=true, RenderingDistance = 1000}
-go_3[3] = { Component = "BoxCollider"}
+go_3[3] = { Component = "BoxCollider", Static = true}
 
 go_0 = {}
 go_0[0] = { Name = "Objeto", HowManyCmps = 3, Persist = false}